@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../common.h"
+
+#include "brex.h"
+#include "brex_compiler.h"
+#include "brex_executor.h"
+
+namespace brex
+{
+    //One top-level component of a regex as a DFA over bytes -- the reverse DFA for back checks
+    class CodegenCheck
+    {
+    public:
+        const DFAMachine* dfa;
+        bool isNegative;
+        bool isFrontCheck;
+        bool isBackCheck;
+    };
+
+    //Generate standalone C++ (no dependency on BREX) for the test operation of compiled regexes -- one function per regex over the bytes of the string
+    //Every check of a regex must have a full DFA, small DFAs are emitted as labeled states with inline byte comparisons and larger ones as constexpr tables
+    class RegexCodeGenerator
+    {
+    private:
+        //the runs of bytes [lo, hi] from a state to each target state
+        static std::map<DFAStateID, std::vector<std::pair<uint32_t, uint32_t>>> computeByteRuns(const DFAMachine* dfa, DFAStateID dstate);
+
+        static std::string emitByte(uint32_t b);
+        static std::string emitRunTest(const std::vector<std::pair<uint32_t, uint32_t>>& runs);
+
+        static std::string emitSwitchCheck(const std::string& fname, const CodegenCheck& check);
+        static std::string emitTableCheck(const std::string& fname, const CodegenCheck& check);
+
+        template <typename TStr, typename TIter, bool isunicode>
+        static std::optional<std::vector<CodegenCheck>> extractChecks(const REExecutor<TStr, TIter, isunicode>* executor, std::string& error)
+        {
+            if(executor->optPre != nullptr || executor->optPost != nullptr) {
+                error = "pre/post anchors are not supported";
+                return std::nullopt;
+            }
+
+            std::vector<const SingleCheckREInfo<TStr, TIter>*> singles;
+            if(auto single = dynamic_cast<const SingleCheckREInfo<TStr, TIter>*>(executor->re)) {
+                singles.push_back(single);
+            }
+            else {
+                auto multi = static_cast<const MultiCheckREInfo<TStr, TIter>*>(executor->re);
+                std::copy(multi->checks.cbegin(), multi->checks.cend(), std::back_inserter(singles));
+            }
+
+            std::vector<CodegenCheck> checks;
+            for(auto iter = singles.cbegin(); iter != singles.cend(); ++iter) {
+                const SingleCheckREInfo<TStr, TIter>* chk = *iter;
+                const DFAMachine* dfa = chk->isBackCheck ? chk->executor.getReverseDFA() : chk->executor.getForwardDFA();
+                if(dfa == nullptr) {
+                    error = "no full DFA (the regex has large range repeats or too many states)";
+                    return std::nullopt;
+                }
+
+                checks.push_back(CodegenCheck{ dfa, chk->isNegative, chk->isFrontCheck, chk->isBackCheck });
+            }
+
+            return std::make_optional(checks);
+        }
+
+    public:
+        static constexpr size_t MAX_SWITCH_STATES = 32;
+
+        const std::string nspace;
+
+        //the code for each matcher and its entry in the matchers table
+        std::vector<std::string> matchers;
+        std::vector<std::string> tableentries;
+
+        RegexCodeGenerator(const std::string& nspace) : nspace(nspace), matchers(), tableentries() {;}
+        ~RegexCodeGenerator() = default;
+
+        //the compiler options for code generation -- the DFAs are built ahead of time so they can be much larger than the runtime defaults
+        static RegexCompilerOptions codegenOptions();
+
+        //"Main::Foo" becomes Main_Foo
+        static std::string toIdentifier(const std::string& name);
+        static std::string toStringLiteral(const std::u8string& str);
+
+        void addMatcher(const std::string& name, const std::u8string& restr, const std::vector<CodegenCheck>& checks);
+
+        //add the matcher for a compiled regex -- false (and the reason in error) if it cannot be generated
+        bool addRegex(const std::string& name, const std::u8string& restr, const CRegexExecutor* executor, std::string& error)
+        {
+            auto checks = RegexCodeGenerator::extractChecks(executor, error);
+            if(!checks.has_value()) {
+                return false;
+            }
+
+            this->addMatcher(name, restr, checks.value());
+            return true;
+        }
+
+        //unicode regexes must be compiled to run on their UTF-8 bytes
+        bool addRegex(const std::string& name, const std::u8string& restr, const UnicodeByteRegexExecutor* executor, std::string& error)
+        {
+            auto checks = RegexCodeGenerator::extractChecks(executor, error);
+            if(!checks.has_value()) {
+                return false;
+            }
+
+            this->addMatcher(name, restr, checks.value());
+            return true;
+        }
+
+        //the full source -- the matchers and a table of them (name, regex, and function)
+        std::string emit() const;
+    };
+}
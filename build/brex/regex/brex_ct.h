@@ -0,0 +1,1839 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//Compile time regexes -- brex::ct_regex<"/[0-9]{5}/c">::test(str) is parsed and compiled to a DFA by the C++ compiler
+//This header is standalone (it does not use the rest of BREX or need the library) so it can be used in latency critical code without any startup cost
+
+namespace brex
+{
+    namespace ct
+    {
+        typedef uint32_t CTChar;
+
+        inline constexpr CTChar CT_MAX_CHAR = UINT32_MAX;
+
+        inline constexpr size_t CT_MAX_NFA_STATES = 4096;
+        inline constexpr size_t CT_MAX_DFA_STATES = 1024;
+        inline constexpr size_t CT_MAX_MESSAGE = 160;
+
+        //a string literal as a template argument -- "..." or u8"..."
+        template <typename TChar, size_t N>
+        class CTString
+        {
+        public:
+            TChar chars[N];
+
+            constexpr CTString(const TChar (&str)[N]) : chars()
+            {
+                std::copy_n(str, N, this->chars);
+            }
+
+            constexpr size_t size() const
+            {
+                return N - 1;
+            }
+        };
+
+        //the (first) error from parsing or compiling a regex -- a structural value so it shows up in the template arguments of a compile error
+        class CTDiagnostic
+        {
+        public:
+            //the default initializer (not a mem-initializer) on msg is what gets gcc to print it as a string
+            size_t line = 0;
+            char msg[CT_MAX_MESSAGE] = {};
+
+            constexpr CTDiagnostic() {;}
+            constexpr CTDiagnostic(size_t line, std::string_view str) : line(line)
+            {
+                std::copy_n(str.cbegin(), std::min(str.size(), CT_MAX_MESSAGE - 1), this->msg);
+            }
+
+            constexpr std::string_view message() const
+            {
+                return std::string_view(this->msg);
+            }
+        };
+
+        //these are the C locale versions of the std:: char tests (which are not constexpr)
+        constexpr bool ctIsPrint(uint8_t c) { return 32 <= c && c <= 126; }
+        constexpr bool ctIsBlank(uint8_t c) { return c == ' ' || c == '\t'; }
+        constexpr bool ctIsSpace(uint8_t c) { return c == ' ' || ('\t' <= c && c <= '\r'); }
+        constexpr bool ctIsDigit(uint8_t c) { return '0' <= c && c <= '9'; }
+        constexpr bool ctIsAlnum(uint8_t c) { return ctIsDigit(c) || ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z'); }
+        constexpr bool ctIsXDigit(uint8_t c) { return ctIsDigit(c) || ('a' <= c && c <= 'f') || ('A' <= c && c <= 'F'); }
+
+        constexpr bool ctIsLegalCChar(CTChar c)
+        {
+            return c <= 126 && (ctIsPrint((uint8_t)c) || c == '\t' || c == '\n');
+        }
+
+        constexpr size_t ctUTF8ByteCount(uint8_t b)
+        {
+            constexpr size_t sizes[16] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 3, 4};
+            return sizes[b >> 4];
+        }
+
+        //the same escape names as the runtime parser (common.cpp)
+        inline constexpr std::pair<uint8_t, std::string_view> ct_escape_names_unicode[] = {
+            {0, "%NUL;"}, {1, "%SOH;"}, {2, "%STX;"}, {3, "%ETX;"}, {4, "%EOT;"}, {5, "%ENQ;"}, {6, "%ACK;"}, {7, "%a;"},
+            {8, "%b;"}, {9, "%t;"}, {10, "%n;"}, {11, "%v;"}, {12, "%f;"}, {13, "%r;"}, {14, "%SO;"}, {15, "%SI;"},
+            {16, "%DLE;"}, {17, "%DC1;"}, {18, "%DC2;"}, {19, "%DC3;"}, {20, "%DC4;"}, {21, "%NAK;"}, {22, "%SYN;"}, {23, "%ETB;"},
+            {24, "%CAN;"}, {25, "%EM;"}, {26, "%SUB;"}, {27, "%e;"}, {28, "%FS;"}, {29, "%GS;"}, {30, "%RS;"}, {31, "%US;"},
+            {127, "%DEL;"},
+
+            {32, "%space;"}, {33, "%bang;"}, {34, "%;"}, {34, "%quote;"}, {35, "%hash;"}, {36, "%dollar;"}, {37, "%%;"}, {37, "%percent;"},
+            {38, "%amp;"}, {39, "%tick;"}, {40, "%lparen;"}, {41, "%rparen;"}, {42, "%star;"}, {43, "%plus;"}, {44, "%comma;"}, {45, "%dash;"},
+            {46, "%dot;"}, {47, "%slash;"}, {58, "%colon;"}, {59, "%semicolon;"}, {60, "%langle;"}, {61, "%equal;"}, {62, "%rangle;"}, {63, "%question;"},
+            {64, "%at;"}, {91, "%lbracket;"}, {92, "%backslash;"}, {93, "%rbracket;"}, {94, "%caret;"}, {95, "%underscore;"}, {96, "%backtick;"}, {123, "%lbrace;"},
+            {124, "%pipe;"}, {125, "%rbrace;"}, {126, "%tilde;"}
+        };
+
+        inline constexpr std::pair<uint8_t, std::string_view> ct_escape_names_char[] = {
+            {9, "%t;"}, {10, "%n;"},
+
+            {32, "%space;"}, {33, "%bang;"}, {34, "%quote;"}, {35, "%hash;"}, {36, "%dollar;"}, {37, "%%;"}, {37, "%percent;"}, {38, "%amp;"},
+            {39, "%;"}, {39, "%tick;"}, {40, "%lparen;"}, {41, "%rparen;"}, {42, "%star;"}, {43, "%plus;"}, {44, "%comma;"}, {45, "%dash;"},
+            {46, "%dot;"}, {47, "%slash;"}, {58, "%colon;"}, {59, "%semi;"}, {60, "%langle;"}, {61, "%equal;"}, {62, "%rangle;"}, {63, "%question;"},
+            {64, "%at;"}, {91, "%lbracket;"}, {92, "%backslash;"}, {93, "%rbracket;"}, {94, "%caret;"}, {95, "%underscore;"}, {96, "%backtick;"}, {123, "%lbrace;"},
+            {124, "%pipe;"}, {125, "%rbrace;"}, {126, "%tilde;"}
+        };
+
+        struct CTRange
+        {
+            CTChar low;
+            CTChar high;
+        };
+
+        enum class CTOptTag
+        {
+            Literal,
+            CharRange,
+            Dot,
+            Named,
+            Env,
+            Star,
+            Plus,
+            Optional,
+            Range,
+            Sequence,
+            AnyOf
+        };
+
+        //a regex node -- children are indices into the parser opts
+        class CTOpt
+        {
+        public:
+            CTOptTag tag;
+            std::vector<CTChar> codes;
+            bool compliment;
+            std::vector<CTRange> ranges;
+            uint16_t low;
+            uint16_t high;
+            std::vector<size_t> children;
+
+            constexpr CTOpt(CTOptTag tag) : tag(tag), codes(), compliment(false), ranges(), low(0), high(0), children() {;}
+        };
+
+        class CTToplevelEntry
+        {
+        public:
+            bool isNegated;
+            bool isFrontCheck;
+            bool isBackCheck;
+            size_t opt;
+        };
+
+        //the result of parsing a regex -- the top-level checks of the regex (or the first error)
+        class CTRegex
+        {
+        public:
+            bool ok;
+            CTDiagnostic diagnostic;
+            bool isUnicode;
+
+            std::vector<CTOpt> opts;
+            std::vector<CTToplevelEntry> checks;
+
+            constexpr CTRegex(bool isUnicode) : ok(false), diagnostic(), isUnicode(isUnicode), opts(), checks() {;}
+            constexpr CTRegex(bool isUnicode, const CTDiagnostic& diagnostic) : ok(false), diagnostic(diagnostic), isUnicode(isUnicode), opts(), checks() {;}
+        };
+
+        //A constexpr port of RegexParser (brex_parser.h) -- same grammar and error messages but only the first error is kept (and parsing stops there)
+        //Keep in sync with the runtime parser
+        class CTRegexParser
+        {
+        public:
+            const std::string& data;
+            size_t cpos;
+            const size_t epos;
+
+            const bool isUnicode;
+
+            size_t cline;
+            bool failed;
+            CTDiagnostic diagnostic;
+
+            //named regexes parse fine but cannot be compiled here
+            bool unsupported;
+            CTDiagnostic unsupportedDiagnostic;
+
+            std::vector<CTOpt> opts;
+
+            constexpr CTRegexParser(const std::string& data, size_t spos, size_t epos, bool isUnicode) : data(data), cpos(spos), epos(epos), isUnicode(isUnicode), cline(0), failed(false), diagnostic(), unsupported(false), unsupportedDiagnostic(), opts() {;}
+
+            constexpr void error(std::string_view msg)
+            {
+                this->errorAt(this->cline, msg);
+            }
+
+            constexpr void errorAt(size_t line, std::string_view msg)
+            {
+                if(!this->failed) {
+                    this->failed = true;
+                    this->diagnostic = CTDiagnostic(line, msg);
+                }
+            }
+
+            constexpr void error(std::string_view msg, std::string_view msg2, std::string_view msg3 = "", std::string_view msg4 = "")
+            {
+                char buff[CT_MAX_MESSAGE] = {};
+                size_t pos = 0;
+                for(auto str : { msg, msg2, msg3, msg4 }) {
+                    for(size_t i = 0; i < str.size() && pos < CT_MAX_MESSAGE - 1; ++i) {
+                        buff[pos++] = str[i];
+                    }
+                }
+
+                this->error(std::string_view(buff, pos));
+            }
+
+            constexpr size_t addOpt(CTOpt&& opt)
+            {
+                this->opts.push_back(std::move(opt));
+                return this->opts.size() - 1;
+            }
+
+            constexpr size_t addLiteral(std::vector<CTChar> codes)
+            {
+                CTOpt opt(CTOptTag::Literal);
+                opt.codes = codes;
+                return this->addOpt(std::move(opt));
+            }
+
+            constexpr size_t addUnary(CTOptTag tag, size_t child)
+            {
+                CTOpt opt(tag);
+                opt.children.push_back(child);
+                return this->addOpt(std::move(opt));
+            }
+
+            constexpr bool isEOS() const
+            {
+                return this->cpos == this->epos;
+            }
+
+            constexpr bool isToken(uint8_t tk) const
+            {
+                return !this->isEOS() && this->byte(this->cpos) == tk;
+            }
+
+            constexpr bool isTokenWS() const
+            {
+                return this->cpos < this->epos && ctIsSpace(this->byte(this->cpos));
+            }
+
+            constexpr bool isTokenPair(uint8_t tk1, uint8_t tk2) const
+            {
+                return (this->cpos + 1 < this->epos) && (this->byte(this->cpos) == tk1 && this->byte(this->cpos + 1) == tk2);
+            }
+
+            constexpr bool isNamedPfx() const
+            {
+                return (this->cpos + 2 < this->epos) && (this->byte(this->cpos) == '$' && this->byte(this->cpos + 1) == '{');
+            }
+
+            constexpr bool isTokenEnvPfx() const
+            {
+                return (this->cpos + 3 < this->epos) && (this->byte(this->cpos) == 'e' && this->byte(this->cpos + 1) == 'n' && this->byte(this->cpos + 2) == 'v' && this->byte(this->cpos + 3) == '[');
+            }
+
+            constexpr uint8_t token() const
+            {
+                return this->byte(this->cpos);
+            }
+
+            constexpr uint8_t byte(size_t pos) const
+            {
+                return (uint8_t)this->data[pos];
+            }
+
+            constexpr std::string_view sliceChars(size_t s, size_t e) const
+            {
+                return std::string_view(this->data).substr(s, e - s);
+            }
+
+            constexpr size_t findToken(size_t s, uint8_t tk) const
+            {
+                while(s != this->epos && this->byte(s) != tk) {
+                    s++;
+                }
+
+                return s;
+            }
+
+            constexpr void advanceTriviaOnly()
+            {
+                while(this->isTokenWS() || this->isTokenPair('%', '%') || this->isTokenPair('%', '*')) {
+                    if(this->isTokenPair('%', '*')) {
+                        this->cpos += 2;
+                        while(!this->isEOS() && !this->isTokenPair('*', '%')) {
+                            if(this->isToken('\n')) {
+                                this->cline++;
+                            }
+                            this->cpos++;
+                        }
+
+                        if(this->isTokenPair('*', '%')) {
+                            this->cpos += 2;
+                        }
+                    }
+                    else {
+                        if(this->isToken('\n')) {
+                            this->cline++;
+                        }
+                        if(this->isTokenWS()) {
+                            this->cpos++;
+                        }
+                        else {
+                            while(!this->isEOS() && !this->isToken('\n')) {
+                                this->cpos++;
+                            }
+                        }
+                    }
+                }
+            }
+
+            constexpr void advance()
+            {
+                if(!this->isEOS()) {
+                    if(this->isToken('\n')) {
+                        this->cline++;
+                    }
+
+                    this->cpos++;
+                }
+
+                this->advanceTriviaOnly();
+            }
+
+            constexpr void scanToSyncToken(uint8_t tk, bool andeat)
+            {
+                while(!this->isEOS() && !this->isToken(tk)) {
+                    if(this->isToken('\n')) {
+                        this->cline++;
+                    }
+
+                    this->cpos++;
+                }
+
+                //eat the sync token
+                if(!this->isEOS() && andeat) {
+                    this->cpos++;
+                }
+            }
+
+            constexpr void scanToSyncTokenAtomic()
+            {
+                bool exit = false;
+                bool andeat = false;
+                while(!this->isEOS() && !exit) {
+                    switch(this->byte(this->cpos)) {
+                        case '(':
+                        case '[':
+                        case '{':
+                        case '|':
+                        case '&':
+                        case '*':
+                        case '+':
+                        case '?':
+                        case '.': {
+                            exit = true;
+                            break;
+                        }
+                        case '\'':
+                        case '"':
+                        case ')':
+                        case ']':
+                        case '}': {
+                            andeat = true;
+                            exit = true;
+                            break;
+                        }
+                        default: {
+                            break;
+                        }
+                    }
+
+                    this->cpos++;
+                }
+
+                //eat the sync token
+                if(!this->isEOS() && andeat) {
+                    this->cpos++;
+                }
+            }
+
+            //the escape helpers from common.cpp over [s, e) of the data
+            constexpr bool isHexEscapePrefix(size_t s, size_t e) const
+            {
+                return e > s + 3 && this->byte(s) == '%' && this->byte(s + 1) == 'x' && ctIsXDigit(this->byte(s + 2));
+            }
+
+            constexpr bool allHexDigits(size_t s, size_t e) const
+            {
+                return std::all_of(this->data.cbegin() + s, this->data.cbegin() + e, [](uint8_t c) { return ctIsXDigit(c); });
+            }
+
+            constexpr uint64_t hexValue(size_t s, size_t e) const
+            {
+                uint64_t cval = 0;
+                for(size_t i = s; i < e && ctIsXDigit(this->byte(i)) && cval <= UINT32_MAX; ++i) {
+                    const uint8_t c = this->byte(i);
+                    cval = (cval * 16) + (ctIsDigit(c) ? (c - '0') : ((c | 0x20) - 'a' + 10));
+                }
+
+                return cval;
+            }
+
+            constexpr std::optional<CTChar> decodeHexEscapeAsRegex(size_t s, size_t e, bool ischar) const
+            {
+                const size_t ccount = e - s;
+                if(ccount < 4 || (ischar ? 5 : 9) < ccount) {
+                    return std::nullopt;
+                }
+
+                if(this->byte(s + 1) != 'x' || !this->allHexDigits(s + 2, e - 1)) {
+                    return std::nullopt;
+                }
+
+                const uint64_t cval = this->hexValue(s + 2, e);
+                if(ischar ? !ctIsLegalCChar((CTChar)cval) : cval > 0x10FFFF) {
+                    return std::nullopt;
+                }
+
+                return std::make_optional((CTChar)cval);
+            }
+
+            constexpr std::optional<CTChar> resolveEscapeName(size_t s, size_t e, bool ischar) const
+            {
+                const std::string_view name(this->sliceChars(s, e));
+                if(ischar) {
+                    auto ii = std::find_if(std::cbegin(ct_escape_names_char), std::cend(ct_escape_names_char), [name](const std::pair<uint8_t, std::string_view>& p) { return p.second == name; });
+                    return ii != std::cend(ct_escape_names_char) ? std::make_optional((CTChar)ii->first) : std::nullopt;
+                }
+                else {
+                    auto ii = std::find_if(std::cbegin(ct_escape_names_unicode), std::cend(ct_escape_names_unicode), [name](const std::pair<uint8_t, std::string_view>& p) { return p.second == name; });
+                    return ii != std::cend(ct_escape_names_unicode) ? std::make_optional((CTChar)ii->first) : std::nullopt;
+                }
+            }
+
+            constexpr std::optional<CTChar> unescapeSingleRegexChar(size_t s, size_t e, bool ischar) const
+            {
+                if(this->isHexEscapePrefix(s, e)) {
+                    return this->decodeHexEscapeAsRegex(s, e, ischar);
+                }
+                else {
+                    return this->resolveEscapeName(s, e, ischar);
+                }
+            }
+
+            constexpr CTChar toRegexCharCodeFromBytes(size_t s, size_t length) const
+            {
+                const size_t bytecount = ctUTF8ByteCount(this->byte(s));
+                if(length < bytecount) {
+                    return 0;
+                }
+
+                const uint32_t b0 = this->byte(s);
+                if(bytecount == 1) {
+                    return b0;
+                }
+                else if(bytecount == 2) {
+                    return ((b0 & 0x1F) << 6) | (this->byte(s + 1) & 0x3F);
+                }
+                else if(bytecount == 3) {
+                    return ((b0 & 0x0F) << 12) | ((this->byte(s + 1) & 0x3F) << 6) | (this->byte(s + 2) & 0x3F);
+                }
+                else {
+                    return ((b0 & 0x07) << 18) | ((this->byte(s + 1) & 0x3F) << 12) | ((this->byte(s + 2) & 0x3F) << 6) | (this->byte(s + 3) & 0x3F);
+                }
+            }
+
+            //report a bad char with its escape name (if it has one) and hex escape code
+            constexpr void errorNonPrintable(std::string_view msg, uint8_t c, bool ischar)
+            {
+                char code[8] = { '%', 'x' };
+                size_t clen = 2;
+                if(c >= 16) {
+                    code[clen++] = "0123456789abcdef"[c >> 4];
+                }
+                code[clen++] = "0123456789abcdef"[c & 0xF];
+                code[clen++] = ';';
+
+                std::string_view esccname(code, clen);
+                if(ischar) {
+                    auto ii = std::find_if(std::cbegin(ct_escape_names_char), std::cend(ct_escape_names_char), [c](const std::pair<uint8_t, std::string_view>& p) { return p.first == c; });
+                    if(ii != std::cend(ct_escape_names_char)) {
+                        esccname = ii->second;
+                    }
+                }
+                else {
+                    auto ii = std::find_if(std::cbegin(ct_escape_names_unicode), std::cend(ct_escape_names_unicode), [c](const std::pair<uint8_t, std::string_view>& p) { return p.first == c; });
+                    if(ii != std::cend(ct_escape_names_unicode)) {
+                        esccname = ii->second;
+                    }
+                }
+
+                this->error(msg, esccname, " or ", std::string_view(code, clen));
+            }
+
+            //the first error of parserValidateEscapeSequences
+            constexpr void errorEscapeSequences(bool ischar, size_t s, size_t e)
+            {
+                for(size_t curr = s; curr < e; curr++) {
+                    if(this->byte(curr) == '%') {
+                        const size_t sc = std::min(this->findToken(curr, ';'), e);
+                        if(sc == e) {
+                            this->error("Escape sequence is missing terminal ';'");
+                            return;
+                        }
+
+                        if(this->isHexEscapePrefix(curr, sc + 1)) {
+                            if(!this->allHexDigits(curr + 2, sc)) {
+                                this->error("Hex escape sequence contains non-hex characters");
+                                return;
+                            }
+
+                            const uint64_t cval = this->hexValue(curr + 2, sc);
+                            const size_t ccount = (sc + 1) - curr;
+                            const bool ok = ischar ? (ccount <= 5 && ctIsLegalCChar((CTChar)cval)) : (ccount <= 9 && cval <= 0x10FFFF);
+                            if(!ok) {
+                                this->error("Invalid hex escape sequence");
+                                return;
+                            }
+                        }
+                        else {
+                            if(!this->resolveEscapeName(curr, sc + 1, ischar).has_value()) {
+                                this->error("Invalid escape sequence -- unknown escape name '", this->sliceChars(curr + 1, sc), "'");
+                                return;
+                            }
+                        }
+
+                        curr = sc;
+                    }
+                }
+            }
+
+            constexpr bool validateUTF8SingleChar(size_t s)
+            {
+                const uint8_t b = this->byte(s);
+                if((b & 0x80) == 0) {
+                    if(b == '%') {
+                        const size_t sc = this->findToken(s, ';');
+                        if(sc == this->epos) {
+                            this->error("Escape sequence is missing terminal ';'");
+                            return false;
+                        }
+
+                        if(this->isHexEscapePrefix(s, sc + 1) && !this->allHexDigits(s + 2, sc)) {
+                            this->error("Hex escape sequence contains non-hex characters -- ", this->sliceChars(s + 1, sc));
+                            return false;
+                        }
+                    }
+
+                    return true;
+                }
+
+                return this->validateUTF8Char(s, this->epos, true);
+            }
+
+            constexpr bool validateUTF8Char(size_t s, size_t e, bool single)
+            {
+                const uint8_t b = this->byte(s);
+                const size_t bytecount = ctUTF8ByteCount(b);
+                if(s + bytecount > e) {
+                    this->error("Invalid UTF8 encoding -- string contains a truncated character at the end");
+                    return false;
+                }
+
+                auto iscont = [this, s](size_t i) { return (this->byte(s + i) & 0xC0) == 0x80; };
+                if(bytecount == 2) {
+                    if((b & 0xC0) != 0xC0 || !iscont(1)) {
+                        this->error("Invalid UTF8 encoding -- string contains a mis-encoded 2 byte character");
+                        return false;
+                    }
+                }
+                else if(bytecount == 3) {
+                    if((b & 0xE0) != 0xE0 || !iscont(1) || !iscont(2)) {
+                        this->error("Invalid UTF8 encoding -- string contains a mis-encoded 3 byte character");
+                        return false;
+                    }
+                }
+                else if(bytecount == 4) {
+                    if((b & 0xF0) != 0xF0 || !iscont(1) || !iscont(2) || !iscont(3)) {
+                        this->error("Invalid UTF8 encoding -- string contains a mis-encoded 4 byte character");
+                        return false;
+                    }
+                }
+                else if(single) {
+                    this->error("Invalid UTF8 encoding -- utf8 is at most 4 bytes per character");
+                    return false;
+                }
+
+                return true;
+            }
+
+            constexpr bool validateCSingleChar(size_t s)
+            {
+                const uint8_t b = this->byte(s);
+                if((b & 0x80) != 0) {
+                    this->error("Invalid char encoding -- string contains a non-char character");
+                    return false;
+                }
+
+                if(b == '%') {
+                    const size_t sc = this->findToken(s, ';');
+                    if(sc == this->epos) {
+                        this->error("Escape sequence is missing terminal ';'");
+                        return false;
+                    }
+
+                    if(this->isHexEscapePrefix(s, sc + 1)) {
+                        if(!this->allHexDigits(s + 2, sc)) {
+                            this->error("Hex escape sequence contains non-hex characters -- ", this->sliceChars(s + 1, sc));
+                            return false;
+                        }
+
+                        auto esc = this->decodeHexEscapeAsRegex(s, sc + 1, true);
+                        if(!esc.has_value() || esc.value() > 127) {
+                            this->error("Hex escape sequence is not a valid char character -- ", this->sliceChars(s + 1, sc));
+                            return false;
+                        }
+                    }
+                }
+
+                return true;
+            }
+
+            //the whole literal body (parserValidateUTF8ByteEncoding)
+            constexpr bool validateUTF8Bytes(size_t s, size_t e)
+            {
+                if((this->byte(s) & 0x80) != 0 && (this->byte(s) & 0x40) == 0) {
+                    this->error("Invalid UTF8 encoding -- string contains a truncated character at the beginning");
+                    return false;
+                }
+
+                while(s != e) {
+                    if((this->byte(s) & 0x80) == 0) {
+                        s++;
+                    }
+                    else {
+                        const size_t bytecount = ctUTF8ByteCount(this->byte(s));
+                        if(s + bytecount > e) {
+                            this->error("Invalid UTF8 encoding -- string contains a truncated character at the end");
+                            return false;
+                        }
+
+                        if(bytecount == 1) {
+                            this->error("Invalid UTF8 encoding -- utf8 is at most 4 bytes per character");
+                            return false;
+                        }
+
+                        if(!this->validateUTF8Char(s, e, false)) {
+                            return false;
+                        }
+
+                        s += bytecount;
+                    }
+                }
+
+                return true;
+            }
+
+            constexpr std::optional<std::vector<CTChar>> unescapeRegexLiteral(size_t s, size_t length, bool ischar) const
+            {
+                std::vector<CTChar> acc;
+                for(size_t i = s; i < s + length; ++i) {
+                    const uint8_t c = this->byte(i);
+                    if((ischar || c <= 127) && !ctIsPrint(c) && !ctIsBlank(c)) {
+                        return std::nullopt;
+                    }
+
+                    if(c == '%') {
+                        const size_t sc = std::min(this->findToken(i, ';'), s + length);
+                        if(sc == s + length) {
+                            return std::nullopt;
+                        }
+
+                        auto esc = this->unescapeSingleRegexChar(i, sc + 1, ischar);
+                        if(!esc.has_value()) {
+                            return std::nullopt;
+                        }
+
+                        acc.push_back(esc.value());
+                        i = sc;
+                    }
+                    else if(ischar) {
+                        acc.push_back(c);
+                    }
+                    else {
+                        acc.push_back(this->toRegexCharCodeFromBytes(i, (s + length) - i));
+                        i += ctUTF8ByteCount(c) - 1;
+                    }
+                }
+
+                return std::make_optional(acc);
+            }
+
+            constexpr CTChar parseRegexChar(bool unicodeok)
+            {
+                const uint8_t c = this->token();
+                if(c <= 127 && !ctIsPrint(c) && !ctIsBlank(c)) {
+                    this->errorNonPrintable("Newlines and non-printable chars are not allowed in regexes -- escape them with ", c, false);
+                    this->cpos++;
+                    return 0;
+                }
+
+                const bool encok = unicodeok ? this->validateUTF8SingleChar(this->cpos) : this->validateCSingleChar(this->cpos);
+                if(!encok) {
+                    this->scanToSyncToken(']', false);
+                    return 0;
+                }
+
+                CTChar code = 0;
+                if(this->isToken('%')) {
+                    const size_t tpos = this->findToken(this->cpos + 1, ';');
+
+                    auto ccode = this->unescapeSingleRegexChar(this->cpos, tpos + 1, !unicodeok);
+                    if(ccode.has_value()) {
+                        code = ccode.value();
+                    }
+                    else {
+                        this->errorEscapeSequences(!unicodeok, this->cpos, tpos + 1);
+                    }
+
+                    this->cpos = tpos + 1;
+                }
+                else {
+                    const size_t bytecount = ctUTF8ByteCount(this->token());
+
+                    code = this->toRegexCharCodeFromBytes(this->cpos, bytecount);
+                    this->cpos += bytecount;
+                }
+
+                return code;
+            }
+
+            constexpr size_t parseLiteral(bool ischar)
+            {
+                const uint8_t delim = ischar ? '\'' : '"';
+
+                //read to closing delimiter -- check for raw newlines in the expression
+                size_t length = 0;
+                size_t curr = this->cpos + 1;
+                while(curr != this->epos && this->byte(curr) != delim) {
+                    if(this->byte(curr) <= 127 && !ctIsPrint(this->byte(curr)) && !ctIsBlank(this->byte(curr))) {
+                        this->errorNonPrintable("Newlines and non-printable chars are not allowed regex literals -- escape them with ", this->byte(curr), ischar);
+                        return this->addLiteral({});
+                    }
+
+                    length++;
+                    curr++;
+                }
+
+                if(curr == this->epos) {
+                    this->error("Unterminated regex literal");
+                    this->cpos = this->epos;
+
+                    return this->addLiteral({});
+                }
+
+                if(length == 0) {
+                    this->cpos = curr + 1;
+                    return this->addLiteral({});
+                }
+
+                bool encok = true;
+                if(ischar) {
+                    encok = std::none_of(this->data.cbegin() + this->cpos + 1, this->data.cbegin() + curr, [](uint8_t c) { return (c & 0x80) != 0; });
+                    if(!encok) {
+                        this->error("Invalid Char encoding -- string contains a non-char character");
+                    }
+                }
+                else {
+                    encok = this->validateUTF8Bytes(this->cpos + 1, curr);
+                }
+
+                if(!encok) {
+                    this->cpos = curr + 1;
+                    return this->addLiteral({});
+                }
+
+                auto codes = this->unescapeRegexLiteral(this->cpos + 1, length, ischar);
+                if(!codes.has_value()) {
+                    this->errorEscapeSequences(ischar, this->cpos + 1, curr);
+                    this->cpos = curr + 1;
+
+                    return this->addLiteral({});
+                }
+
+                this->cpos = curr + 1;
+                return this->addLiteral(codes.value());
+            }
+
+            constexpr size_t parseCharRange(bool unicodeok)
+            {
+                //eat the "["
+                this->cpos++;
+
+                CTOpt opt(CTOptTag::CharRange);
+                opt.compliment = this->isToken('^');
+                if(opt.compliment) {
+                    this->cpos++;
+                }
+
+                if(this->isToken('-')) {
+                    //then it is a literal hyphen in ths special start of list position
+                    this->cpos++;
+                    opt.ranges.push_back({ (CTChar)'-', (CTChar)'-' });
+                }
+
+                while(!this->isEOS() && !this->isToken(']') && !this->failed) {
+                    const CTChar lb = this->parseRegexChar(unicodeok);
+
+                    if(!this->isToken('-')) {
+                        opt.ranges.push_back({ lb, lb });
+                    }
+                    else {
+                        this->cpos++;
+                        if(this->isToken(']')) {
+                            //then it is a literal hyphen in the special end of list position
+                            opt.ranges.push_back({ lb, lb });
+                            opt.ranges.push_back({ (CTChar)'-', (CTChar)'-' });
+                        }
+                        else if(this->isToken('-')) {
+                            //then it is a literal hyphen in a special end position but as part of a range
+                            this->cpos++;
+                            opt.ranges.push_back({ std::min(lb, (CTChar)'-'), std::max(lb, (CTChar)'-') });
+                        }
+                        else {
+                            const CTChar ub = this->parseRegexChar(unicodeok);
+                            opt.ranges.push_back({ std::min(lb, ub), std::max(lb, ub) });
+                        }
+                    }
+                }
+
+                if(this->isToken(']')) {
+                    this->cpos++;
+                }
+                else {
+                    this->error("Missing ] in char range regex");
+                }
+
+                return this->addOpt(std::move(opt));
+            }
+
+            //^([A-Z][_a-zA-Z0-9]+::)*[_a-zA-Z0-9]+$
+            static constexpr bool isValidScopedName(std::string_view name)
+            {
+                auto isidchar = [](char c) { return c == '_' || ctIsAlnum((uint8_t)c); };
+
+                while(true) {
+                    const size_t sep = name.find("::");
+                    const std::string_view part = name.substr(0, sep);
+                    if(part.empty() || !std::all_of(part.cbegin(), part.cend(), isidchar)) {
+                        return false;
+                    }
+
+                    if(sep == std::string_view::npos) {
+                        return true;
+                    }
+
+                    if(part.size() < 2 || !('A' <= part[0] && part[0] <= 'Z')) {
+                        return false;
+                    }
+
+                    name = name.substr(sep + 2);
+                }
+            }
+
+            constexpr size_t parseNamedRegex()
+            {
+                this->advance();
+                this->advance();
+
+                const size_t nstart = this->cpos;
+                while(!this->isEOS() && !this->isToken('}')) {
+                    this->cpos++;
+                }
+                const std::string_view name = this->sliceChars(nstart, this->cpos);
+
+                if(this->isToken('}')) {
+                    this->cpos++;
+                }
+                else {
+                    this->error("Missing closing } in named regex");
+                }
+
+                if(!CTRegexParser::isValidScopedName(name)) {
+                    this->error("Invalid named regex name -- must be a valid scoped identifier");
+                }
+
+                if(!this->unsupported) {
+                    this->unsupported = true;
+                    this->unsupportedDiagnostic = CTDiagnostic(this->cline, "Named regexes are not supported in ct_regex -- use a ReSystem or brexc");
+                }
+
+                return this->addOpt(CTOpt(CTOptTag::Named));
+            }
+
+            constexpr size_t parseEnvRegex()
+            {
+                //env regexes are never allowed at compile time
+                this->error("Env regexes are not allowed in this context");
+
+                this->cpos += 4;
+                while(!this->isEOS() && !this->isToken(']')) {
+                    this->cpos++;
+                }
+
+                if(this->isToken(']')) {
+                    this->cpos++;
+                }
+                else {
+                    this->error("Missing closing ] in env regex");
+                }
+
+                return this->addOpt(CTOpt(CTOptTag::Env));
+            }
+
+            constexpr size_t parseBaseComponent()
+            {
+                //make sure we get any trivia out of the way
+                this->advanceTriviaOnly();
+
+                size_t res = 0;
+                if(this->isToken('(')) {
+                    this->advance();
+
+                    res = this->parsePositiveComponent();
+                    if(this->isToken(')')) {
+                        this->advance();
+                    }
+                    else {
+                        this->error("Missing ) in regex");
+                    }
+                }
+                else if(this->isToken('"')) {
+                    if(this->isUnicode) {
+                        res = this->parseLiteral(false);
+                    }
+                    else {
+                        this->error("Unicode literals are not allowed in char regexes");
+                        this->scanToSyncToken('"', true);
+                        res = this->addLiteral({});
+                    }
+                }
+                else if(this->isToken('\'')) {
+                    if(!this->isUnicode) {
+                        res = this->parseLiteral(true);
+                    }
+                    else {
+                        this->error("Char literals are not allowed in Unicode regexes");
+                        this->scanToSyncToken('\'', true);
+                        res = this->addLiteral({});
+                    }
+                }
+                else if(this->isToken('[')) {
+                    res = this->parseCharRange(this->isUnicode);
+                }
+                else if(this->isToken('.')) {
+                    this->cpos++;
+                    res = this->addOpt(CTOpt(CTOptTag::Dot));
+                }
+                else if(this->isNamedPfx()) {
+                    res = this->parseNamedRegex();
+                }
+                else if(this->isTokenEnvPfx()) {
+                    res = this->parseEnvRegex();
+                }
+                else {
+                    const std::string_view slice = this->sliceChars(this->cpos, std::min(this->cpos + ctUTF8ByteCount(this->token()), this->epos));
+                    this->error("Invalid regex component -- expected (, [, ', \", {, or . but found \"", slice, "\"");
+                    this->scanToSyncTokenAtomic();
+
+                    res = this->addLiteral({});
+                }
+
+                //make sure we get any trivia out of the way
+                this->advanceTriviaOnly();
+
+                return res;
+            }
+
+            constexpr bool parseRangeRepeatBound(uint16_t& vv)
+            {
+                if(this->isToken('-')) {
+                    this->error("Invalid range repeat bound -- cannot have negative bound");
+                    this->cpos++;
+                }
+
+                if(this->isEOS() || !ctIsDigit(this->token())) {
+                    return false;
+                }
+
+                const size_t dstart = this->cpos;
+                uint64_t sval = 0;
+                while(!this->isEOS() && ctIsDigit(this->token())) {
+                    sval = std::min((sval * 10) + (this->token() - '0'), (uint64_t)UINT32_MAX);
+                    this->cpos++;
+                }
+
+                if(this->cpos - dstart == 1 && this->byte(dstart) == '0') {
+                    vv = 0;
+                    return true;
+                }
+
+                if(this->byte(dstart) == '0') {
+                    this->error("Invalid range repeat bound -- invalid leading 0 on bound");
+                    return false;
+                }
+                else if(sval > UINT16_MAX) {
+                    this->error("Invalid range repeat bound -- number too large (max is 65535)");
+                    return false;
+                }
+                else {
+                    vv = (uint16_t)sval;
+                    return true;
+                }
+            }
+
+            constexpr size_t parseRangeRepeatOpt(size_t rcc, bool rng1ok)
+            {
+                this->advance();
+                uint16_t min = 0;
+                const bool hasmin = this->parseRangeRepeatBound(min);
+
+                this->advanceTriviaOnly();
+                if(hasmin && !this->isToken(',') && !this->isToken('}')) {
+                    this->error("Missing comma (possibly) in range repeat");
+                }
+
+                uint16_t max = min;
+                if(this->isToken(',')) {
+                    this->advance();
+                    max = UINT16_MAX;
+                    this->parseRangeRepeatBound(max);
+
+                    this->advanceTriviaOnly();
+                }
+
+                if(this->isToken('}')) {
+                    this->advance();
+                }
+                else {
+                    this->error("Missing } in range repeat");
+                }
+
+                if(min == 0 && max == 0) {
+                    this->error("Invalid range repeat bounds -- both min and max are 0 so the repeat is empty");
+                }
+
+                if(!rng1ok && min == 1 && max == 1) {
+                    this->error("Invalid range repeat bounds -- min and max are both 1 so the repeat is redundant");
+                }
+
+                if(max < min) {
+                    this->error("Invalid range repeat bounds -- max is less than min");
+                }
+
+                if(min == 0 && max == UINT16_MAX) {
+                    return this->addUnary(CTOptTag::Star, rcc);
+                }
+                else if(min == 1 && max == UINT16_MAX) {
+                    return this->addUnary(CTOptTag::Plus, rcc);
+                }
+                else if(min == 0 && max == 1) {
+                    return this->addUnary(CTOptTag::Optional, rcc);
+                }
+                else if(min == 1 && max == 1) {
+                    return rcc;
+                }
+                else {
+                    const size_t ropt = this->addUnary(CTOptTag::Range, rcc);
+                    this->opts[ropt].low = min;
+                    this->opts[ropt].high = max;
+                    return ropt;
+                }
+            }
+
+            constexpr size_t parseRepeatComponent()
+            {
+                size_t rcc = this->parseBaseComponent();
+
+                while(this->isToken('*') || this->isToken('+') || this->isToken('?') || this->isToken('{')) {
+                    if(this->isToken('*')) {
+                        rcc = this->addUnary(CTOptTag::Star, rcc);
+                        this->advance();
+                    }
+                    else if(this->isToken('+')) {
+                        rcc = this->addUnary(CTOptTag::Plus, rcc);
+                        this->advance();
+                    }
+                    else if(this->isToken('?')) {
+                        rcc = this->addUnary(CTOptTag::Optional, rcc);
+                        this->advance();
+                    }
+                    else {
+                        return this->parseRangeRepeatOpt(rcc, false);
+                    }
+                }
+
+                return rcc;
+            }
+
+            constexpr size_t parseSequenceComponent()
+            {
+                CTOpt sre(CTOptTag::Sequence);
+
+                while(!this->isEOS() && !this->failed && !this->isToken('&') && !this->isToken('|') && !this->isToken(')') && !this->isToken('>') && !this->isToken('^') && !(this->isToken('$') && !this->isNamedPfx())) {
+                    sre.children.push_back(this->parseRepeatComponent());
+                }
+
+                if(sre.children.empty()) {
+                    this->error("Empty regex sequence");
+                    return this->addLiteral({});
+                }
+
+                if(sre.children.size() == 1) {
+                    return sre.children[0];
+                }
+                else {
+                    return this->addOpt(std::move(sre));
+                }
+            }
+
+            constexpr size_t parseAnyOfComponent()
+            {
+                CTOpt are(CTOptTag::AnyOf);
+                are.children.push_back(this->parseSequenceComponent());
+
+                while(this->isToken('|') && !this->failed) {
+                    this->advance();
+                    are.children.push_back(this->parseSequenceComponent());
+                }
+
+                if(are.children.size() == 1) {
+                    return are.children[0];
+                }
+                else {
+                    return this->addOpt(std::move(are));
+                }
+            }
+
+            constexpr size_t parsePositiveComponent()
+            {
+                return this->parseAnyOfComponent();
+            }
+
+            constexpr CTToplevelEntry parseSingleToplevelRegexComponent()
+            {
+                this->advanceTriviaOnly();
+                bool isNegate = false;
+                bool isFrontCheck = false;
+                bool isBackCheck = false;
+
+                if(this->isToken('!')) {
+                    isNegate = true;
+                    this->advance();
+                }
+
+                if(this->isToken('^')) {
+                    this->advance();
+                    isFrontCheck = true;
+                }
+
+                if(this->isToken('!')) {
+                    this->error("Invalid regex -- negation is not allowed inside anchor");
+                }
+
+                size_t popt = 0;
+                if(!this->isToken('{')) {
+                    popt = this->parsePositiveComponent();
+                }
+                else {
+                    popt = this->parseRangeRepeatOpt(this->addOpt(CTOpt(CTOptTag::Dot)), true);
+                }
+
+                this->advanceTriviaOnly();
+                if(this->isToken('$')) {
+                    this->advance();
+                    isBackCheck = true;
+                }
+
+                if(isFrontCheck && isBackCheck) {
+                    this->error("Invalid regex -- front and back checks cannot be used together");
+                }
+
+                return CTToplevelEntry{ isNegate, isFrontCheck, isBackCheck, popt };
+            }
+
+            constexpr std::vector<CTToplevelEntry> parseRegexComponent()
+            {
+                std::vector<CTToplevelEntry> are;
+
+                are.push_back(this->parseSingleToplevelRegexComponent());
+                while(this->isToken('&') && !this->failed) {
+                    this->cpos++;
+                    if(this->isToken('&')) {
+                        this->error("Invalid regex -- && is not a valid regex operator (did you mean '&')");
+                        this->advance();
+                    }
+
+                    this->advanceTriviaOnly();
+                    are.push_back(this->parseSingleToplevelRegexComponent());
+                }
+
+                if(std::all_of(are.cbegin(), are.cend(), [](const CTToplevelEntry& e) { return e.isFrontCheck || e.isBackCheck; })) {
+                    this->error("Invalid regex -- all top-level components are front or back checks");
+                }
+
+                return are;
+            }
+
+            static constexpr CTRegex parseRegex(const std::string& data, bool isUnicode)
+            {
+                const size_t datalen = data.size();
+                if(datalen < 2) {
+                    return CTRegex(isUnicode, CTDiagnostic(0, "Empty string is not a valid regex -- must be of form /.../"));
+                }
+
+                if(data[0] != '/') {
+                    return CTRegex(isUnicode, CTDiagnostic(0, "Invalid regex -- must start with /"));
+                }
+
+                if(isUnicode) {
+                    if(data[datalen - 1] != '/') {
+                        return CTRegex(isUnicode, CTDiagnostic(0, "Invalid regex -- must end with /"));
+                    }
+                }
+                else {
+                    if((data[datalen - 1] != 'c' && data[datalen - 1] != 'p') || data[datalen - 2] != '/') {
+                        return CTRegex(isUnicode, CTDiagnostic(0, "Invalid CString or Path regex -- must end with /[cp]"));
+                    }
+                }
+
+                const size_t rlen = isUnicode ? datalen : datalen - 1;
+                auto parser = CTRegexParser(data, 1, std::max(rlen - 1, (size_t)1), isUnicode);
+
+                std::vector<std::vector<CTToplevelEntry>> rv;
+                bool preanchor = false;
+                bool postanchor = false;
+                bool preparen = false;
+                bool postparen = false;
+
+                parser.advanceTriviaOnly();
+                if(!parser.isToken('<')) {
+                    rv.push_back(parser.parseRegexComponent());
+                }
+
+                if(parser.isToken('^')) {
+                    preanchor = true;
+                    parser.advance();
+                }
+
+                if(parser.isToken('<')) {
+                    preparen = true;
+                    parser.advance();
+                }
+
+                if(!parser.isEOS()) {
+                    rv.push_back(parser.parseRegexComponent());
+                }
+
+                if(parser.isToken('>')) {
+                    postparen = true;
+                    parser.advance();
+                }
+
+                if(parser.isToken('$')) {
+                    postanchor = true;
+                    parser.advance();
+                }
+
+                if(!parser.isEOS()) {
+                    rv.push_back(parser.parseRegexComponent());
+                }
+
+                if(preparen != postparen) {
+                    parser.error("Invalid regex -- mismatched <...> parenthesized expression");
+                }
+
+                if((preanchor || postanchor) && (!preparen || !postparen)) {
+                    parser.error("Invalid regex -- anchor must be used with a <...> parenthesized expression");
+                }
+
+                if(preanchor && postanchor && rv.size() != 3) {
+                    parser.error("Invalid regex -- pre/post anchors must be used with exactly 3 components pre^<...>$post");
+                }
+                else if(preanchor && !postanchor && rv.size() != 2) {
+                    parser.error("Invalid regex -- pre anchor must be used with exactly 2 components pre^<...>");
+                }
+                else if(!preanchor && postanchor && rv.size() != 2) {
+                    parser.error("Invalid regex -- post anchor must be used with exactly 2 components <...>$post");
+                }
+
+                if(parser.cpos != parser.epos) {
+                    parser.error("Invalid regex -- trailing characters after end of regex");
+                }
+
+                if(parser.failed) {
+                    return CTRegex(isUnicode, parser.diagnostic);
+                }
+
+                //test only looks at the <...> part so pre/post anchors would be silently ignored
+                if(preanchor || postanchor) {
+                    return CTRegex(isUnicode, CTDiagnostic(parser.cline, "Pre/post anchored regexes are not supported in ct_regex"));
+                }
+
+                if(parser.unsupported) {
+                    return CTRegex(isUnicode, parser.unsupportedDiagnostic);
+                }
+
+                CTRegex res(isUnicode);
+                res.ok = true;
+                res.opts = std::move(parser.opts);
+                res.checks = std::move(rv[0]);
+
+                return res;
+            }
+        };
+
+        enum class CTNFATag
+        {
+            Chars,
+            Split,
+            Accept
+        };
+
+        class CTNFAState
+        {
+        public:
+            CTNFATag tag;
+            std::vector<CTRange> ranges;
+            std::vector<size_t> follows;
+
+            constexpr CTNFAState(CTNFATag tag, std::vector<CTRange> ranges, std::vector<size_t> follows) : tag(tag), ranges(ranges), follows(follows) {;}
+        };
+
+        class CTCheck
+        {
+        public:
+            uint32_t start;
+            bool isNegative;
+            bool isFrontCheck;
+            bool isBackCheck;
+        };
+
+        //Compile each top-level check to an NFA and then to a DFA -- the DFAs share one partition of the chars into classes and one state numbering
+        //Back checks are compiled as .* R so every check runs forward over the whole string (and front checks stop at the first accepting state)
+        class CTRegexCompiler
+        {
+        public:
+            bool ok;
+            CTDiagnostic diagnostic;
+            bool isUnicode;
+
+            std::vector<CTNFAState> states;
+            std::vector<CTChar> classlows;
+
+            std::vector<CTCheck> checks;
+            std::vector<uint32_t> next;
+            std::vector<bool> accepting;
+            std::vector<bool> dead;
+
+            constexpr CTRegexCompiler() : ok(false), diagnostic(), isUnicode(false), states(), classlows(), checks(), next(), accepting(), dead() {;}
+
+            constexpr void fail(std::string_view msg)
+            {
+                if(this->ok) {
+                    this->ok = false;
+                    this->diagnostic = CTDiagnostic(0, msg);
+                }
+            }
+
+            constexpr size_t addState(CTNFATag tag, std::vector<CTRange> ranges, std::vector<size_t> follows)
+            {
+                this->states.push_back(CTNFAState(tag, ranges, follows));
+                return this->states.size() - 1;
+            }
+
+            //sorted and merged ranges (the same as RegexCompiler::normalizeRanges)
+            static constexpr std::vector<CTRange> normalizeRanges(bool compliment, std::vector<CTRange> ranges)
+            {
+                std::sort(ranges.begin(), ranges.end(), [](const CTRange& a, const CTRange& b) { return a.low < b.low; });
+
+                std::vector<CTRange> merged;
+                for(auto iter = ranges.cbegin(); iter != ranges.cend(); ++iter) {
+                    if(!merged.empty() && (merged.back().high == CT_MAX_CHAR || iter->low <= merged.back().high + 1)) {
+                        merged.back().high = std::max(merged.back().high, iter->high);
+                    }
+                    else {
+                        merged.push_back(*iter);
+                    }
+                }
+
+                if(!compliment) {
+                    return merged;
+                }
+
+                std::vector<CTRange> inverted;
+                CTChar low = 0;
+                bool done = false;
+                for(auto iter = merged.cbegin(); iter != merged.cend() && !done; ++iter) {
+                    if(low < iter->low) {
+                        inverted.push_back({ low, iter->low - 1 });
+                    }
+
+                    done = (iter->high == CT_MAX_CHAR);
+                    low = iter->high + 1;
+                }
+
+                if(!done) {
+                    inverted.push_back({ low, CT_MAX_CHAR });
+                }
+
+                return inverted;
+            }
+
+            constexpr size_t compileStar(const std::vector<CTOpt>& opts, size_t child, size_t follows, bool isplus)
+            {
+                const size_t loop = this->addState(CTNFATag::Split, {}, {});
+                const size_t body = this->compileOpt(opts, child, loop);
+                this->states[loop].follows = { body, follows };
+
+                return isplus ? body : loop;
+            }
+
+            constexpr size_t compileOpt(const std::vector<CTOpt>& opts, size_t optidx, size_t follows)
+            {
+                if(this->states.size() > CT_MAX_NFA_STATES) {
+                    this->fail("Regex is too large for ct_regex -- more than 4096 NFA states (use brexc or the runtime compiler)");
+                    return follows;
+                }
+
+                const CTOpt& opt = opts[optidx];
+                switch(opt.tag) {
+                    case CTOptTag::Literal: {
+                        size_t s = follows;
+                        for(auto iter = opt.codes.crbegin(); iter != opt.codes.crend(); ++iter) {
+                            s = this->addState(CTNFATag::Chars, { CTRange{ *iter, *iter } }, { s });
+                        }
+                        return s;
+                    }
+                    case CTOptTag::CharRange: {
+                        return this->addState(CTNFATag::Chars, CTRegexCompiler::normalizeRanges(opt.compliment, opt.ranges), { follows });
+                    }
+                    case CTOptTag::Dot: {
+                        return this->addState(CTNFATag::Chars, { CTRange{ 0, CT_MAX_CHAR } }, { follows });
+                    }
+                    case CTOptTag::Star: {
+                        return this->compileStar(opts, opt.children[0], follows, false);
+                    }
+                    case CTOptTag::Plus: {
+                        return this->compileStar(opts, opt.children[0], follows, true);
+                    }
+                    case CTOptTag::Optional: {
+                        const size_t body = this->compileOpt(opts, opt.children[0], follows);
+                        return this->addState(CTNFATag::Split, {}, { body, follows });
+                    }
+                    case CTOptTag::Range: {
+                        //unroll -- x{2,4} is x x (x (x)?)? and x{2,} is x x x*
+                        size_t s = follows;
+                        if(opt.high == UINT16_MAX) {
+                            s = this->compileStar(opts, opt.children[0], follows, false);
+                        }
+                        else {
+                            for(size_t i = opt.low; i < opt.high && this->ok; ++i) {
+                                const size_t body = this->compileOpt(opts, opt.children[0], s);
+                                s = this->addState(CTNFATag::Split, {}, { body, follows });
+                            }
+                        }
+
+                        for(size_t i = 0; i < opt.low && this->ok; ++i) {
+                            s = this->compileOpt(opts, opt.children[0], s);
+                        }
+                        return s;
+                    }
+                    case CTOptTag::Sequence: {
+                        size_t s = follows;
+                        for(auto iter = opt.children.crbegin(); iter != opt.children.crend(); ++iter) {
+                            s = this->compileOpt(opts, *iter, s);
+                        }
+                        return s;
+                    }
+                    case CTOptTag::AnyOf: {
+                        std::vector<size_t> starts;
+                        for(auto iter = opt.children.cbegin(); iter != opt.children.cend(); ++iter) {
+                            starts.push_back(this->compileOpt(opts, *iter, follows));
+                        }
+                        return this->addState(CTNFATag::Split, {}, starts);
+                    }
+                    default: {
+                        //named and env regexes are rejected by the parser
+                        this->fail("Named regexes are not supported in ct_regex -- use a ReSystem or brexc");
+                        return follows;
+                    }
+                }
+            }
+
+            //the chars and accept states reachable on epsilon moves -- sorted so it can be used as a DFA state key
+            constexpr std::vector<size_t> closure(const std::vector<size_t>& roots, std::vector<size_t>& marks, size_t stamp) const
+            {
+                std::vector<size_t> pending(roots);
+                std::vector<size_t> res;
+                while(!pending.empty()) {
+                    const size_t sid = pending.back();
+                    pending.pop_back();
+
+                    if(marks[sid] == stamp) {
+                        continue;
+                    }
+                    marks[sid] = stamp;
+
+                    if(this->states[sid].tag == CTNFATag::Split) {
+                        std::copy(this->states[sid].follows.cbegin(), this->states[sid].follows.cend(), std::back_inserter(pending));
+                    }
+                    else {
+                        res.push_back(sid);
+                    }
+                }
+
+                std::sort(res.begin(), res.end());
+                return res;
+            }
+
+            constexpr size_t classOf(CTChar c) const
+            {
+                return (size_t)(std::upper_bound(this->classlows.cbegin(), this->classlows.cend(), c) - this->classlows.cbegin()) - 1;
+            }
+
+            //split the chars on every range boundary so each class either matches all of a range or none of it
+            constexpr void computeClasses()
+            {
+                std::vector<CTChar> cuts = { 0 };
+                for(auto siter = this->states.cbegin(); siter != this->states.cend(); ++siter) {
+                    for(auto riter = siter->ranges.cbegin(); riter != siter->ranges.cend(); ++riter) {
+                        cuts.push_back(riter->low);
+                        if(riter->high != CT_MAX_CHAR) {
+                            cuts.push_back(riter->high + 1);
+                        }
+                    }
+                }
+
+                std::sort(cuts.begin(), cuts.end());
+                cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+                this->classlows = cuts;
+            }
+
+            //subset construction for one check -- the states are added to the shared tables
+            constexpr void buildDFA(size_t nfastart, size_t nfaaccept, const CTToplevelEntry& entry)
+            {
+                const size_t nclasses = this->classlows.size();
+                const uint32_t offset = (uint32_t)this->accepting.size();
+
+                std::vector<size_t> marks(this->states.size(), 0);
+                size_t stamp = 0;
+
+                //open addressing on the hash of the set
+                auto hashOf = [](const std::vector<size_t>& sset) {
+                    size_t h = 14695981039346656037ull;
+                    for(auto iter = sset.cbegin(); iter != sset.cend(); ++iter) {
+                        h = (h ^ *iter) * 1099511628211ull;
+                    }
+                    return h;
+                };
+                std::vector<size_t> slots(CT_MAX_DFA_STATES * 2, SIZE_MAX);
+                std::vector<std::vector<size_t>> dsets;
+
+                auto findOrAdd = [&](std::vector<size_t>&& sset) -> size_t {
+                    size_t slot = hashOf(sset) % slots.size();
+                    while(slots[slot] != SIZE_MAX) {
+                        if(dsets[slots[slot]] == sset) {
+                            return slots[slot];
+                        }
+                        slot = (slot + 1) % slots.size();
+                    }
+
+                    slots[slot] = dsets.size();
+                    dsets.push_back(std::move(sset));
+                    return dsets.size() - 1;
+                };
+
+                findOrAdd(this->closure({ nfastart }, marks, ++stamp));
+
+                std::vector<std::vector<size_t>> moves(nclasses);
+                for(size_t i = 0; i < dsets.size() && this->ok; ++i) {
+                    std::for_each(moves.begin(), moves.end(), [](std::vector<size_t>& mv) { mv.clear(); });
+
+                    for(auto iter = dsets[i].cbegin(); iter != dsets[i].cend(); ++iter) {
+                        const CTNFAState& nstate = this->states[*iter];
+                        for(auto riter = nstate.ranges.cbegin(); riter != nstate.ranges.cend(); ++riter) {
+                            for(size_t k = this->classOf(riter->low); k <= this->classOf(riter->high); ++k) {
+                                moves[k].push_back(nstate.follows[0]);
+                            }
+                        }
+                    }
+
+                    this->accepting.push_back(std::binary_search(dsets[i].cbegin(), dsets[i].cend(), nfaaccept));
+                    for(size_t k = 0; k < nclasses; ++k) {
+                        this->next.push_back(offset + (uint32_t)findOrAdd(this->closure(moves[k], marks, ++stamp)));
+                    }
+
+                    if(dsets.size() > CT_MAX_DFA_STATES) {
+                        this->fail("Regex is too large for ct_regex -- the DFA has more than 1024 states (use brexc or the runtime compiler)");
+                    }
+                }
+
+                //dead states can never reach an accepting state
+                const size_t nstates = dsets.size();
+                std::vector<bool> live(this->accepting.cbegin() + offset, this->accepting.cend());
+                bool changed = true;
+                while(changed && this->ok) {
+                    changed = false;
+                    for(size_t s = 0; s < nstates; ++s) {
+                        const auto tbegin = this->next.cbegin() + ((offset + s) * nclasses);
+                        if(!live[s] && std::any_of(tbegin, tbegin + nclasses, [&live, offset](uint32_t t) { return (bool)live[t - offset]; })) {
+                            live[s] = true;
+                            changed = true;
+                        }
+                    }
+                }
+                std::transform(live.cbegin(), live.cend(), std::back_inserter(this->dead), [](bool l) { return !l; });
+
+                this->checks.push_back(CTCheck{ offset, entry.isNegated, entry.isFrontCheck, entry.isBackCheck });
+            }
+
+            constexpr void compile(const std::string& re)
+            {
+                const std::string_view rev(re);
+                if(rev.ends_with("/p")) {
+                    this->diagnostic = CTDiagnostic(0, "Path regexes are not supported in ct_regex");
+                    return;
+                }
+
+                //the regex is unicode unless it ends with /c (the same as the brex command)
+                this->isUnicode = !rev.ends_with("/c");
+
+                CTRegex regex = CTRegexParser::parseRegex(re, this->isUnicode);
+                if(!regex.ok) {
+                    this->diagnostic = regex.diagnostic;
+                    return;
+                }
+
+                this->ok = true;
+                std::vector<std::pair<size_t, size_t>> nfas;
+                for(auto iter = regex.checks.cbegin(); iter != regex.checks.cend() && this->ok; ++iter) {
+                    const size_t accept = this->addState(CTNFATag::Accept, {}, {});
+
+                    size_t start = this->compileOpt(regex.opts, iter->opt, accept);
+                    if(iter->isBackCheck) {
+                        const size_t loop = this->addState(CTNFATag::Split, {}, {});
+                        const size_t dot = this->addState(CTNFATag::Chars, { CTRange{ 0, CT_MAX_CHAR } }, { loop });
+                        this->states[loop].follows = { dot, start };
+                        start = loop;
+                    }
+
+                    nfas.push_back({ start, accept });
+                }
+
+                this->computeClasses();
+                for(size_t i = 0; i < nfas.size() && this->ok; ++i) {
+                    this->buildDFA(nfas[i].first, nfas[i].second, regex.checks[i]);
+                }
+
+                if(this->ok && this->accepting.size() > UINT16_MAX) {
+                    this->fail("Regex is too large for ct_regex -- the DFAs have more than 65535 states in total");
+                }
+            }
+        };
+
+        template <typename TChar>
+        constexpr std::string ctRegexString(const TChar* chars, size_t len)
+        {
+            std::string re;
+            std::transform(chars, chars + len, std::back_inserter(re), [](TChar c) { return (char)c; });
+
+            return re;
+        }
+
+        class CTRegexInfo
+        {
+        public:
+            bool ok;
+            CTDiagnostic diagnostic;
+
+            size_t nchecks;
+            size_t nstates;
+            size_t nclasses;
+        };
+
+        //parse and compile the regex -- the diagnostic if it is not valid or the sizes of its tables if it is
+        template <typename TChar>
+        constexpr CTRegexInfo analyzeRegex(const TChar* chars, size_t len)
+        {
+            CTRegexCompiler compiler;
+            compiler.compile(ctRegexString(chars, len));
+            if(!compiler.ok) {
+                return CTRegexInfo{ false, compiler.diagnostic, 0, 0, 0 };
+            }
+
+            return CTRegexInfo{ true, CTDiagnostic(), compiler.checks.size(), compiler.accepting.size(), compiler.classlows.size() };
+        }
+
+        constexpr CTRegexInfo analyzeRegex(std::string_view re)
+        {
+            return analyzeRegex(re.data(), re.size());
+        }
+
+        template <size_t NChecks, size_t NStates, size_t NClasses>
+        class CTProgram
+        {
+        public:
+            bool isUnicode;
+            std::array<CTCheck, NChecks> checks;
+
+            std::array<uint16_t, NStates * NClasses> next;
+            std::array<bool, NStates> accepting;
+            std::array<bool, NStates> dead;
+
+            //the class of every char below 256 and the low char of each class (for the rest)
+            std::array<uint16_t, 256> byteclasses;
+            std::array<CTChar, NClasses> classlows;
+
+            constexpr size_t classOf(CTChar c) const
+            {
+                if(c < 256) {
+                    return this->byteclasses[c];
+                }
+
+                return (size_t)(std::upper_bound(this->classlows.cbegin(), this->classlows.cend(), c) - this->classlows.cbegin()) - 1;
+            }
+
+            template <typename TChar>
+            constexpr bool runCheck(const CTCheck& chk, const TChar* str, size_t len) const
+            {
+                uint32_t s = chk.start;
+                size_t i = 0;
+                while(i < len) {
+                    if(chk.isFrontCheck && this->accepting[s]) {
+                        return true;
+                    }
+
+                    CTChar c = (uint8_t)str[i++];
+                    if(this->isUnicode && c >= 0x80) {
+                        //the string is utf8 (and assumed to be well formed like UnicodeRegexIterator does)
+                        const size_t bytecount = ctUTF8ByteCount((uint8_t)c);
+                        if(bytecount > 1 && i + bytecount - 1 <= len) {
+                            c &= (0x7F >> bytecount);
+                            for(size_t j = 1; j < bytecount; ++j) {
+                                c = (c << 6) | ((uint8_t)str[i++] & 0x3F);
+                            }
+                        }
+                    }
+
+                    s = this->next[(s * NClasses) + this->classOf(c)];
+                    if(this->dead[s]) {
+                        return false;
+                    }
+                }
+
+                return this->accepting[s];
+            }
+
+            template <typename TChar>
+            constexpr bool test(const TChar* str, size_t len) const
+            {
+                return std::all_of(this->checks.cbegin(), this->checks.cend(), [this, str, len](const CTCheck& chk) {
+                    return this->runCheck(chk, str, len) != chk.isNegative;
+                });
+            }
+        };
+
+        template <size_t NChecks, size_t NStates, size_t NClasses, typename TChar>
+        constexpr CTProgram<NChecks, NStates, NClasses> buildProgram(const TChar* chars, size_t len)
+        {
+            CTProgram<NChecks, NStates, NClasses> program{};
+
+            CTRegexCompiler compiler;
+            compiler.compile(ctRegexString(chars, len));
+            if(!compiler.ok) {
+                return program;
+            }
+
+            program.isUnicode = compiler.isUnicode;
+            std::copy(compiler.checks.cbegin(), compiler.checks.cend(), program.checks.begin());
+            std::copy(compiler.next.cbegin(), compiler.next.cend(), program.next.begin());
+            std::copy(compiler.accepting.cbegin(), compiler.accepting.cend(), program.accepting.begin());
+            std::copy(compiler.dead.cbegin(), compiler.dead.cend(), program.dead.begin());
+            std::copy(compiler.classlows.cbegin(), compiler.classlows.cend(), program.classlows.begin());
+            for(CTChar c = 0; c < 256; ++c) {
+                program.byteclasses[c] = (uint16_t)compiler.classOf(c);
+            }
+
+            return program;
+        }
+
+        //an invalid regex fails the static_assert here and the diagnostic from the parser is the template argument in the error message
+        template <bool ok, CTDiagnostic diagnostic>
+        class CTRegexCheck
+        {
+        public:
+            static_assert(ok, "invalid regex in brex::ct_regex -- the error is the CTDiagnostic{line, msg} argument above");
+            static constexpr bool value = true;
+        };
+    }
+
+    //A regex that is parsed and compiled to a DFA at compile time -- brex::ct_regex<"/[0-9]{5}/c">::test("12345")
+    //Named and env regexes and pre/post anchors are not supported (use brexc or the runtime compiler for those)
+    template <ct::CTString RE>
+    class ct_regex
+    {
+    private:
+        static constexpr ct::CTRegexInfo info = ct::analyzeRegex(RE.chars, RE.size());
+        static_assert(ct::CTRegexCheck<info.ok, info.diagnostic>::value);
+
+        static constexpr auto program = ct::buildProgram<info.nchecks, info.nstates, info.nclasses>(RE.chars, RE.size());
+
+    public:
+        static constexpr bool test(std::string_view str)
+        {
+            return program.test(str.data(), str.size());
+        }
+
+        static constexpr bool test(std::u8string_view str)
+        {
+            return program.test(str.data(), str.size());
+        }
+    };
+}
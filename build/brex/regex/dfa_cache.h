@@ -0,0 +1,102 @@
+#pragma once
+
+#include "../common.h"
+
+#include "nfa_machine.h"
+
+namespace brex
+{
+    typedef int32_t DFAStateID;
+
+    //A lazily built DFA (on-the-fly subset construction) layered over a counter free NFAMachine
+    //States are the (sorted) sets of simple NFA states and transitions (on the char classes of the machine) are filled in as they are used -- if the cache grows past its
+    //memory budget it is cleared and rebuilt and if it keeps thrashing it gives up so the executor falls back to plain NFA simulation
+    class LazyDFACache
+    {
+    public:
+        static constexpr size_t DEFAULT_BUDGET = 2 * 1024 * 1024; //bytes
+        static constexpr size_t MIN_CLEARS_FOR_FAIL = 2; //always allow a couple of clears before deciding we are thrashing
+        static constexpr size_t THRASH_FACTOR = 10; //we want at least this many chars processed per state built between clears
+
+        static constexpr DFAStateID UNKNOWN_TRANSITION = -1;
+
+        class DFAStateInfo
+        {
+        public:
+            std::vector<StateID> nfastates;
+            bool accepting;
+            bool dead;
+        };
+
+    private:
+        const NFAMachine* m;
+        const size_t budget;
+        const size_t nclasses;
+
+        std::vector<DFAStateInfo> states;
+        std::vector<DFAStateID> transitions; //states.size() * nclasses entries
+        std::map<std::vector<StateID>, DFAStateID> stateids;
+        size_t usedbytes;
+
+        DFAStateID startstate;
+
+        size_t clearcount;
+        size_t charssinceclear;
+        bool failed;
+
+        void clearCache();
+        DFAStateID internState(std::vector<StateID>&& nfastates);
+
+        //the slow path when the transition is not cached -- returns false if the cache has failed and the executor should use nstates
+        bool computeTransition(DFAStateID& dstate, uint32_t cls, NFAState& nstates);
+
+    public:
+        LazyDFACache(const NFAMachine* m, size_t budget) : m(m), budget(budget), nclasses(m->charclasses.classCount()), states(), transitions(), stateids(), usedbytes(0), startstate(UNKNOWN_TRANSITION), clearcount(0), charssinceclear(0), failed(false) {;}
+        ~LazyDFACache() = default;
+
+        //create a cache for the machine if it is eligible (counter free) -- otherwise nullptr
+        static LazyDFACache* tryCreateCache(const NFAMachine* m, size_t budget);
+
+        inline bool hasFailed() const
+        {
+            return this->failed;
+        }
+
+        inline size_t stateCount() const
+        {
+            return this->states.size();
+        }
+
+        inline size_t clearCount() const
+        {
+            return this->clearcount;
+        }
+
+        DFAStateID getStartState();
+
+        inline bool isAccepting(DFAStateID dstate) const
+        {
+            return this->states[dstate].accepting;
+        }
+
+        inline bool isDead(DFAStateID dstate) const
+        {
+            return this->states[dstate].dead;
+        }
+
+        //advance the DFA state on c -- returns false if the cache gave up, in which case nstates holds the (NFA) state after c
+        inline bool step(DFAStateID& dstate, RegexChar c, NFAState& nstates)
+        {
+            this->charssinceclear++;
+
+            const uint32_t cls = this->m->charclasses.classOf(c);
+            const DFAStateID next = this->transitions[(dstate * this->nclasses) + cls];
+            if(next != UNKNOWN_TRANSITION) {
+                dstate = next;
+                return true;
+            }
+
+            return this->computeTransition(dstate, cls, nstates);
+        }
+    };
+}
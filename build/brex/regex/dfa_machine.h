@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../common.h"
+
+#include "nfa_machine.h"
+#include "dfa_cache.h"
+
+namespace brex
+{
+    //A fully built (and Hopcroft minimized) table driven DFA for a counter free NFAMachine
+    //The alphabet is the char classes of the machine so the table is next[state][class]
+    class DFAMachine
+    {
+    private:
+        static void minimize(size_t nclasses, const std::vector<DFAStateID>& transitions, const std::vector<bool>& accepting, std::vector<DFAStateID>& blockof, size_t& nblocks);
+
+    public:
+        const DFAStateID startstate;
+
+        const NFACharClasses charclasses;
+        const size_t nclasses;
+
+        const std::vector<DFAStateID> transitions; //stateCount() * nclasses entries
+        const std::vector<bool> accepting;
+        const DFAStateID deadstate; //-1 if there is no dead state
+        const DFAStateID acceptallstate; //the accepting state that every char loops on (-1 if there is none)
+
+        DFAMachine(DFAStateID startstate, const NFACharClasses& charclasses, std::vector<DFAStateID> transitions, std::vector<bool> accepting, DFAStateID deadstate, DFAStateID acceptallstate) : startstate(startstate), charclasses(charclasses), nclasses(charclasses.classCount()), transitions(transitions), accepting(accepting), deadstate(deadstate), acceptallstate(acceptallstate) {;}
+        ~DFAMachine() = default;
+
+        //the subset construction for a counter free machine -- statesets[i] is the (sorted) set of NFA states of DFA state i and 0 is the start state
+        //false if there are more than maxstates states
+        static bool buildSubsetMachine(const NFAMachine* m, size_t maxstates, std::vector<DFAStateID>& transitions, std::vector<std::vector<StateID>>& statesets, DFAStateID& deadstate);
+
+        //build a minimized DFA for the machine if it is counter free and has at most maxstates (unminimized) states -- otherwise nullptr
+        static DFAMachine* tryCompile(const NFAMachine* m, size_t maxstates);
+
+        //the DFA for the strings this one does not match -- the dead and accept-all states swap
+        static DFAMachine* complement(const DFAMachine* m);
+
+        inline size_t stateCount() const
+        {
+            return this->accepting.size();
+        }
+
+        inline DFAStateID step(DFAStateID dstate, RegexChar c) const
+        {
+            return this->transitions[(dstate * this->nclasses) + this->charclasses.classOf(c)];
+        }
+
+        inline bool isAccepting(DFAStateID dstate) const
+        {
+            return this->accepting[dstate];
+        }
+
+        inline bool isDead(DFAStateID dstate) const
+        {
+            return dstate == this->deadstate;
+        }
+
+        inline bool acceptsAll(DFAStateID dstate) const
+        {
+            return dstate == this->acceptallstate;
+        }
+    };
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../common.h"
+
+#include "nfa_machine.h"
+#include "dfa_machine.h"
+
+namespace brex
+{
+    //The machine for a set of regexes that are run together -- regex i is compiled to end in its own accept state i of the NFAMachine (and the start is an AnyOf of them)
+    //If the machine is counter free and small enough there is also a full table driven DFA where each state has the list of the regexes that accept in it
+    class SetMachine
+    {
+    public:
+        const NFAMachine* nfa;
+        const size_t npatterns;
+
+        //the DFA (start state 0) is not minimized -- transitions is empty if there is no DFA
+        const std::vector<DFAStateID> transitions; //accepts.size() * nclasses entries
+        const std::vector<std::vector<size_t>> accepts;
+        const DFAStateID deadstate; //-1 if there is no dead state
+
+        SetMachine(const NFAMachine* nfa, size_t npatterns, std::vector<DFAStateID> transitions, std::vector<std::vector<size_t>> accepts, DFAStateID deadstate) : nfa(nfa), npatterns(npatterns), transitions(transitions), accepts(accepts), deadstate(deadstate) {;}
+        ~SetMachine() = default;
+
+        //build the set machine for the NFA and, if buildDFA, the DFA for it when it is counter free and has at most maxstates states
+        static SetMachine* compile(const NFAMachine* nfa, size_t npatterns, bool buildDFA, size_t maxstates);
+
+        inline bool hasDFA() const
+        {
+            return !this->transitions.empty();
+        }
+
+        inline DFAStateID step(DFAStateID dstate, RegexChar c) const
+        {
+            return this->transitions[(dstate * this->nfa->charclasses.classCount()) + this->nfa->charclasses.classOf(c)];
+        }
+
+        inline bool isDead(DFAStateID dstate) const
+        {
+            return dstate == this->deadstate;
+        }
+
+        //add the regexes that accept in the NFA state to accepted (in increasing order)
+        void acceptedPatterns(const NFAState& nstates, std::vector<size_t>& accepted) const;
+    };
+}
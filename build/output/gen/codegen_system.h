@@ -0,0 +1,944 @@
+//generated by brexc -- do not edit
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace brexgentest
+{
+    inline bool Main_Part_0(const uint8_t* str, size_t len)
+    {
+        size_t i = 0;
+
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x61 <= c && c <= 0x63)) {
+                goto s5;
+            }
+            return false;
+        }
+
+    s5:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c == 0x2D) {
+                goto s4;
+            }
+            if((0x61 <= c && c <= 0x63)) {
+                goto s5;
+            }
+            return false;
+        }
+
+    s4:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x30 <= c && c <= 0x39)) {
+                goto s2;
+            }
+            return false;
+        }
+
+    s2:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x30 <= c && c <= 0x39)) {
+                goto s3;
+            }
+            return false;
+        }
+
+    s3:
+        if(i == len) {
+            return true;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x30 <= c && c <= 0x39)) {
+                goto s0;
+            }
+            return false;
+        }
+
+    s0:
+        if(i == len) {
+            return true;
+        }
+        return false;
+    }
+
+    //Main::Part
+    inline bool Main_Part(const char* str, size_t len)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);
+        return Main_Part_0(bytes, len);
+    }
+
+    inline bool Main_Tagged_0(const uint8_t* str, size_t len)
+    {
+        size_t i = 0;
+
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x61 <= c && c <= 0x63)) {
+                goto s7;
+            }
+            return false;
+        }
+
+    s7:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c == 0x2D) {
+                goto s6;
+            }
+            if((0x61 <= c && c <= 0x63)) {
+                goto s7;
+            }
+            return false;
+        }
+
+    s6:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x30 <= c && c <= 0x39)) {
+                goto s4;
+            }
+            return false;
+        }
+
+    s4:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x30 <= c && c <= 0x39)) {
+                goto s5;
+            }
+            return false;
+        }
+
+    s5:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c == 0x40) {
+                goto s0;
+            }
+            if((0x30 <= c && c <= 0x39)) {
+                goto s2;
+            }
+            return false;
+        }
+
+    s0:
+        if(i == len) {
+            return true;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c == 0x78) {
+                goto s0;
+            }
+            if(c == 0x79) {
+                goto s3;
+            }
+            return false;
+        }
+
+    s2:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c == 0x40) {
+                goto s0;
+            }
+            return false;
+        }
+
+    s3:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c == 0x7A) {
+                goto s0;
+            }
+            return false;
+        }
+    }
+
+    //Main::Tagged
+    inline bool Main_Tagged(const char* str, size_t len)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);
+        return Main_Tagged_0(bytes, len);
+    }
+
+    inline bool Main_Accent_0(const uint8_t* str, size_t len)
+    {
+        size_t i = 0;
+
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c == 0xC3) {
+                goto s13;
+            }
+            return false;
+        }
+
+    s13:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c == 0xA9) {
+                goto s2;
+            }
+            return false;
+        }
+
+    s2:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c <= 0x60 || (0x64 <= c && c <= 0x7F)) {
+                goto s0;
+            }
+            if((0x61 <= c && c <= 0x63)) {
+                goto s3;
+            }
+            if(c == 0xC3) {
+                goto s4;
+            }
+            if(c == 0xED) {
+                goto s5;
+            }
+            if(c == 0xE0) {
+                goto s6;
+            }
+            if((0xE1 <= c && c <= 0xEC) || (0xEE <= c && c <= 0xEF)) {
+                goto s7;
+            }
+            if(c == 0xF4) {
+                goto s8;
+            }
+            if(c == 0xF0) {
+                goto s9;
+            }
+            if((0xF1 <= c && c <= 0xF3)) {
+                goto s10;
+            }
+            if(c == 0xC2 || (0xC4 <= c && c <= 0xDF)) {
+                goto s11;
+            }
+            return false;
+        }
+
+    s0:
+        if(i == len) {
+            return true;
+        }
+        return false;
+
+    s3:
+        if(i == len) {
+            return true;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c <= 0x60 || (0x64 <= c && c <= 0x7F)) {
+                goto s0;
+            }
+            if((0x61 <= c && c <= 0x63)) {
+                goto s3;
+            }
+            if(c == 0xED) {
+                goto s5;
+            }
+            if(c == 0xE0) {
+                goto s6;
+            }
+            if((0xE1 <= c && c <= 0xEC) || (0xEE <= c && c <= 0xEF)) {
+                goto s7;
+            }
+            if(c == 0xF4) {
+                goto s8;
+            }
+            if(c == 0xF0) {
+                goto s9;
+            }
+            if((0xF1 <= c && c <= 0xF3)) {
+                goto s10;
+            }
+            if((0xC2 <= c && c <= 0xDF)) {
+                goto s11;
+            }
+            return false;
+        }
+
+    s4:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x80 <= c && c <= 0xA8) || (0xAA <= c && c <= 0xBF)) {
+                goto s0;
+            }
+            if(c == 0xA9) {
+                goto s12;
+            }
+            return false;
+        }
+
+    s5:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x80 <= c && c <= 0x9F)) {
+                goto s11;
+            }
+            return false;
+        }
+
+    s6:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0xA0 <= c && c <= 0xBF)) {
+                goto s11;
+            }
+            return false;
+        }
+
+    s7:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x80 <= c && c <= 0xBF)) {
+                goto s11;
+            }
+            return false;
+        }
+
+    s8:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x80 <= c && c <= 0x8F)) {
+                goto s7;
+            }
+            return false;
+        }
+
+    s9:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x90 <= c && c <= 0xBF)) {
+                goto s7;
+            }
+            return false;
+        }
+
+    s10:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x80 <= c && c <= 0xBF)) {
+                goto s7;
+            }
+            return false;
+        }
+
+    s11:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x80 <= c && c <= 0xBF)) {
+                goto s0;
+            }
+            return false;
+        }
+
+    s12:
+        if(i == len) {
+            return true;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c <= 0x60 || (0x64 <= c && c <= 0x7F)) {
+                goto s0;
+            }
+            if((0x61 <= c && c <= 0x63)) {
+                goto s3;
+            }
+            if(c == 0xC3) {
+                goto s4;
+            }
+            if(c == 0xED) {
+                goto s5;
+            }
+            if(c == 0xE0) {
+                goto s6;
+            }
+            if((0xE1 <= c && c <= 0xEC) || (0xEE <= c && c <= 0xEF)) {
+                goto s7;
+            }
+            if(c == 0xF4) {
+                goto s8;
+            }
+            if(c == 0xF0) {
+                goto s9;
+            }
+            if((0xF1 <= c && c <= 0xF3)) {
+                goto s10;
+            }
+            if(c == 0xC2 || (0xC4 <= c && c <= 0xDF)) {
+                goto s11;
+            }
+            return false;
+        }
+    }
+
+    //Main::Accent
+    inline bool Main_Accent(const char* str, size_t len)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);
+        return Main_Accent_0(bytes, len);
+    }
+
+    inline constexpr uint8_t Main_Long_0_classes[256] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    };
+
+    inline constexpr uint16_t Main_Long_0_next[] = {
+        3, 3, 3, 3, 3,
+        3, 3, 3, 2, 3,
+        3, 0, 3, 40, 3,
+        3, 3, 3, 3, 3,
+        3, 0, 3, 3, 3,
+        3, 0, 3, 4, 3,
+        3, 0, 3, 5, 3,
+        3, 0, 3, 6, 3,
+        3, 0, 3, 7, 3,
+        3, 0, 3, 8, 3,
+        3, 0, 3, 9, 3,
+        3, 0, 3, 10, 3,
+        3, 0, 3, 11, 3,
+        3, 0, 3, 12, 3,
+        3, 0, 3, 13, 3,
+        3, 0, 3, 14, 3,
+        3, 0, 3, 15, 3,
+        3, 0, 3, 16, 3,
+        3, 0, 3, 17, 3,
+        3, 0, 3, 18, 3,
+        3, 0, 3, 19, 3,
+        3, 0, 3, 20, 3,
+        3, 0, 3, 21, 3,
+        3, 0, 3, 22, 3,
+        3, 0, 3, 23, 3,
+        3, 0, 3, 24, 3,
+        3, 0, 3, 25, 3,
+        3, 0, 3, 26, 3,
+        3, 0, 3, 27, 3,
+        3, 0, 3, 28, 3,
+        3, 0, 3, 29, 3,
+        3, 0, 3, 30, 3,
+        3, 0, 3, 31, 3,
+        3, 0, 3, 32, 3,
+        3, 0, 3, 33, 3,
+        3, 0, 3, 34, 3,
+        3, 0, 3, 35, 3,
+        3, 0, 3, 36, 3,
+        3, 0, 3, 37, 3,
+        3, 0, 3, 38, 3,
+        3, 0, 3, 39, 3,
+        3, 3, 3, 1, 3,
+        3, 3, 3, 41, 3,
+    };
+
+    inline constexpr bool Main_Long_0_accepting[] = {
+        true, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false,
+    };
+
+    inline bool Main_Long_0(const uint8_t* str, size_t len)
+    {
+        uint32_t s = 42;
+        for(size_t i = 0; i < len; ++i) {
+            s = Main_Long_0_next[(s * 5) + Main_Long_0_classes[str[i]]];
+            if(s == 3) {
+                return false;
+            }
+        }
+
+        return Main_Long_0_accepting[s];
+    }
+
+    //Main::Long
+    inline bool Main_Long(const char* str, size_t len)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);
+        return Main_Long_0(bytes, len);
+    }
+
+    inline bool Main_NotA_0(const uint8_t* str, size_t len)
+    {
+        size_t i = 0;
+
+    s0:
+        if(i == len) {
+            return true;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x30 <= c && c <= 0x39) || (0x61 <= c && c <= 0x63)) {
+                goto s0;
+            }
+            return false;
+        }
+    }
+
+    inline bool Main_NotA_1(const uint8_t* str, size_t len)
+    {
+        size_t i = 0;
+
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c == 0x61) {
+                goto s0;
+            }
+            return false;
+        }
+
+    s0:
+        if(i == len) {
+            return true;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x61 <= c && c <= 0x63)) {
+                goto s0;
+            }
+            return false;
+        }
+    }
+
+    //Main::NotA
+    inline bool Main_NotA(const char* str, size_t len)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);
+        return Main_NotA_0(bytes, len) && !Main_NotA_1(bytes, len);
+    }
+
+    inline bool Main_Front_0(const uint8_t* str, size_t len)
+    {
+        size_t i = 0;
+
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c == 0x61) {
+                goto s2;
+            }
+            return false;
+        }
+
+    s2:
+        if(i == len) {
+            return false;
+        }
+        {
+            const uint8_t c = str[i++];
+            if(c == 0x62) {
+                goto s0;
+            }
+            return false;
+        }
+
+    s0:
+        return true;
+    }
+
+    inline bool Main_Front_1(const uint8_t* str, size_t len)
+    {
+        size_t i = 0;
+
+    s0:
+        if(i == len) {
+            return true;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x30 <= c && c <= 0x39) || (0x61 <= c && c <= 0x63)) {
+                goto s0;
+            }
+            return false;
+        }
+    }
+
+    //Main::Front
+    inline bool Main_Front(const char* str, size_t len)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);
+        return Main_Front_0(bytes, len) && Main_Front_1(bytes, len);
+    }
+
+    inline bool Main_Back_0(const uint8_t* str, size_t len)
+    {
+        size_t i = 0;
+
+    s0:
+        if(i == len) {
+            return true;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x30 <= c && c <= 0x39) || (0x61 <= c && c <= 0x63)) {
+                goto s0;
+            }
+            return false;
+        }
+    }
+
+    inline bool Main_Back_1(const uint8_t* str, size_t len)
+    {
+        size_t i = len;
+
+        if(i == 0) {
+            return false;
+        }
+        {
+            const uint8_t c = str[--i];
+            if(c == 0x39) {
+                goto s0;
+            }
+            return false;
+        }
+
+    s0:
+        return true;
+    }
+
+    //Main::Back
+    inline bool Main_Back(const char* str, size_t len)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);
+        return Main_Back_0(bytes, len) && Main_Back_1(bytes, len);
+    }
+
+    inline constexpr uint8_t Main_FrontTable_0_classes[256] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 3, 4, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+        6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    };
+
+    inline constexpr uint16_t Main_FrontTable_0_next[] = {
+        3, 2, 3, 42, 42, 42, 3,
+        3, 3, 3, 0, 0, 0, 3,
+        3, 3, 3, 3, 3, 3, 3,
+        3, 3, 3, 3, 3, 3, 3,
+        3, 2, 3, 3, 3, 3, 3,
+        3, 2, 3, 4, 4, 4, 3,
+        3, 2, 3, 5, 5, 5, 3,
+        3, 2, 3, 6, 6, 6, 3,
+        3, 2, 3, 7, 7, 7, 3,
+        3, 2, 3, 8, 8, 8, 3,
+        3, 2, 3, 9, 9, 9, 3,
+        3, 2, 3, 10, 10, 10, 3,
+        3, 2, 3, 11, 11, 11, 3,
+        3, 2, 3, 12, 12, 12, 3,
+        3, 2, 3, 13, 13, 13, 3,
+        3, 2, 3, 14, 14, 14, 3,
+        3, 2, 3, 15, 15, 15, 3,
+        3, 2, 3, 16, 16, 16, 3,
+        3, 2, 3, 17, 17, 17, 3,
+        3, 2, 3, 18, 18, 18, 3,
+        3, 2, 3, 19, 19, 19, 3,
+        3, 2, 3, 20, 20, 20, 3,
+        3, 2, 3, 21, 21, 21, 3,
+        3, 2, 3, 22, 22, 22, 3,
+        3, 2, 3, 23, 23, 23, 3,
+        3, 2, 3, 24, 24, 24, 3,
+        3, 2, 3, 25, 25, 25, 3,
+        3, 2, 3, 26, 26, 26, 3,
+        3, 2, 3, 27, 27, 27, 3,
+        3, 2, 3, 28, 28, 28, 3,
+        3, 2, 3, 29, 29, 29, 3,
+        3, 2, 3, 30, 30, 30, 3,
+        3, 2, 3, 31, 31, 31, 3,
+        3, 2, 3, 32, 32, 32, 3,
+        3, 2, 3, 33, 33, 33, 3,
+        3, 2, 3, 34, 34, 34, 3,
+        3, 2, 3, 35, 35, 35, 3,
+        3, 2, 3, 36, 36, 36, 3,
+        3, 2, 3, 37, 37, 37, 3,
+        3, 2, 3, 38, 38, 38, 3,
+        3, 2, 3, 39, 39, 39, 3,
+        3, 2, 3, 40, 40, 40, 3,
+        3, 2, 3, 41, 41, 41, 3,
+        3, 3, 3, 3, 1, 3, 3,
+        3, 3, 3, 43, 3, 3, 3,
+    };
+
+    inline constexpr bool Main_FrontTable_0_accepting[] = {
+        true, false, true, false, true, true, true, true, true, true, true, true, true, true, true, true,
+        true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true,
+        true, true, true, true, true, true, true, true, true, true, true, false, false,
+    };
+
+    inline bool Main_FrontTable_0(const uint8_t* str, size_t len)
+    {
+        uint32_t s = 44;
+        for(size_t i = 0; i < len; ++i) {
+            if(Main_FrontTable_0_accepting[s]) {
+                return true;
+            }
+
+            s = Main_FrontTable_0_next[(s * 7) + Main_FrontTable_0_classes[str[i]]];
+            if(s == 3) {
+                return false;
+            }
+        }
+
+        return Main_FrontTable_0_accepting[s];
+    }
+
+    inline bool Main_FrontTable_1(const uint8_t* str, size_t len)
+    {
+        size_t i = 0;
+
+    s0:
+        if(i == len) {
+            return true;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x30 <= c && c <= 0x39) || (0x61 <= c && c <= 0x63)) {
+                goto s0;
+            }
+            return false;
+        }
+    }
+
+    //Main::FrontTable
+    inline bool Main_FrontTable(const char* str, size_t len)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);
+        return Main_FrontTable_0(bytes, len) && Main_FrontTable_1(bytes, len);
+    }
+
+    inline bool Main_BackTable_0(const uint8_t* str, size_t len)
+    {
+        size_t i = 0;
+
+    s0:
+        if(i == len) {
+            return true;
+        }
+        {
+            const uint8_t c = str[i++];
+            if((0x30 <= c && c <= 0x39) || (0x61 <= c && c <= 0x63)) {
+                goto s0;
+            }
+            return false;
+        }
+    }
+
+    inline constexpr uint8_t Main_BackTable_1_classes[256] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    };
+
+    inline constexpr uint16_t Main_BackTable_1_next[] = {
+        3, 3, 3, 3, 3,
+        3, 3, 3, 2, 3,
+        3, 0, 3, 41, 3,
+        3, 3, 3, 3, 3,
+        3, 0, 3, 3, 3,
+        3, 0, 3, 4, 3,
+        3, 0, 3, 5, 3,
+        3, 0, 3, 6, 3,
+        3, 0, 3, 7, 3,
+        3, 0, 3, 8, 3,
+        3, 0, 3, 9, 3,
+        3, 0, 3, 10, 3,
+        3, 0, 3, 11, 3,
+        3, 0, 3, 12, 3,
+        3, 0, 3, 13, 3,
+        3, 0, 3, 14, 3,
+        3, 0, 3, 15, 3,
+        3, 0, 3, 16, 3,
+        3, 0, 3, 17, 3,
+        3, 0, 3, 18, 3,
+        3, 0, 3, 19, 3,
+        3, 0, 3, 20, 3,
+        3, 0, 3, 21, 3,
+        3, 0, 3, 22, 3,
+        3, 0, 3, 23, 3,
+        3, 0, 3, 24, 3,
+        3, 0, 3, 25, 3,
+        3, 0, 3, 26, 3,
+        3, 0, 3, 27, 3,
+        3, 0, 3, 28, 3,
+        3, 0, 3, 29, 3,
+        3, 0, 3, 30, 3,
+        3, 0, 3, 31, 3,
+        3, 0, 3, 32, 3,
+        3, 0, 3, 33, 3,
+        3, 0, 3, 34, 3,
+        3, 0, 3, 35, 3,
+        3, 0, 3, 36, 3,
+        3, 0, 3, 37, 3,
+        3, 0, 3, 38, 3,
+        3, 0, 3, 39, 3,
+        3, 0, 3, 40, 3,
+        3, 3, 3, 1, 3,
+    };
+
+    inline constexpr bool Main_BackTable_1_accepting[] = {
+        true, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false,
+    };
+
+    inline bool Main_BackTable_1(const uint8_t* str, size_t len)
+    {
+        uint32_t s = 42;
+        for(size_t i = 0; i < len; ++i) {
+            if(Main_BackTable_1_accepting[s]) {
+                return true;
+            }
+
+            s = Main_BackTable_1_next[(s * 5) + Main_BackTable_1_classes[str[len - 1 - i]]];
+            if(s == 3) {
+                return false;
+            }
+        }
+
+        return Main_BackTable_1_accepting[s];
+    }
+
+    //Main::BackTable
+    inline bool Main_BackTable(const char* str, size_t len)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);
+        return Main_BackTable_0(bytes, len) && Main_BackTable_1(bytes, len);
+    }
+
+    struct Matcher
+    {
+        const char* name;
+        const char* regex;
+        bool (*test)(const char*, size_t);
+    };
+
+    inline constexpr Matcher matchers[] = {
+        { "Main::Part", "/[a-c]+ \"-\" [0-9]{2,3}/", &Main_Part },
+        { "Main::Tagged", "/${Part} \"@\" (\"x\" | \"yz\")*/", &Main_Tagged },
+        { "Main::Accent", "/\"\303\251\"+ [a-c]* ./", &Main_Accent },
+        { "Main::Long", "/[a-c]{3,40} [0-9]/c", &Main_Long },
+        { "Main::NotA", "/[a-c0-9]* & !('a' [a-c]*)/c", &Main_NotA },
+        { "Main::Front", "/^'ab' & [a-c0-9]*/c", &Main_Front },
+        { "Main::Back", "/[a-c0-9]* & '9'$/c", &Main_Back },
+        { "Main::FrontTable", "/^('ab' [a-c]{1,40} '9'?) & [a-c0-9]*/c", &Main_FrontTable },
+        { "Main::BackTable", "/[a-c0-9]* & ('0' [a-c]{2,40})$/c", &Main_BackTable },
+    };
+}
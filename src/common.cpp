@@ -403,10 +403,10 @@ namespace brex
         if(rc <= 0x7F) {
             return std::vector<uint8_t>{ (uint8_t)rc };
         }
-        else if(rc < 0x7FF) {
+        else if(rc <= 0x7FF) {
             return std::vector<uint8_t>({ (uint8_t)(0xC0 | (rc >> 6)), (uint8_t)(0x80 | (rc & 0x3F)) });
         }
-        else if(rc < 0xFFFF) {
+        else if(rc <= 0xFFFF) {
             return std::vector<uint8_t>({ (uint8_t)(0xE0 | (rc >> 12)), (uint8_t)(0x80 | ((rc >> 6) & 0x3F)), (uint8_t)(0x80 | (rc & 0x3F)) });
         }
         else {
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <string>
+#include <array>
 #include <optional>
 #include <vector>
+#include <deque>
 #include <map>
 #include <set>
 
@@ -45,6 +47,8 @@ namespace brex
     void processAbort(const char* file, int line, const char* msg) __attribute__ ((noreturn));
 #endif
 
+    //Positions from the executors are byte offsets for every iterator -- a match start is the first byte of its first char and a match end is the last byte of its last char
+    //So the char after a match that ends at e starts at e + 1 (an empty match at p ends at p - 1) whether the iterator steps whole chars or single bytes
     class UnicodeRegexIterator
     {
     public:
@@ -88,11 +92,9 @@ namespace brex
 
         inline void dec()
         {
-            //if this is a multibyte char then advance by the number of bytes -- fast path on single byte
-            if(UTF8_IS_SINGLEBYTE_ENCODING(this->sstr->at(this->curr))) {
-                this->curr--;
-            }
-            else {
+            //step back a byte and if that is the end of a multibyte char then back up to its first byte -- fast path on single byte
+            this->curr--;
+            if(this->spos <= this->curr && UTF8_IS_MULTIBYTE_ENCODING(this->sstr->at(this->curr))) {
                 this->curr -= this->charCodeByteCountReverse();
             }
         }
@@ -151,6 +153,49 @@ namespace brex
         }
     };
 
+    //iterate over the raw utf8 bytes of a UnicodeString -- used when the regex has been lowered to a utf8 byte automaton
+    class UnicodeByteRegexIterator
+    {
+    public:
+        const UnicodeString* sstr;
+        
+        int64_t spos; //the first position where the iterator is valid (inclusive)
+        int64_t epos; //the last position where the iterator is valid (exclusive)
+
+        int64_t curr;
+
+        UnicodeByteRegexIterator() : sstr(nullptr), spos(0), epos(-1), curr(0) {;}
+        UnicodeByteRegexIterator(const UnicodeString* sstr) : sstr(sstr), spos(0), epos(sstr->size() - 1), curr(0) {;}
+        UnicodeByteRegexIterator(const UnicodeString* sstr, int64_t spos, int64_t epos, int64_t curr) : sstr(sstr), spos(spos), epos(epos), curr(curr) {;}
+        ~UnicodeByteRegexIterator() = default;
+
+        UnicodeByteRegexIterator(const UnicodeByteRegexIterator& other) = default;
+        UnicodeByteRegexIterator(UnicodeByteRegexIterator&& other) = default;
+
+        UnicodeByteRegexIterator& operator=(const UnicodeByteRegexIterator& other) = default;
+        UnicodeByteRegexIterator& operator=(UnicodeByteRegexIterator&& other) = default;
+        
+        inline bool valid() const
+        {
+            return (this->spos <= this->curr) & (this->curr <= this->epos);
+        }
+
+        inline void inc()
+        {
+            this->curr++;
+        }
+
+        inline void dec()
+        {
+            this->curr--;
+        }
+
+        inline RegexChar get() const
+        {
+            return (RegexChar)this->sstr->at(this->curr);
+        }
+    };
+
     std::string processRegexCharToBsqStandard(RegexChar c);
     std::string processRegexCharsToBsqStandard(const std::vector<RegexChar>& sv);
 
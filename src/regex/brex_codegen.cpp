@@ -0,0 +1,310 @@
+#include "brex_codegen.h"
+
+namespace brex
+{
+    std::map<DFAStateID, std::vector<std::pair<uint32_t, uint32_t>>> RegexCodeGenerator::computeByteRuns(const DFAMachine* dfa, DFAStateID dstate)
+    {
+        std::map<DFAStateID, std::vector<std::pair<uint32_t, uint32_t>>> runs;
+        for(uint32_t b = 0; b < 256; ++b) {
+            const DFAStateID next = dfa->step(dstate, (RegexChar)b);
+
+            std::vector<std::pair<uint32_t, uint32_t>>& truns = runs[next];
+            if(!truns.empty() && truns.back().second + 1 == b) {
+                truns.back().second = b;
+            }
+            else {
+                truns.push_back({ b, b });
+            }
+        }
+
+        return runs;
+    }
+
+    std::string RegexCodeGenerator::emitByte(uint32_t b)
+    {
+        const char* digits = "0123456789ABCDEF";
+        return std::string("0x") + digits[(b >> 4) & 0xF] + digits[b & 0xF];
+    }
+
+    std::string RegexCodeGenerator::emitRunTest(const std::vector<std::pair<uint32_t, uint32_t>>& runs)
+    {
+        std::string test;
+        for(auto iter = runs.cbegin(); iter != runs.cend(); ++iter) {
+            if(!test.empty()) {
+                test += " || ";
+            }
+
+            if(iter->first == iter->second) {
+                test += "c == " + RegexCodeGenerator::emitByte(iter->first);
+            }
+            else if(iter->first == 0) {
+                test += "c <= " + RegexCodeGenerator::emitByte(iter->second);
+            }
+            else if(iter->second == 255) {
+                test += RegexCodeGenerator::emitByte(iter->first) + " <= c";
+            }
+            else {
+                test += "(" + RegexCodeGenerator::emitByte(iter->first) + " <= c && c <= " + RegexCodeGenerator::emitByte(iter->second) + ")";
+            }
+        }
+
+        return test;
+    }
+
+    std::string RegexCodeGenerator::emitSwitchCheck(const std::string& fname, const CodegenCheck& check)
+    {
+        const DFAMachine* dfa = check.dfa;
+        const bool stoponaccept = check.isFrontCheck || check.isBackCheck;
+
+        std::string code = "    inline bool " + fname + "(const uint8_t* str, size_t len)\n    {\n";
+        if(dfa->isDead(dfa->startstate)) {
+            return code + "        static_cast<void>(str);\n        static_cast<void>(len);\n\n        return false;\n    }\n";
+        }
+
+        //every state we can get to (other than the dead state) is a label -- the start state is first so we fall into it
+        std::vector<DFAStateID> order = { dfa->startstate };
+        std::set<DFAStateID> targets;
+        bool usesindex = false;
+        bool readschars = false;
+
+        std::string body;
+        for(size_t i = 0; i < order.size(); ++i) {
+            const DFAStateID s = order[i];
+            auto jumpTo = [dfa, &order, &targets](DFAStateID next) {
+                if(dfa->isDead(next)) {
+                    return std::string("return false;");
+                }
+
+                if(std::find(order.cbegin(), order.cend(), next) == order.cend()) {
+                    order.push_back(next);
+                }
+                targets.insert(next);
+
+                return "goto s" + std::to_string(next) + ";";
+            };
+
+            body += "    s" + std::to_string(s) + ":\n";
+            if(stoponaccept && dfa->isAccepting(s)) {
+                body += "        return true;\n\n";
+                continue;
+            }
+
+            usesindex = true;
+            body += std::string("        if(") + (check.isBackCheck ? "i == 0" : "i == len") + ") {\n";
+            body += std::string("            return ") + (dfa->isAccepting(s) ? "true" : "false") + ";\n";
+            body += "        }\n";
+
+            const auto runs = RegexCodeGenerator::computeByteRuns(dfa, s);
+            if(runs.size() == 1) {
+                if(!dfa->isDead(runs.cbegin()->first)) {
+                    body += std::string("        ") + (check.isBackCheck ? "--i" : "++i") + ";\n";
+                }
+                body += "        " + jumpTo(runs.cbegin()->first) + "\n\n";
+                continue;
+            }
+
+            //the dead state (or else the target with the most runs) is the fall through case
+            DFAStateID dflt = runs.cbegin()->first;
+            for(auto riter = runs.cbegin(); riter != runs.cend(); ++riter) {
+                if(dfa->isDead(riter->first) || (!dfa->isDead(dflt) && riter->second.size() > runs.at(dflt).size())) {
+                    dflt = riter->first;
+                }
+            }
+
+            readschars = true;
+            body += "        {\n";
+            body += std::string("            const uint8_t c = ") + (check.isBackCheck ? "str[--i]" : "str[i++]") + ";\n";
+            for(auto riter = runs.cbegin(); riter != runs.cend(); ++riter) {
+                if(riter->first != dflt) {
+                    body += "            if(" + RegexCodeGenerator::emitRunTest(riter->second) + ") {\n";
+                    body += "                " + jumpTo(riter->first) + "\n";
+                    body += "            }\n";
+                }
+            }
+            body += "            " + jumpTo(dflt) + "\n";
+            body += "        }\n\n";
+        }
+
+        //the start state label is only needed if there is a jump back to it
+        if(!targets.contains(dfa->startstate)) {
+            body.erase(0, body.find('\n') + 1);
+        }
+        body.pop_back();
+
+        if(usesindex) {
+            code += std::string("        size_t i = ") + (check.isBackCheck ? "len" : "0") + ";\n";
+        }
+        else {
+            code += "        static_cast<void>(len);\n";
+        }
+
+        if(!readschars) {
+            code += "        static_cast<void>(str);\n";
+        }
+
+        return code + "\n" + body + "    }\n";
+    }
+
+    std::string RegexCodeGenerator::emitTableCheck(const std::string& fname, const CodegenCheck& check)
+    {
+        const DFAMachine* dfa = check.dfa;
+
+        //number the machine classes that bytes fall in densely so the byte map fits in a uint8_t
+        std::map<uint32_t, uint32_t> denseclasses;
+        std::vector<uint32_t> bytemap;
+        std::vector<uint32_t> lowclass;
+        for(uint32_t b = 0; b < 256; ++b) {
+            const uint32_t cls = dfa->charclasses.classOf((RegexChar)b);
+            if(!denseclasses.contains(cls)) {
+                denseclasses.insert({ cls, (uint32_t)denseclasses.size() });
+                lowclass.push_back(b);
+            }
+
+            bytemap.push_back(denseclasses.at(cls));
+        }
+
+        const size_t nclasses = denseclasses.size();
+        const std::string sidtype = dfa->stateCount() <= UINT16_MAX ? "uint16_t" : "uint32_t";
+
+        std::string code = "    inline constexpr uint8_t " + fname + "_classes[256] = {";
+        for(size_t b = 0; b < bytemap.size(); ++b) {
+            code += std::string(b % 16 == 0 ? "\n        " : " ") + std::to_string(bytemap[b]) + ",";
+        }
+        code += "\n    };\n\n";
+
+        code += "    inline constexpr " + sidtype + " " + fname + "_next[] = {";
+        for(DFAStateID s = 0; s < (DFAStateID)dfa->stateCount(); ++s) {
+            code += "\n       ";
+            for(size_t k = 0; k < nclasses; ++k) {
+                code += " " + std::to_string(dfa->step(s, (RegexChar)lowclass[k])) + ",";
+            }
+        }
+        code += "\n    };\n\n";
+
+        code += "    inline constexpr bool " + fname + "_accepting[] = {";
+        for(DFAStateID s = 0; s < (DFAStateID)dfa->stateCount(); ++s) {
+            code += std::string(s % 16 == 0 ? "\n        " : " ") + (dfa->isAccepting(s) ? "true" : "false") + ",";
+        }
+        code += "\n    };\n\n";
+
+        code += "    inline bool " + fname + "(const uint8_t* str, size_t len)\n    {\n";
+        code += "        uint32_t s = " + std::to_string(dfa->startstate) + ";\n";
+        code += "        for(size_t i = 0; i < len; ++i) {\n";
+        if(check.isFrontCheck || check.isBackCheck) {
+            code += "            if(" + fname + "_accepting[s]) {\n                return true;\n            }\n\n";
+        }
+
+        const std::string cc = check.isBackCheck ? "str[len - 1 - i]" : "str[i]";
+        code += "            s = " + fname + "_next[(s * " + std::to_string(nclasses) + ") + " + fname + "_classes[" + cc + "]];\n";
+        if(dfa->deadstate != -1) {
+            code += "            if(s == " + std::to_string(dfa->deadstate) + ") {\n                return false;\n            }\n";
+        }
+        if(dfa->acceptallstate != -1 && !(check.isFrontCheck || check.isBackCheck)) {
+            code += "            if(s == " + std::to_string(dfa->acceptallstate) + ") {\n                return true;\n            }\n";
+        }
+        code += "        }\n\n";
+        code += "        return " + fname + "_accepting[s];\n";
+
+        return code + "    }\n";
+    }
+
+    RegexCompilerOptions RegexCodeGenerator::codegenOptions()
+    {
+        RegexCompilerOptions options;
+        options.buildDFA = true;
+        options.maxDFAStates = 16384;
+        options.maxUnrollStates = 1024;
+
+        return options;
+    }
+
+    std::string RegexCodeGenerator::toIdentifier(const std::string& name)
+    {
+        std::string ident;
+        for(size_t i = 0; i < name.size(); ++i) {
+            if(name.compare(i, 2, "::") == 0) {
+                ident.push_back('_');
+                i++;
+            }
+            else {
+                ident.push_back(std::isalnum((uint8_t)name[i]) ? name[i] : '_');
+            }
+        }
+
+        if(ident.empty() || std::isdigit((uint8_t)ident[0])) {
+            ident = "_" + ident;
+        }
+
+        return ident;
+    }
+
+    std::string RegexCodeGenerator::toStringLiteral(const std::u8string& str)
+    {
+        //octal escapes are always 3 digits so they cannot run into the next char
+        std::string lit = "\"";
+        for(auto iter = str.cbegin(); iter != str.cend(); ++iter) {
+            const uint8_t c = (uint8_t)*iter;
+            if(c == '"' || c == '\\') {
+                lit += std::string("\\") + (char)c;
+            }
+            else if(32 <= c && c <= 126) {
+                lit.push_back((char)c);
+            }
+            else {
+                lit += std::string("\\") + (char)('0' + ((c >> 6) & 0x7)) + (char)('0' + ((c >> 3) & 0x7)) + (char)('0' + (c & 0x7));
+            }
+        }
+
+        return lit + "\"";
+    }
+
+    void RegexCodeGenerator::addMatcher(const std::string& name, const std::u8string& restr, const std::vector<CodegenCheck>& checks)
+    {
+        const std::string ident = RegexCodeGenerator::toIdentifier(name);
+
+        std::string code;
+        std::string test;
+        for(size_t i = 0; i < checks.size(); ++i) {
+            const std::string fname = ident + "_" + std::to_string(i);
+            if(checks[i].dfa->stateCount() <= RegexCodeGenerator::MAX_SWITCH_STATES) {
+                code += RegexCodeGenerator::emitSwitchCheck(fname, checks[i]) + "\n";
+            }
+            else {
+                code += RegexCodeGenerator::emitTableCheck(fname, checks[i]) + "\n";
+            }
+
+            if(!test.empty()) {
+                test += " && ";
+            }
+            test += (checks[i].isNegative ? "!" : "") + fname + "(bytes, len)";
+        }
+
+        code += "    //" + name + "\n";
+        code += "    inline bool " + ident + "(const char* str, size_t len)\n    {\n";
+        code += "        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(str);\n";
+        code += "        return " + test + ";\n";
+        code += "    }\n";
+
+        this->matchers.push_back(code);
+        this->tableentries.push_back("{ " + RegexCodeGenerator::toStringLiteral(std::u8string(name.cbegin(), name.cend())) + ", " + RegexCodeGenerator::toStringLiteral(restr) + ", &" + ident + " }");
+    }
+
+    std::string RegexCodeGenerator::emit() const
+    {
+        std::string code = "//generated by brexc -- do not edit\n#pragma once\n\n#include <cstddef>\n#include <cstdint>\n\n";
+        code += "namespace " + this->nspace + "\n{\n";
+
+        std::for_each(this->matchers.cbegin(), this->matchers.cend(), [&code](const std::string& mcode) {
+            code += mcode + "\n";
+        });
+
+        code += "    struct Matcher\n    {\n        const char* name;\n        const char* regex;\n        bool (*test)(const char*, size_t);\n    };\n\n";
+        code += "    inline constexpr Matcher matchers[] = {\n";
+        std::for_each(this->tableentries.cbegin(), this->tableentries.cend(), [&code](const std::string& entry) {
+            code += "        " + entry + ",\n";
+        });
+        code += "    };\n}\n";
+
+        return code;
+    }
+}
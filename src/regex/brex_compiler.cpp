@@ -64,16 +64,7 @@ namespace brex
 
     const RegexOpt* RegexResolver::resolveRangeRepeatOpt(const RangeRepeatOpt* opt)
     {
-        if(this->inRangeRepeat) {
-            this->errors.push_back(RegexCompileError(u8"Range repeats cannot be nested"));
-        }
-
-        auto oinRepeat = this->inRangeRepeat;
-        this->inRangeRepeat = true;
-
         auto resolvedRepeat = this->resolve(opt->repeat);
-
-        this->inRangeRepeat = oinRepeat;
         return new RangeRepeatOpt(opt->low, opt->high, resolvedRepeat);
     }
 
@@ -181,6 +172,928 @@ namespace brex
         }
     }
 
+    std::vector<SingleCharRange> RegexUTF8Lowering::normalizeRanges(bool compliment, const std::vector<SingleCharRange>& ranges)
+    {
+        std::vector<SingleCharRange> sorted;
+        std::for_each(ranges.cbegin(), ranges.cend(), [&sorted](const SingleCharRange& rr) {
+            if(rr.low <= rr.high && rr.low <= RegexUTF8Lowering::MAX_SCALAR_VALUE) {
+                sorted.push_back({ rr.low, std::min(rr.high, RegexUTF8Lowering::MAX_SCALAR_VALUE) });
+            }
+        });
+
+        std::sort(sorted.begin(), sorted.end(), [](const SingleCharRange& r1, const SingleCharRange& r2) {
+            return r1.low < r2.low;
+        });
+
+        std::vector<SingleCharRange> merged;
+        for(auto ii = sorted.cbegin(); ii != sorted.cend(); ++ii) {
+            if(!merged.empty() && ii->low <= merged.back().high + 1) {
+                merged.back().high = std::max(merged.back().high, ii->high);
+            }
+            else {
+                merged.push_back(*ii);
+            }
+        }
+
+        if(compliment) {
+            std::vector<SingleCharRange> cranges;
+            RegexChar next = 0;
+            bool done = false;
+            for(auto ii = merged.cbegin(); ii != merged.cend(); ++ii) {
+                if(next < ii->low) {
+                    cranges.push_back({ next, ii->low - 1 });
+                }
+
+                done = (ii->high == RegexUTF8Lowering::MAX_SCALAR_VALUE);
+                next = ii->high + 1;
+            }
+
+            if(!done) {
+                cranges.push_back({ next, RegexUTF8Lowering::MAX_SCALAR_VALUE });
+            }
+
+            merged = std::move(cranges);
+        }
+
+        //surrogates are not valid scalar values so they never appear in utf8
+        std::vector<SingleCharRange> valid;
+        std::for_each(merged.cbegin(), merged.cend(), [&valid](const SingleCharRange& rr) {
+            if(rr.low < RegexUTF8Lowering::SURROGATE_LOW) {
+                valid.push_back({ rr.low, std::min(rr.high, RegexUTF8Lowering::SURROGATE_LOW - 1) });
+            }
+            if(rr.high > RegexUTF8Lowering::SURROGATE_HIGH) {
+                valid.push_back({ std::max(rr.low, RegexUTF8Lowering::SURROGATE_HIGH + 1), rr.high });
+            }
+        });
+
+        return valid;
+    }
+
+    void RegexUTF8Lowering::appendUTF8Sequences(RegexChar low, RegexChar high, std::vector<std::vector<SingleCharRange>>& seqs)
+    {
+        std::vector<SingleCharRange> pending = { { low, high } };
+        while(!pending.empty()) {
+            RegexChar s = pending.back().low;
+            RegexChar e = pending.back().high;
+            pending.pop_back();
+
+            bool split = true;
+            while(split) {
+                split = false;
+
+                //split on the boundaries of the encoding lengths
+                const RegexChar lengthbounds[] = { 0x7F, 0x7FF, 0xFFFF };
+                for(size_t i = 0; i < 3 && !split; ++i) {
+                    if(s <= lengthbounds[i] && lengthbounds[i] < e) {
+                        pending.push_back({ lengthbounds[i] + 1, e });
+                        e = lengthbounds[i];
+                        split = true;
+                    }
+                }
+
+                if(split) {
+                    continue;
+                }
+
+                if(e <= 0x7F) {
+                    seqs.push_back({ { s, e } });
+                    break;
+                }
+
+                //split until each continuation byte position covers either its full range or a single value
+                for(size_t i = 1; i < 4 && !split; ++i) {
+                    const RegexChar m = (1 << (6 * i)) - 1;
+                    if((s & ~m) != (e & ~m)) {
+                        if((s & m) != 0) {
+                            pending.push_back({ (s | m) + 1, e });
+                            e = s | m;
+                            split = true;
+                        }
+                        else if((e & m) != m) {
+                            pending.push_back({ e & ~m, e });
+                            e = (e & ~m) - 1;
+                            split = true;
+                        }
+                        else {
+                            ;
+                        }
+                    }
+                }
+
+                if(!split) {
+                    auto sbytes = extractRegexCharToBytes(s);
+                    auto ebytes = extractRegexCharToBytes(e);
+                    BREX_ASSERT(sbytes.size() == ebytes.size(), "Mismatched utf8 lengths");
+
+                    std::vector<SingleCharRange> seq;
+                    for(size_t i = 0; i < sbytes.size(); ++i) {
+                        seq.push_back({ sbytes[i], ebytes[i] });
+                    }
+                    seqs.push_back(seq);
+                }
+            }
+        }
+    }
+
+    const RegexOpt* RegexUTF8Lowering::lowerRanges(const std::vector<SingleCharRange>& ranges)
+    {
+        std::vector<std::vector<SingleCharRange>> seqs;
+        std::for_each(ranges.cbegin(), ranges.cend(), [&seqs](const SingleCharRange& rr) {
+            RegexUTF8Lowering::appendUTF8Sequences(rr.low, rr.high, seqs);
+        });
+
+        //all the single byte sequences go into one range and the rest are alternatives of byte range sequences
+        std::vector<SingleCharRange> singlebytes;
+        std::vector<const RegexOpt*> opts;
+        for(auto ii = seqs.cbegin(); ii != seqs.cend(); ++ii) {
+            if(ii->size() == 1) {
+                singlebytes.push_back(ii->front());
+            }
+            else {
+                std::vector<const RegexOpt*> seq;
+                std::transform(ii->cbegin(), ii->cend(), std::back_inserter(seq), [](const SingleCharRange& rr) -> const RegexOpt* {
+                    if(rr.low == rr.high) {
+                        return new LiteralOpt({ rr.low }, false);
+                    }
+                    else {
+                        return new CharRangeOpt(false, { rr }, false);
+                    }
+                });
+                opts.push_back(new SequenceOpt(seq));
+            }
+        }
+
+        if(!singlebytes.empty() || opts.empty()) {
+            opts.insert(opts.begin(), new CharRangeOpt(false, singlebytes, false));
+        }
+
+        return opts.size() == 1 ? opts.front() : new AnyOfOpt(opts);
+    }
+
+    const RegexOpt* RegexUTF8Lowering::lowerLiteralOpt(const LiteralOpt* opt)
+    {
+        std::vector<RegexChar> bytes;
+        std::for_each(opt->codes.cbegin(), opt->codes.cend(), [&bytes](RegexChar c) {
+            auto cbytes = extractRegexCharToBytes(c);
+            std::copy(cbytes.cbegin(), cbytes.cend(), std::back_inserter(bytes));
+        });
+
+        return new LiteralOpt(bytes, false);
+    }
+
+    const RegexOpt* RegexUTF8Lowering::lowerCharRangeOpt(const CharRangeOpt* opt)
+    {
+        return RegexUTF8Lowering::lowerRanges(RegexUTF8Lowering::normalizeRanges(opt->compliment, opt->ranges));
+    }
+
+    const RegexOpt* RegexUTF8Lowering::lower(const RegexOpt* opt)
+    {
+        switch(opt->tag)
+        {
+        case RegexOptTag::Literal: {
+            return RegexUTF8Lowering::lowerLiteralOpt(static_cast<const LiteralOpt*>(opt));
+        }
+        case RegexOptTag::CharRange: {
+            return RegexUTF8Lowering::lowerCharRangeOpt(static_cast<const CharRangeOpt*>(opt));
+        }
+        case RegexOptTag::CharClassDot: {
+            return RegexUTF8Lowering::lowerRanges(RegexUTF8Lowering::normalizeRanges(true, {}));
+        }
+        case RegexOptTag::StarRepeat: {
+            return new StarRepeatOpt(RegexUTF8Lowering::lower(static_cast<const StarRepeatOpt*>(opt)->repeat));
+        }
+        case RegexOptTag::PlusRepeat: {
+            return new PlusRepeatOpt(RegexUTF8Lowering::lower(static_cast<const PlusRepeatOpt*>(opt)->repeat));
+        }
+        case RegexOptTag::RangeRepeat: {
+            auto rangeopt = static_cast<const RangeRepeatOpt*>(opt);
+            return new RangeRepeatOpt(rangeopt->low, rangeopt->high, RegexUTF8Lowering::lower(rangeopt->repeat));
+        }
+        case RegexOptTag::Optional: {
+            return new OptionalOpt(RegexUTF8Lowering::lower(static_cast<const OptionalOpt*>(opt)->opt));
+        }
+        case RegexOptTag::AnyOf: {
+            auto anyofopt = static_cast<const AnyOfOpt*>(opt);
+            std::vector<const RegexOpt*> opts;
+            std::transform(anyofopt->opts.cbegin(), anyofopt->opts.cend(), std::back_inserter(opts), [](const RegexOpt* aopt) {
+                return RegexUTF8Lowering::lower(aopt);
+            });
+
+            return new AnyOfOpt(opts);
+        }
+        case RegexOptTag::Sequence: {
+            auto seqopt = static_cast<const SequenceOpt*>(opt);
+            std::vector<const RegexOpt*> seq;
+            std::transform(seqopt->regexs.cbegin(), seqopt->regexs.cend(), std::back_inserter(seq), [](const RegexOpt* sopt) {
+                return RegexUTF8Lowering::lower(sopt);
+            });
+
+            return new SequenceOpt(seq);
+        }
+        default: {
+            //named and env regexes are gone after resolution
+            return opt;
+        }
+        }
+    }
+
+    size_t RegexRangeUnrolling::stateCost(const RegexOpt* opt)
+    {
+        switch(opt->tag)
+        {
+        case RegexOptTag::Literal: {
+            return static_cast<const LiteralOpt*>(opt)->codes.size();
+        }
+        case RegexOptTag::CharRange:
+        case RegexOptTag::CharClassDot: {
+            return 1;
+        }
+        case RegexOptTag::StarRepeat: {
+            return 1 + RegexRangeUnrolling::stateCost(static_cast<const StarRepeatOpt*>(opt)->repeat);
+        }
+        case RegexOptTag::PlusRepeat: {
+            return 1 + RegexRangeUnrolling::stateCost(static_cast<const PlusRepeatOpt*>(opt)->repeat);
+        }
+        case RegexOptTag::RangeRepeat: {
+            return 1 + RegexRangeUnrolling::stateCost(static_cast<const RangeRepeatOpt*>(opt)->repeat);
+        }
+        case RegexOptTag::Optional: {
+            return 1 + RegexRangeUnrolling::stateCost(static_cast<const OptionalOpt*>(opt)->opt);
+        }
+        case RegexOptTag::AnyOf: {
+            auto anyofopt = static_cast<const AnyOfOpt*>(opt);
+            return std::accumulate(anyofopt->opts.cbegin(), anyofopt->opts.cend(), (size_t)1, [](size_t acc, const RegexOpt* aopt) {
+                return acc + RegexRangeUnrolling::stateCost(aopt);
+            });
+        }
+        case RegexOptTag::Sequence: {
+            auto seqopt = static_cast<const SequenceOpt*>(opt);
+            return std::accumulate(seqopt->regexs.cbegin(), seqopt->regexs.cend(), (size_t)0, [](size_t acc, const RegexOpt* sopt) {
+                return acc + RegexRangeUnrolling::stateCost(sopt);
+            });
+        }
+        default: {
+            return 1;
+        }
+        }
+    }
+
+    const RegexOpt* RegexRangeUnrolling::unrollRangeRepeatOpt(const RangeRepeatOpt* opt, size_t maxstates)
+    {
+        auto repeat = RegexRangeUnrolling::unroll(opt->repeat, maxstates);
+
+        //the body is copied low times and then either a star or (high - low) nested optionals -- r{2,4} is r r (r r?)?
+        const bool unbounded = (opt->high == INT16_MAX || opt->high == UINT16_MAX);
+        const size_t optcount = unbounded ? 1 : (size_t)(opt->high - opt->low);
+
+        const size_t bodycost = RegexRangeUnrolling::stateCost(repeat);
+        if((opt->low * bodycost) + (optcount * (bodycost + 1)) > maxstates) {
+            return new RangeRepeatOpt(opt->low, opt->high, repeat);
+        }
+
+        std::vector<const RegexOpt*> seq(opt->low, repeat);
+        if(unbounded) {
+            seq.push_back(new StarRepeatOpt(repeat));
+        }
+        else if(optcount != 0) {
+            const RegexOpt* tail = new OptionalOpt(repeat);
+            for(size_t i = 1; i < optcount; ++i) {
+                tail = new OptionalOpt(new SequenceOpt({ repeat, tail }));
+            }
+            seq.push_back(tail);
+        }
+
+        return seq.size() == 1 ? seq.front() : new SequenceOpt(seq);
+    }
+
+    const RegexOpt* RegexRangeUnrolling::unroll(const RegexOpt* opt, size_t maxstates)
+    {
+        switch(opt->tag)
+        {
+        case RegexOptTag::StarRepeat: {
+            return new StarRepeatOpt(RegexRangeUnrolling::unroll(static_cast<const StarRepeatOpt*>(opt)->repeat, maxstates));
+        }
+        case RegexOptTag::PlusRepeat: {
+            return new PlusRepeatOpt(RegexRangeUnrolling::unroll(static_cast<const PlusRepeatOpt*>(opt)->repeat, maxstates));
+        }
+        case RegexOptTag::RangeRepeat: {
+            return RegexRangeUnrolling::unrollRangeRepeatOpt(static_cast<const RangeRepeatOpt*>(opt), maxstates);
+        }
+        case RegexOptTag::Optional: {
+            return new OptionalOpt(RegexRangeUnrolling::unroll(static_cast<const OptionalOpt*>(opt)->opt, maxstates));
+        }
+        case RegexOptTag::AnyOf: {
+            auto anyofopt = static_cast<const AnyOfOpt*>(opt);
+            std::vector<const RegexOpt*> opts;
+            std::transform(anyofopt->opts.cbegin(), anyofopt->opts.cend(), std::back_inserter(opts), [maxstates](const RegexOpt* aopt) {
+                return RegexRangeUnrolling::unroll(aopt, maxstates);
+            });
+
+            return new AnyOfOpt(opts);
+        }
+        case RegexOptTag::Sequence: {
+            auto seqopt = static_cast<const SequenceOpt*>(opt);
+            std::vector<const RegexOpt*> seq;
+            std::transform(seqopt->regexs.cbegin(), seqopt->regexs.cend(), std::back_inserter(seq), [maxstates](const RegexOpt* sopt) {
+                return RegexRangeUnrolling::unroll(sopt, maxstates);
+            });
+
+            return new SequenceOpt(seq);
+        }
+        default: {
+            //no ranges in the leaves
+            return opt;
+        }
+        }
+    }
+
+    static const std::vector<RegexChar>& longerLiteral(const std::vector<RegexChar>& l1, const std::vector<RegexChar>& l2)
+    {
+        return l1.size() >= l2.size() ? l1 : l2;
+    }
+
+    std::string RegexSimplifier::structureKey(const RegexOpt* opt)
+    {
+        switch(opt->tag)
+        {
+        case RegexOptTag::Literal: {
+            auto litopt = static_cast<const LiteralOpt*>(opt);
+            return std::accumulate(litopt->codes.cbegin(), litopt->codes.cend(), std::string{"L"}, [](const std::string& acc, RegexChar c) {
+                return acc + std::to_string(c) + ",";
+            });
+        }
+        case RegexOptTag::CharRange: {
+            auto rangeopt = static_cast<const CharRangeOpt*>(opt);
+            return std::accumulate(rangeopt->ranges.cbegin(), rangeopt->ranges.cend(), std::string{rangeopt->compliment ? "R^" : "R"}, [](const std::string& acc, const SingleCharRange& rr) {
+                return acc + std::to_string(rr.low) + "-" + std::to_string(rr.high) + ",";
+            });
+        }
+        case RegexOptTag::CharClassDot: {
+            return ".";
+        }
+        case RegexOptTag::StarRepeat: {
+            return "*(" + RegexSimplifier::structureKey(static_cast<const StarRepeatOpt*>(opt)->repeat) + ")";
+        }
+        case RegexOptTag::PlusRepeat: {
+            return "+(" + RegexSimplifier::structureKey(static_cast<const PlusRepeatOpt*>(opt)->repeat) + ")";
+        }
+        case RegexOptTag::RangeRepeat: {
+            auto rangeopt = static_cast<const RangeRepeatOpt*>(opt);
+            return "{" + std::to_string(rangeopt->low) + "," + std::to_string(rangeopt->high) + "}(" + RegexSimplifier::structureKey(rangeopt->repeat) + ")";
+        }
+        case RegexOptTag::Optional: {
+            return "?(" + RegexSimplifier::structureKey(static_cast<const OptionalOpt*>(opt)->opt) + ")";
+        }
+        case RegexOptTag::AnyOf: {
+            auto anyofopt = static_cast<const AnyOfOpt*>(opt);
+            return std::accumulate(anyofopt->opts.cbegin(), anyofopt->opts.cend(), std::string{"|("}, [](const std::string& acc, const RegexOpt* aopt) {
+                return acc + RegexSimplifier::structureKey(aopt) + ";";
+            }) + ")";
+        }
+        case RegexOptTag::Sequence: {
+            auto seqopt = static_cast<const SequenceOpt*>(opt);
+            return std::accumulate(seqopt->regexs.cbegin(), seqopt->regexs.cend(), std::string{"&("}, [](const std::string& acc, const RegexOpt* sopt) {
+                return acc + RegexSimplifier::structureKey(sopt) + ";";
+            }) + ")";
+        }
+        default: {
+            //named and env regexes are gone after resolution so these are only equal to themselves
+            return "@" + std::to_string(reinterpret_cast<uintptr_t>(opt));
+        }
+        }
+    }
+
+    bool RegexSimplifier::isEmptyOpt(const RegexOpt* opt)
+    {
+        if(opt->tag == RegexOptTag::Literal) {
+            return static_cast<const LiteralOpt*>(opt)->codes.empty();
+        }
+        else if(opt->tag == RegexOptTag::Sequence) {
+            return static_cast<const SequenceOpt*>(opt)->regexs.empty();
+        }
+        else {
+            return false;
+        }
+    }
+
+    bool RegexSimplifier::isSingleCharOpt(const RegexOpt* opt)
+    {
+        if(opt->tag == RegexOptTag::Literal) {
+            return static_cast<const LiteralOpt*>(opt)->codes.size() == 1;
+        }
+        else if(opt->tag == RegexOptTag::CharRange) {
+            return !static_cast<const CharRangeOpt*>(opt)->compliment;
+        }
+        else {
+            return false;
+        }
+    }
+
+    void RegexSimplifier::appendAtoms(const RegexOpt* opt, std::vector<const RegexOpt*>& atoms)
+    {
+        if(opt->tag == RegexOptTag::Sequence) {
+            auto seqopt = static_cast<const SequenceOpt*>(opt);
+            std::for_each(seqopt->regexs.cbegin(), seqopt->regexs.cend(), [&atoms](const RegexOpt* sopt) {
+                RegexSimplifier::appendAtoms(sopt, atoms);
+            });
+        }
+        else if(opt->tag == RegexOptTag::Literal) {
+            auto litopt = static_cast<const LiteralOpt*>(opt);
+            std::transform(litopt->codes.cbegin(), litopt->codes.cend(), std::back_inserter(atoms), [litopt](RegexChar c) {
+                return new LiteralOpt({ c }, litopt->isunicode);
+            });
+        }
+        else {
+            atoms.push_back(opt);
+        }
+    }
+
+    const RegexOpt* RegexSimplifier::fromAtoms(std::vector<const RegexOpt*>::const_iterator begin, std::vector<const RegexOpt*>::const_iterator end)
+    {
+        return RegexSimplifier::makeSequence(std::vector<const RegexOpt*>(begin, end));
+    }
+
+    const RegexOpt* RegexSimplifier::makeSequence(const std::vector<const RegexOpt*>& regexs)
+    {
+        //flatten nested sequences and join adjacent literals
+        std::vector<const RegexOpt*> seq;
+        for(auto iter = regexs.cbegin(); iter != regexs.cend(); ++iter) {
+            const RegexOpt* sopt = *iter;
+            if(RegexSimplifier::isEmptyOpt(sopt)) {
+                continue;
+            }
+
+            if(sopt->tag == RegexOptTag::Sequence) {
+                auto inner = static_cast<const SequenceOpt*>(sopt);
+                auto flat = RegexSimplifier::makeSequence(inner->regexs);
+                if(flat->tag == RegexOptTag::Sequence) {
+                    auto fseq = static_cast<const SequenceOpt*>(flat);
+                    std::copy(fseq->regexs.cbegin(), fseq->regexs.cend(), std::back_inserter(seq));
+                }
+                else {
+                    seq.push_back(flat);
+                }
+                continue;
+            }
+
+            if(sopt->tag == RegexOptTag::Literal && !seq.empty() && seq.back()->tag == RegexOptTag::Literal) {
+                auto prev = static_cast<const LiteralOpt*>(seq.back());
+                auto curr = static_cast<const LiteralOpt*>(sopt);
+
+                std::vector<RegexChar> codes = prev->codes;
+                std::copy(curr->codes.cbegin(), curr->codes.cend(), std::back_inserter(codes));
+                seq.back() = new LiteralOpt(codes, prev->isunicode);
+                continue;
+            }
+
+            seq.push_back(sopt);
+        }
+
+        if(seq.size() == 1) {
+            return seq.front();
+        }
+
+        return new SequenceOpt(seq);
+    }
+
+    const RegexOpt* RegexSimplifier::makeOptional(const RegexOpt* opt)
+    {
+        //r*? and r?? are r* and r? -- r+? is r*
+        if(RegexSimplifier::isEmptyOpt(opt) || opt->tag == RegexOptTag::StarRepeat || opt->tag == RegexOptTag::Optional) {
+            return opt;
+        }
+        else if(opt->tag == RegexOptTag::PlusRepeat) {
+            return new StarRepeatOpt(static_cast<const PlusRepeatOpt*>(opt)->repeat);
+        }
+        else {
+            return new OptionalOpt(opt);
+        }
+    }
+
+    const RegexOpt* RegexSimplifier::makeAnyOf(const std::vector<const RegexOpt*>& opts)
+    {
+        //flatten nested alternations and pull out the empty alternatives (an optional alternative is its body and the empty string)
+        bool hasempty = false;
+        std::set<std::string> seen;
+        std::vector<std::vector<const RegexOpt*>> alts;
+
+        std::vector<const RegexOpt*> work(opts.crbegin(), opts.crend());
+        while(!work.empty()) {
+            const RegexOpt* aopt = work.back();
+            work.pop_back();
+
+            if(aopt->tag == RegexOptTag::AnyOf) {
+                auto inner = static_cast<const AnyOfOpt*>(aopt);
+                std::copy(inner->opts.crbegin(), inner->opts.crend(), std::back_inserter(work));
+            }
+            else if(aopt->tag == RegexOptTag::Optional) {
+                hasempty = true;
+                work.push_back(static_cast<const OptionalOpt*>(aopt)->opt);
+            }
+            else if(RegexSimplifier::isEmptyOpt(aopt)) {
+                hasempty = true;
+            }
+            else if(seen.insert(RegexSimplifier::structureKey(aopt)).second) {
+                std::vector<const RegexOpt*> atoms;
+                RegexSimplifier::appendAtoms(aopt, atoms);
+                alts.push_back(atoms);
+            }
+        }
+
+        if(alts.empty()) {
+            return new SequenceOpt({});
+        }
+
+        alts = RegexSimplifier::factorAlternatives(alts, true);
+        alts = RegexSimplifier::factorAlternatives(alts, false);
+
+        std::vector<const RegexOpt*> rebuilt;
+        std::transform(alts.cbegin(), alts.cend(), std::back_inserter(rebuilt), [](const std::vector<const RegexOpt*>& atoms) {
+            return RegexSimplifier::fromAtoms(atoms.cbegin(), atoms.cend());
+        });
+
+        auto anyofopt = RegexSimplifier::mergeSingleChars(rebuilt);
+        return hasempty ? RegexSimplifier::makeOptional(anyofopt) : anyofopt;
+    }
+
+    std::vector<std::vector<const RegexOpt*>> RegexSimplifier::factorAlternatives(const std::vector<std::vector<const RegexOpt*>>& alts, bool prefix)
+    {
+        //group the alternatives on their first (last) atom and pull the atoms the group shares out in front of (after) an alternation of the rest -- "abc" | "abd" is "ab" ("c" | "d")
+        std::vector<std::string> keys;
+        std::transform(alts.cbegin(), alts.cend(), std::back_inserter(keys), [prefix](const std::vector<const RegexOpt*>& atoms) {
+            return RegexSimplifier::structureKey(prefix ? atoms.front() : atoms.back());
+        });
+
+        std::vector<std::vector<const RegexOpt*>> factored;
+        std::vector<bool> used(alts.size(), false);
+        for(size_t i = 0; i < alts.size(); ++i) {
+            if(used[i]) {
+                continue;
+            }
+
+            std::vector<size_t> group;
+            for(size_t j = i; j < alts.size(); ++j) {
+                if(!used[j] && keys[j] == keys[i]) {
+                    group.push_back(j);
+                    used[j] = true;
+                }
+            }
+
+            if(group.size() == 1) {
+                factored.push_back(alts[i]);
+                continue;
+            }
+
+            auto atomAt = [&alts, prefix](size_t aidx, size_t pos) {
+                return prefix ? alts[aidx][pos] : alts[aidx][alts[aidx].size() - 1 - pos];
+            };
+
+            const size_t minlen = std::accumulate(group.cbegin(), group.cend(), alts[i].size(), [&alts](size_t acc, size_t gidx) {
+                return std::min(acc, alts[gidx].size());
+            });
+
+            size_t common = 1;
+            while(common < minlen) {
+                const std::string ckey = RegexSimplifier::structureKey(atomAt(i, common));
+                const bool same = std::all_of(group.cbegin(), group.cend(), [&atomAt, &ckey, common](size_t gidx) {
+                    return RegexSimplifier::structureKey(atomAt(gidx, common)) == ckey;
+                });
+
+                if(!same) {
+                    break;
+                }
+                common++;
+            }
+
+            std::vector<const RegexOpt*> rests;
+            std::transform(group.cbegin(), group.cend(), std::back_inserter(rests), [&alts, prefix, common](size_t gidx) {
+                const std::vector<const RegexOpt*>& atoms = alts[gidx];
+                return prefix ? RegexSimplifier::fromAtoms(atoms.cbegin() + common, atoms.cend()) : RegexSimplifier::fromAtoms(atoms.cbegin(), atoms.cend() - common);
+            });
+            const RegexOpt* rest = RegexSimplifier::makeAnyOf(rests);
+
+            std::vector<const RegexOpt*> atoms;
+            if(prefix) {
+                std::copy(alts[i].cbegin(), alts[i].cbegin() + common, std::back_inserter(atoms));
+                RegexSimplifier::appendAtoms(rest, atoms);
+            }
+            else {
+                RegexSimplifier::appendAtoms(rest, atoms);
+                std::copy(alts[i].cend() - common, alts[i].cend(), std::back_inserter(atoms));
+            }
+            factored.push_back(atoms);
+        }
+
+        return factored;
+    }
+
+    const RegexOpt* RegexSimplifier::mergeSingleChars(const std::vector<const RegexOpt*>& opts)
+    {
+        //the single char alternatives are one char range -- "a" | [c-e] | "b" is [a-e]
+        std::vector<const RegexOpt*> merged;
+        std::vector<SingleCharRange> ranges;
+        const RegexOpt* firstsingle = nullptr;
+        size_t singlecount = 0;
+        for(auto iter = opts.cbegin(); iter != opts.cend(); ++iter) {
+            const RegexOpt* aopt = *iter;
+            if(!RegexSimplifier::isSingleCharOpt(aopt)) {
+                merged.push_back(aopt);
+                continue;
+            }
+
+            if(singlecount == 0) {
+                merged.push_back(nullptr); //where the range goes
+                firstsingle = aopt;
+            }
+            singlecount++;
+
+            if(aopt->tag == RegexOptTag::Literal) {
+                const RegexChar c = static_cast<const LiteralOpt*>(aopt)->codes.front();
+                ranges.push_back({ c, c });
+            }
+            else {
+                auto rangeopt = static_cast<const CharRangeOpt*>(aopt);
+                std::copy(rangeopt->ranges.cbegin(), rangeopt->ranges.cend(), std::back_inserter(ranges));
+            }
+        }
+
+        if(singlecount == 1) {
+            std::replace(merged.begin(), merged.end(), (const RegexOpt*)nullptr, firstsingle);
+        }
+        else if(singlecount > 1) {
+            const bool isunicode = (firstsingle->tag == RegexOptTag::Literal) ? static_cast<const LiteralOpt*>(firstsingle)->isunicode : static_cast<const CharRangeOpt*>(firstsingle)->isunicode;
+
+            std::sort(ranges.begin(), ranges.end(), [](const SingleCharRange& a, const SingleCharRange& b) {
+                return a.low < b.low;
+            });
+
+            std::vector<SingleCharRange> joined;
+            for(auto iter = ranges.cbegin(); iter != ranges.cend(); ++iter) {
+                if(!joined.empty() && iter->low <= joined.back().high + 1) {
+                    joined.back().high = std::max(joined.back().high, iter->high);
+                }
+                else {
+                    joined.push_back(*iter);
+                }
+            }
+
+            const RegexOpt* rangeopt = nullptr;
+            if(joined.size() == 1 && joined.front().low == joined.front().high) {
+                rangeopt = new LiteralOpt({ joined.front().low }, isunicode);
+            }
+            else {
+                rangeopt = new CharRangeOpt(false, joined, isunicode);
+            }
+            std::replace(merged.begin(), merged.end(), (const RegexOpt*)nullptr, rangeopt);
+        }
+
+        if(merged.size() == 1) {
+            return merged.front();
+        }
+
+        return new AnyOfOpt(merged);
+    }
+
+    const RegexOpt* RegexSimplifier::simplifyStarRepeatOpt(const StarRepeatOpt* opt)
+    {
+        //r** and r+* and r?* are all r*
+        auto repeat = RegexSimplifier::simplify(opt->repeat);
+        if(RegexSimplifier::isEmptyOpt(repeat) || repeat->tag == RegexOptTag::StarRepeat) {
+            return repeat;
+        }
+        else if(repeat->tag == RegexOptTag::PlusRepeat) {
+            return new StarRepeatOpt(static_cast<const PlusRepeatOpt*>(repeat)->repeat);
+        }
+        else if(repeat->tag == RegexOptTag::Optional) {
+            return new StarRepeatOpt(static_cast<const OptionalOpt*>(repeat)->opt);
+        }
+        else {
+            return new StarRepeatOpt(repeat);
+        }
+    }
+
+    const RegexOpt* RegexSimplifier::simplifyPlusRepeatOpt(const PlusRepeatOpt* opt)
+    {
+        //r*+ is r* and r++ is r+ -- r?+ is r*
+        auto repeat = RegexSimplifier::simplify(opt->repeat);
+        if(RegexSimplifier::isEmptyOpt(repeat) || repeat->tag == RegexOptTag::StarRepeat || repeat->tag == RegexOptTag::PlusRepeat) {
+            return repeat;
+        }
+        else if(repeat->tag == RegexOptTag::Optional) {
+            return new StarRepeatOpt(static_cast<const OptionalOpt*>(repeat)->opt);
+        }
+        else {
+            return new PlusRepeatOpt(repeat);
+        }
+    }
+
+    const RegexOpt* RegexSimplifier::simplifyRangeRepeatOpt(const RangeRepeatOpt* opt)
+    {
+        auto repeat = RegexSimplifier::simplify(opt->repeat);
+        if(RegexSimplifier::isEmptyOpt(repeat) || (opt->low == 1 && opt->high == 1)) {
+            return repeat;
+        }
+        else if(opt->low == 0 && opt->high == 0) {
+            return new SequenceOpt({});
+        }
+        else {
+            return new RangeRepeatOpt(opt->low, opt->high, repeat);
+        }
+    }
+
+    const RegexOpt* RegexSimplifier::simplify(const RegexOpt* opt)
+    {
+        switch(opt->tag)
+        {
+        case RegexOptTag::StarRepeat: {
+            return RegexSimplifier::simplifyStarRepeatOpt(static_cast<const StarRepeatOpt*>(opt));
+        }
+        case RegexOptTag::PlusRepeat: {
+            return RegexSimplifier::simplifyPlusRepeatOpt(static_cast<const PlusRepeatOpt*>(opt));
+        }
+        case RegexOptTag::RangeRepeat: {
+            return RegexSimplifier::simplifyRangeRepeatOpt(static_cast<const RangeRepeatOpt*>(opt));
+        }
+        case RegexOptTag::Optional: {
+            return RegexSimplifier::makeOptional(RegexSimplifier::simplify(static_cast<const OptionalOpt*>(opt)->opt));
+        }
+        case RegexOptTag::AnyOf: {
+            auto anyofopt = static_cast<const AnyOfOpt*>(opt);
+            std::vector<const RegexOpt*> opts;
+            std::transform(anyofopt->opts.cbegin(), anyofopt->opts.cend(), std::back_inserter(opts), [](const RegexOpt* aopt) {
+                return RegexSimplifier::simplify(aopt);
+            });
+
+            return RegexSimplifier::makeAnyOf(opts);
+        }
+        case RegexOptTag::Sequence: {
+            auto seqopt = static_cast<const SequenceOpt*>(opt);
+            std::vector<const RegexOpt*> seq;
+            std::transform(seqopt->regexs.cbegin(), seqopt->regexs.cend(), std::back_inserter(seq), [](const RegexOpt* sopt) {
+                return RegexSimplifier::simplify(sopt);
+            });
+
+            return RegexSimplifier::makeSequence(seq);
+        }
+        default: {
+            //literals, char ranges, and dot are already as small as they get
+            return opt;
+        }
+        }
+    }
+
+    RegexLiteralFactors::FactorInfo RegexLiteralFactors::computeInfo(const RegexOpt* opt)
+    {
+        FactorInfo info;
+        switch(opt->tag)
+        {
+        case RegexOptTag::Literal: {
+            auto codes = static_cast<const LiteralOpt*>(opt)->codes;
+            info.exact = codes;
+            info.prefix = codes;
+            info.suffix = codes;
+            info.factor = codes;
+            break;
+        }
+        case RegexOptTag::CharRange: {
+            auto rangeopt = static_cast<const CharRangeOpt*>(opt);
+            if(!rangeopt->compliment && rangeopt->ranges.size() == 1 && rangeopt->ranges[0].low == rangeopt->ranges[0].high) {
+                const std::vector<RegexChar> codes = { rangeopt->ranges[0].low };
+                info.exact = codes;
+                info.prefix = codes;
+                info.suffix = codes;
+                info.factor = codes;
+            }
+            break;
+        }
+        case RegexOptTag::PlusRepeat: {
+            //at least one copy so anything the body has to have the repeat has to have too
+            auto rinfo = RegexLiteralFactors::computeInfo(static_cast<const PlusRepeatOpt*>(opt)->repeat);
+            info.prefix = rinfo.prefix;
+            info.suffix = rinfo.suffix;
+            info.factor = rinfo.factor;
+            break;
+        }
+        case RegexOptTag::RangeRepeat: {
+            auto rangeopt = static_cast<const RangeRepeatOpt*>(opt);
+            if(rangeopt->low == 0) {
+                break;
+            }
+
+            auto rinfo = RegexLiteralFactors::computeInfo(rangeopt->repeat);
+            if(rinfo.exact.has_value() && (rangeopt->low * rinfo.exact.value().size()) <= MAX_EXACT_LENGTH) {
+                //every match is at least low copies of the string back to back
+                std::vector<RegexChar> lowcopies;
+                for(size_t i = 0; i < rangeopt->low; ++i) {
+                    std::copy(rinfo.exact.value().cbegin(), rinfo.exact.value().cend(), std::back_inserter(lowcopies));
+                }
+
+                if(rangeopt->low == rangeopt->high) {
+                    info.exact = lowcopies;
+                }
+                info.prefix = lowcopies;
+                info.suffix = lowcopies;
+                info.factor = lowcopies;
+            }
+            else {
+                info.prefix = rinfo.prefix;
+                info.suffix = rinfo.suffix;
+                info.factor = rinfo.factor;
+            }
+            break;
+        }
+        case RegexOptTag::AnyOf: {
+            //only what all the options start/end with is known (and the longer of those is contained in every match)
+            auto anyofopt = static_cast<const AnyOfOpt*>(opt);
+
+            std::vector<FactorInfo> ainfos;
+            std::transform(anyofopt->opts.cbegin(), anyofopt->opts.cend(), std::back_inserter(ainfos), [](const RegexOpt* aopt) {
+                return RegexLiteralFactors::computeInfo(aopt);
+            });
+
+            info.prefix = ainfos.front().prefix;
+            info.suffix = ainfos.front().suffix;
+            std::for_each(ainfos.cbegin() + 1, ainfos.cend(), [&info](const FactorInfo& ainfo) {
+                auto pmm = std::mismatch(info.prefix.cbegin(), info.prefix.cend(), ainfo.prefix.cbegin(), ainfo.prefix.cend());
+                info.prefix.erase(pmm.first, info.prefix.cend());
+
+                auto smm = std::mismatch(info.suffix.crbegin(), info.suffix.crend(), ainfo.suffix.crbegin(), ainfo.suffix.crend());
+                info.suffix.erase(info.suffix.cbegin(), smm.first.base());
+            });
+
+            info.factor = longerLiteral(info.prefix, info.suffix);
+            break;
+        }
+        case RegexOptTag::Sequence: {
+            //run is the literal that ends at the current point of the sequence -- it is broken by any component that is not an exact string
+            auto seqopt = static_cast<const SequenceOpt*>(opt);
+
+            std::vector<RegexChar> run;
+            bool allexact = true;
+            for(auto iter = seqopt->regexs.cbegin(); iter != seqopt->regexs.cend(); ++iter) {
+                auto sinfo = RegexLiteralFactors::computeInfo(*iter);
+                if(sinfo.exact.has_value()) {
+                    std::copy(sinfo.exact.value().cbegin(), sinfo.exact.value().cend(), std::back_inserter(run));
+                }
+                else {
+                    std::copy(sinfo.prefix.cbegin(), sinfo.prefix.cend(), std::back_inserter(run));
+                    if(allexact) {
+                        info.prefix = run;
+                        allexact = false;
+                    }
+
+                    info.factor = longerLiteral(longerLiteral(info.factor, run), sinfo.factor);
+                    run = sinfo.suffix;
+                }
+            }
+
+            if(allexact) {
+                info.exact = run;
+                info.prefix = run;
+            }
+            info.suffix = run;
+            info.factor = longerLiteral(info.factor, run);
+            break;
+        }
+        default: {
+            //star and optional can match the empty string and dot/char ranges match many chars so there is nothing required
+            break;
+        }
+        }
+
+        return info;
+    }
+
+    std::pair<std::vector<RegexChar>, bool> RegexLiteralFactors::requiredLiteral(const RegexOpt* opt)
+    {
+        auto info = RegexLiteralFactors::computeInfo(opt);
+
+        //a suffix lets the search start the reverse machine from each occurrence so we use it unless there is a much longer literal inside
+        if(!info.suffix.empty() && (info.suffix.size() * 2) >= info.factor.size()) {
+            return std::make_pair(info.suffix, true);
+        }
+
+        return std::make_pair(info.factor, false);
+    }
+
+    NFAMachine* RegexCompiler::compileSetNFA(const std::vector<const RegexOpt*>& opts)
+    {
+        std::vector<NFAOpt*> nfastates;
+        for(size_t i = 0; i < opts.size(); ++i) {
+            nfastates.push_back(new NFAOptAccept((StateID)i));
+        }
+
+        std::vector<StateID> starts;
+        for(size_t i = 0; i < opts.size(); ++i) {
+            starts.push_back(RegexCompiler::compileOpt((StateID)i, nfastates, opts[i]));
+        }
+
+        auto startstate = (StateID)nfastates.size();
+        nfastates.push_back(new NFAOptAnyOf(startstate, starts));
+
+        return new NFAMachine(startstate, 0, nfastates);
+    }
+
     StateID RegexCompiler::compileLiteralOpt(StateID follows, std::vector<NFAOpt*>& states, const LiteralOpt* opt)
     {
         for(int64_t i = opt->codes.size() - 1; i >= 0; --i) {
@@ -46,9 +46,7 @@ namespace brex
         std::vector<RegexCompileError> errors;
         std::vector<std::string> pending_resolves;
 
-        bool inRangeRepeat;
-
-        RegexResolver(NameResolverState resolverState, fnNameResolver nameResolverFn, const std::map<std::string, const RegexOpt*>& namedRegexes, bool envEnabled, const std::map<std::string, const LiteralOpt*>& envRegexes) : resolverState(resolverState), nameResolverFn(nameResolverFn), namedRegexes(namedRegexes), envEnabled(envEnabled), envRegexes(envRegexes), errors(), pending_resolves(), inRangeRepeat(false) { ; }
+        RegexResolver(NameResolverState resolverState, fnNameResolver nameResolverFn, const std::map<std::string, const RegexOpt*>& namedRegexes, bool envEnabled, const std::map<std::string, const LiteralOpt*>& envRegexes) : resolverState(resolverState), nameResolverFn(nameResolverFn), namedRegexes(namedRegexes), envEnabled(envEnabled), envRegexes(envRegexes), errors(), pending_resolves() { ; }
         ~RegexResolver() = default;
 
         const RegexOpt* resolve(const RegexOpt* opt);
@@ -56,6 +54,123 @@ namespace brex
         static void gatherNamedRegexKeys(std::set<std::string>& cnames, std::set<std::string>& enames, const RegexOpt* opt);
     };
 
+    //Lower a resolved unicode regex into an equivalent regex over the utf8 bytes of the string (as in RE2/utf8-ranges) so it can be run without decoding
+    //Literals become their utf8 byte sequences and char ranges (and dot) become alternations of byte range sequences covering the valid scalar values
+    class RegexUTF8Lowering
+    {
+    private:
+        static std::vector<SingleCharRange> normalizeRanges(bool compliment, const std::vector<SingleCharRange>& ranges);
+        static void appendUTF8Sequences(RegexChar low, RegexChar high, std::vector<std::vector<SingleCharRange>>& seqs);
+
+        static const RegexOpt* lowerRanges(const std::vector<SingleCharRange>& ranges);
+        static const RegexOpt* lowerLiteralOpt(const LiteralOpt* opt);
+        static const RegexOpt* lowerCharRangeOpt(const CharRangeOpt* opt);
+
+    public:
+        static constexpr RegexChar MAX_SCALAR_VALUE = 0x10FFFF;
+        static constexpr RegexChar SURROGATE_LOW = 0xD800;
+        static constexpr RegexChar SURROGATE_HIGH = 0xDFFF;
+
+        static const RegexOpt* lower(const RegexOpt* opt);
+    };
+
+    //Rewrite range repeats into plain copies of their body (when small enough) so the machine is counter free and can use the DFA engines
+    class RegexRangeUnrolling
+    {
+    private:
+        static const RegexOpt* unrollRangeRepeatOpt(const RangeRepeatOpt* opt, size_t maxstates);
+
+    public:
+        //the number of NFA states the compiler makes for the regex
+        static size_t stateCost(const RegexOpt* opt);
+
+        //ranges whose unrolled version has at most maxstates states are unrolled (inner ranges first) -- the rest are kept as counters
+        static const RegexOpt* unroll(const RegexOpt* opt, size_t maxstates);
+    };
+
+    //Rewrite a resolved regex into a smaller one that matches the same strings so the machine has fewer states (and a smaller active set)
+    //Alternatives are factored on their common prefixes and suffixes, single char alternatives become one char range, literals in a sequence are joined, and nested repeats are collapsed
+    class RegexSimplifier
+    {
+    private:
+        //equal keys means the regexes are the same (structurally)
+        static std::string structureKey(const RegexOpt* opt);
+
+        static bool isEmptyOpt(const RegexOpt* opt);
+        static bool isSingleCharOpt(const RegexOpt* opt);
+
+        //a simplified regex as the list of things it is a sequence of (literals are split into their chars)
+        static void appendAtoms(const RegexOpt* opt, std::vector<const RegexOpt*>& atoms);
+        static const RegexOpt* fromAtoms(std::vector<const RegexOpt*>::const_iterator begin, std::vector<const RegexOpt*>::const_iterator end);
+
+        static const RegexOpt* makeSequence(const std::vector<const RegexOpt*>& regexs);
+        static const RegexOpt* makeOptional(const RegexOpt* opt);
+        static const RegexOpt* makeAnyOf(const std::vector<const RegexOpt*>& opts);
+
+        static std::vector<std::vector<const RegexOpt*>> factorAlternatives(const std::vector<std::vector<const RegexOpt*>>& alts, bool prefix);
+        static const RegexOpt* mergeSingleChars(const std::vector<const RegexOpt*>& opts);
+
+        static const RegexOpt* simplifyStarRepeatOpt(const StarRepeatOpt* opt);
+        static const RegexOpt* simplifyPlusRepeatOpt(const PlusRepeatOpt* opt);
+        static const RegexOpt* simplifyRangeRepeatOpt(const RangeRepeatOpt* opt);
+
+    public:
+        static const RegexOpt* simplify(const RegexOpt* opt);
+    };
+
+    //Find a literal that every match of a resolved regex contains so contains searches can scan for it before running the machines
+    //If it is also at the end of every match then the matches can only end where it does and the reverse machine can be started from those places
+    class RegexLiteralFactors
+    {
+    private:
+        class FactorInfo
+        {
+        public:
+            std::optional<std::vector<RegexChar>> exact; //the only string the regex matches (if there is just one)
+            std::vector<RegexChar> prefix; //every match starts with this
+            std::vector<RegexChar> suffix; //every match ends with this
+            std::vector<RegexChar> factor; //every match contains this
+        };
+
+        static FactorInfo computeInfo(const RegexOpt* opt);
+
+    public:
+        //longer exact strings from repeats are not built
+        static constexpr size_t MAX_EXACT_LENGTH = 64;
+
+        //the literal and true if it is a suffix of every match (the literal is empty if no match has to contain any char)
+        static std::pair<std::vector<RegexChar>, bool> requiredLiteral(const RegexOpt* opt);
+    };
+
+    class RegexCompilerOptions
+    {
+    public:
+        //build a full (minimized) DFA for counter free machines when it has at most maxDFAStates states
+        bool buildDFA;
+        size_t maxDFAStates;
+
+        //memory budget (in bytes) for the lazy DFA cache used when there is no full DFA
+        size_t lazyDFABudget;
+
+        //use a bit-parallel (Glushkov) machine when there is no full DFA and the machine has at most this many positions (0 to disable)
+        size_t maxGlushkovPositions;
+
+        //range repeats are unrolled into plain states when that takes at most this many states (0 to always use counters)
+        size_t maxUnrollStates;
+
+        //simplify the regex (with RegexSimplifier) before building the machines
+        bool simplify;
+
+        RegexCompilerOptions() : buildDFA(true), maxDFAStates(1024), lazyDFABudget(LazyDFACache::DEFAULT_BUDGET), maxGlushkovPositions(GlushkovMachine::MAX_POSITIONS), maxUnrollStates(64), simplify(true) { ; }
+        ~RegexCompilerOptions() = default;
+
+        RegexCompilerOptions(const RegexCompilerOptions& other) = default;
+        RegexCompilerOptions(RegexCompilerOptions&& other) = default;
+
+        RegexCompilerOptions& operator=(const RegexCompilerOptions& other) = default;
+        RegexCompilerOptions& operator=(RegexCompilerOptions&& other) = default;
+    };
+
     class RegexCompiler
     {
     private:
@@ -83,27 +198,85 @@ namespace brex
 
         static StateID reverseCompileOpt(StateID follows, std::vector<NFAOpt*>& states, const RegexOpt* opt);
 
+        //the single machine for all the regexes of a set -- regex i ends in accept state i
+        static NFAMachine* compileSetNFA(const std::vector<const RegexOpt*>& opts);
+
+        //true if the regex is one plain (possibly negated) entry with no anchors, conjunctions, or front/back checks so it can go in the machine of a set
+        static bool isSetMachineRegex(const Regex* re)
+        {
+            if(re->preanchor != nullptr || re->postanchor != nullptr || re->re->tag != RegexComponentTag::Single) {
+                return false;
+            }
+
+            auto sre = static_cast<const RegexSingleComponent*>(re->re);
+            return !(sre->entry.isFrontCheck || sre->entry.isBackCheck);
+        }
+
+        const RegexCompilerOptions options;
         std::vector<RegexCompileError> errors;
 
-        template <typename TStr, typename TIter>
-        std::optional<SingleCheckREInfo<TStr, TIter>*> compileSingleTopLevelEntry(const RegexToplevelEntry& tlre, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, NameResolverState resolverState, fnNameResolver nameResolverFn)
+        //resolve the names in the regex -- the resolved regex and the version the machines are built from (nullopt on an error)
+        template <typename TIter>
+        std::optional<std::pair<const RegexOpt*, const RegexOpt*>> resolveMachineOpt(const RegexOpt* opt, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, NameResolverState resolverState, fnNameResolver nameResolverFn)
         {
             RegexResolver resolver(resolverState, nameResolverFn, namedRegexes, envEnabled, envRegexes);
-            auto fullre = resolver.resolve(tlre.opt);
+            auto fullre = resolver.resolve(opt);
             if(resolver.errors.size() > 0) {
                 std::copy(resolver.errors.cbegin(), resolver.errors.cend(), std::back_inserter(this->errors));
                 return std::nullopt;
             }
 
+            //the machines are built from the simplified version but the IR outputs (and literal factors) use the regex as written
+            const RegexOpt* machinere = this->options.simplify ? RegexSimplifier::simplify(fullre) : fullre;
+
+            //the byte iterator runs over raw utf8 so we compile the lowered version -- simplifying again factors the lead bytes the sequences share
+            if(std::is_same<TIter, UnicodeByteRegexIterator>::value) {
+                machinere = RegexUTF8Lowering::lower(machinere);
+                if(this->options.simplify) {
+                    machinere = RegexSimplifier::simplify(machinere);
+                }
+            }
+
+            if(this->options.maxUnrollStates != 0) {
+                machinere = RegexRangeUnrolling::unroll(machinere, this->options.maxUnrollStates);
+            }
+
+            return std::make_optional(std::make_pair(fullre, machinere));
+        }
+
+        template <typename TStr, typename TIter>
+        std::optional<SingleCheckREInfo<TStr, TIter>*> compileSingleTopLevelEntry(const RegexToplevelEntry& tlre, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, NameResolverState resolverState, fnNameResolver nameResolverFn)
+        {
+            auto resolved = this->resolveMachineOpt<TIter>(tlre.opt, namedRegexes, envRegexes, envEnabled, resolverState, nameResolverFn);
+            if(!resolved.has_value()) {
+                return std::nullopt;
+            }
+
+            const RegexOpt* fullre = resolved.value().first;
+            const RegexOpt* machinere = resolved.value().second;
+
             std::vector<NFAOpt*> nfastates_forward = { new NFAOptAccept(0) };
-            auto nfastart_forward = RegexCompiler::compileOpt(0, nfastates_forward, fullre);
+            auto nfastart_forward = RegexCompiler::compileOpt(0, nfastates_forward, machinere);
             NFAMachine* nfaforward = new NFAMachine(nfastart_forward, 0, nfastates_forward);
 
             std::vector<NFAOpt*> nfastates_reverse = { new NFAOptAccept(0) };
-            auto nfastart_reverse = RegexCompiler::reverseCompileOpt(0, nfastates_reverse, fullre);
+            auto nfastart_reverse = RegexCompiler::reverseCompileOpt(0, nfastates_reverse, machinere);
             NFAMachine* nfareverse = new NFAMachine(nfastart_reverse, 0, nfastates_reverse);
             
-            NFAExecutor<TStr, TIter> nn(nfaforward, nfareverse);
+            DFAMachine* dfaforward = this->options.buildDFA ? DFAMachine::tryCompile(nfaforward, this->options.maxDFAStates) : nullptr;
+            DFAMachine* dfareverse = this->options.buildDFA ? DFAMachine::tryCompile(nfareverse, this->options.maxDFAStates) : nullptr;
+
+            GlushkovMachine* gmforward = dfaforward == nullptr ? GlushkovMachine::tryCompile(nfaforward, this->options.maxGlushkovPositions) : nullptr;
+            GlushkovMachine* gmreverse = dfareverse == nullptr ? GlushkovMachine::tryCompile(nfareverse, this->options.maxGlushkovPositions) : nullptr;
+
+            //the literal is over the code points of the regex so it is encoded the same way as the string
+            auto factor = RegexLiteralFactors::requiredLiteral(fullre);
+            LiteralFactorFilter* factorfilter = LiteralFactorFilter::tryCreate(factor.first, factor.second, std::is_same<TStr, UnicodeString>::value);
+
+            //a plain negated entry is tested on the complement of the forward DFA
+            DFAMachine* dfacomplement = (tlre.isNegated && !tlre.isFrontCheck && !tlre.isBackCheck && dfaforward != nullptr) ? DFAMachine::complement(dfaforward) : nullptr;
+
+            NFAExecutor<TStr, TIter> nn(nfaforward, nfareverse, dfaforward, dfareverse, gmforward, gmreverse, this->options.lazyDFABudget, factorfilter, dfacomplement);
 
             auto bsqstd = fullre->toBSQStandard();
             auto smtre = fullre->toSMTRegex();
@@ -160,13 +333,13 @@ namespace brex
         }
 
     public:
-        RegexCompiler() : errors() { ; }
+        RegexCompiler(const RegexCompilerOptions& options) : options(options), errors() { ; }
         ~RegexCompiler() = default;
 
         template <typename TStr, typename TIter, bool isunicode>
-        static REExecutor<TStr, TIter, isunicode>* compileRegexToExecutor(const Regex* re, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, NameResolverState resolverState, fnNameResolver nameResolverFn, std::vector<RegexCompileError>& errinfo)
+        static REExecutor<TStr, TIter, isunicode>* compileRegexToExecutor(const Regex* re, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, NameResolverState resolverState, fnNameResolver nameResolverFn, std::vector<RegexCompileError>& errinfo, const RegexCompilerOptions& options = RegexCompilerOptions())
         {
-            RegexCompiler rcc;
+            RegexCompiler rcc(options);
 
             ComponentCheckREInfo<TStr, TIter>* optPre = re->preanchor != nullptr ? rcc.compileComponent<TStr, TIter>(re->preanchor, namedRegexes, envRegexes, envEnabled, resolverState, nameResolverFn) : nullptr; 
             ComponentCheckREInfo<TStr, TIter>* optPost = re->postanchor != nullptr ? rcc.compileComponent<TStr, TIter>(re->postanchor, namedRegexes, envRegexes, envEnabled, resolverState, nameResolverFn) : nullptr;
@@ -180,6 +353,61 @@ namespace brex
             return new REExecutor<TStr, TIter, isunicode>(re, optPre, optPost, cre);
         }
 
+        //compile the regexes (each with the resolver state for its names) into one set -- errinfo is added to and nullptr returned on an error
+        //plain entries (negated or not) go in the shared machine and a negated one is flagged in machinenegated so the set reports it when its pattern does not accept
+        //only regexes with anchors, conjunctions, or front/back checks get an executor of their own
+        template <typename TStr, typename TIter, bool isunicode>
+        static RegexSet<TStr, TIter, isunicode>* compileRegexSet(const std::vector<std::pair<const Regex*, NameResolverState>>& res, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, fnNameResolver nameResolverFn, std::vector<RegexCompileError>& errinfo, const RegexCompilerOptions& options = RegexCompilerOptions())
+        {
+            RegexCompiler rcc(options);
+
+            std::vector<const RegexOpt*> machineopts;
+            std::vector<size_t> machineregexes;
+            std::vector<bool> machinenegated;
+            std::vector<std::pair<size_t, REExecutor<TStr, TIter, isunicode>*>> separate;
+            for(size_t i = 0; i < res.size(); ++i) {
+                const Regex* re = res[i].first;
+                if(re->ctag != (isunicode ? RegexCharInfoTag::Unicode : RegexCharInfoTag::Char) || re->rtag != RegexKindTag::Std) {
+                    rcc.errors.push_back(RegexCompileError(isunicode ? u8"Expected a standard Unicode regex in set" : u8"Expected a standard char regex in set"));
+                    continue;
+                }
+
+                if(RegexCompiler::isSetMachineRegex(re)) {
+                    auto sre = static_cast<const RegexSingleComponent*>(re->re);
+                    auto resolved = rcc.resolveMachineOpt<TIter>(sre->entry.opt, namedRegexes, envRegexes, envEnabled, res[i].second, nameResolverFn);
+                    if(resolved.has_value()) {
+                        machineopts.push_back(resolved.value().second);
+                        machineregexes.push_back(i);
+                        machinenegated.push_back(sre->entry.isNegated);
+                    }
+                }
+                else {
+                    auto executor = RegexCompiler::compileRegexToExecutor<TStr, TIter, isunicode>(re, namedRegexes, envRegexes, envEnabled, res[i].second, nameResolverFn, rcc.errors, options);
+                    if(executor != nullptr) {
+                        separate.push_back(std::make_pair(i, executor));
+                    }
+                }
+            }
+
+            if(!rcc.errors.empty()) {
+                std::copy(rcc.errors.cbegin(), rcc.errors.cend(), std::back_inserter(errinfo));
+                return nullptr;
+            }
+
+            SetMachine* machine = !machineopts.empty() ? SetMachine::compile(RegexCompiler::compileSetNFA(machineopts), machineopts.size(), options.buildDFA, options.maxDFAStates) : nullptr;
+            return new RegexSet<TStr, TIter, isunicode>(res.size(), machine, machineregexes, machinenegated, separate);
+        }
+
+        static UnicodeRegexSet* compileUnicodeRegexSet(const std::vector<std::pair<const Regex*, NameResolverState>>& res, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, fnNameResolver nameResolverFn, std::vector<RegexCompileError>& errinfo, const RegexCompilerOptions& options = RegexCompilerOptions())
+        {
+            return compileRegexSet<UnicodeString, UnicodeRegexIterator, true>(res, namedRegexes, envRegexes, envEnabled, nameResolverFn, errinfo, options);
+        }
+
+        static CRegexSet* compileCRegexSet(const std::vector<std::pair<const Regex*, NameResolverState>>& res, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, fnNameResolver nameResolverFn, std::vector<RegexCompileError>& errinfo, const RegexCompilerOptions& options = RegexCompilerOptions())
+        {
+            return compileRegexSet<CString, CRegexIterator, false>(res, namedRegexes, envRegexes, envEnabled, nameResolverFn, errinfo, options);
+        }
+
         static bool gatherNamedRegexKeys(std::set<std::string>& constnames, std::set<std::string>& envnames, const Regex* re)
         {
             if(re->preanchor != nullptr) {
@@ -195,7 +423,23 @@ namespace brex
             return !envnames.empty();
         }
 
-        static UnicodeRegexExecutor* compileUnicodeRegexToExecutor(const Regex* re, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, NameResolverState resolverState, fnNameResolver nameResolverFn, std::vector<RegexCompileError>& errinfo)
+        static UnicodeRegexExecutor* compileUnicodeRegexToExecutor(const Regex* re, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, NameResolverState resolverState, fnNameResolver nameResolverFn, std::vector<RegexCompileError>& errinfo, const RegexCompilerOptions& options = RegexCompilerOptions())
+        {
+            if(re->ctag != RegexCharInfoTag::Unicode) {
+                errinfo.push_back(RegexCompileError(u8"Expected a Unicode regex"));
+                return nullptr;
+            }
+
+            if(re->rtag != RegexKindTag::Std) {
+                errinfo.push_back(RegexCompileError(u8"Expected a standard regex"));
+                return nullptr;
+            }
+
+            return compileRegexToExecutor<UnicodeString, UnicodeRegexIterator, true>(re, namedRegexes, envRegexes, envEnabled, resolverState, nameResolverFn, errinfo, options);
+        }
+
+        //compile a unicode regex to run directly over the utf8 bytes of the string -- match positions are byte accurate (the last byte of the last char in the match)
+        static UnicodeByteRegexExecutor* compileUnicodeRegexToByteExecutor(const Regex* re, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, NameResolverState resolverState, fnNameResolver nameResolverFn, std::vector<RegexCompileError>& errinfo, const RegexCompilerOptions& options = RegexCompilerOptions())
         {
             if(re->ctag != RegexCharInfoTag::Unicode) {
                 errinfo.push_back(RegexCompileError(u8"Expected a Unicode regex"));
@@ -207,10 +451,10 @@ namespace brex
                 return nullptr;
             }
 
-            return compileRegexToExecutor<UnicodeString, UnicodeRegexIterator, true>(re, namedRegexes, envRegexes, envEnabled, resolverState, nameResolverFn, errinfo);
+            return compileRegexToExecutor<UnicodeString, UnicodeByteRegexIterator, true>(re, namedRegexes, envRegexes, envEnabled, resolverState, nameResolverFn, errinfo, options);
         }
 
-        static CRegexExecutor* compileCRegexToExecutor(const Regex* re, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, NameResolverState resolverState, fnNameResolver nameResolverFn, std::vector<RegexCompileError>& errinfo)
+        static CRegexExecutor* compileCRegexToExecutor(const Regex* re, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, NameResolverState resolverState, fnNameResolver nameResolverFn, std::vector<RegexCompileError>& errinfo, const RegexCompilerOptions& options = RegexCompilerOptions())
         {
             if(re->ctag != RegexCharInfoTag::Char) {
                 errinfo.push_back(RegexCompileError(u8"Expected an char regex"));
@@ -222,10 +466,10 @@ namespace brex
                 return nullptr;
             }
 
-            return compileRegexToExecutor<CString, CRegexIterator, false>(re, namedRegexes, envRegexes, envEnabled, resolverState, nameResolverFn, errinfo);
+            return compileRegexToExecutor<CString, CRegexIterator, false>(re, namedRegexes, envRegexes, envEnabled, resolverState, nameResolverFn, errinfo, options);
         }
 
-        static CRegexExecutor* compilePathRegexToExecutor(const Regex* re, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, NameResolverState resolverState, fnNameResolver nameResolverFn, std::vector<RegexCompileError>& errinfo)
+        static CRegexExecutor* compilePathRegexToExecutor(const Regex* re, const std::map<std::string, const RegexOpt*>& namedRegexes, const std::map<std::string, const LiteralOpt*>& envRegexes, bool envEnabled, NameResolverState resolverState, fnNameResolver nameResolverFn, std::vector<RegexCompileError>& errinfo, const RegexCompilerOptions& options = RegexCompilerOptions())
         {
             if(re->ctag != RegexCharInfoTag::Char) {
                 errinfo.push_back(RegexCompileError(u8"Expected an char regex"));
@@ -237,7 +481,7 @@ namespace brex
                 return nullptr;
             }
 
-            return compileRegexToExecutor<CString, CRegexIterator, false>(re, namedRegexes, envRegexes, envEnabled, resolverState, nameResolverFn, errinfo);
+            return compileRegexToExecutor<CString, CRegexIterator, false>(re, namedRegexes, envRegexes, envEnabled, resolverState, nameResolverFn, errinfo, options);
         }
     };
 }
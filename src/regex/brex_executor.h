@@ -2,6 +2,7 @@
 
 #include "../common.h"
 #include "nfa_executor.h"
+#include "set_machine.h"
 
 namespace brex
 {
@@ -35,12 +36,40 @@ namespace brex
 
         //return the first and last index of the substring that the regex accepts -- spos it the first matching index and epos is the longest matching index (empty if no match exists)
         virtual std::vector<std::pair<int64_t, int64_t>> matchContains(TStr* sstr, int64_t spos, int64_t epos) = 0;
+
+        //the match with the smallest start (and the longest one from there) and the match with the largest end (and the longest one to there) -- empty if no match exists
+        virtual std::optional<std::pair<int64_t, int64_t>> matchContainsFirst(TStr* sstr, int64_t spos, int64_t epos) = 0;
+        virtual std::optional<std::pair<int64_t, int64_t>> matchContainsLast(TStr* sstr, int64_t spos, int64_t epos) = 0;
         
         //return the end index of the match -- starting from spos (or empty if no match is exists)
         virtual std::vector<int64_t> matchFront(TStr* sstr, int64_t spos, int64_t epos) = 0;
 
         //return the start index of the match -- ending at epos (or empty if no match is exists)
         virtual std::vector<int64_t> matchBack(TStr* sstr, int64_t spos, int64_t epos) = 0;
+
+        //the end of the longest (or shortest) match -- starting at spos -- without finding every match end
+        virtual std::optional<int64_t> matchFrontEnd(TStr* sstr, int64_t spos, int64_t epos, MatchMode mode) = 0;
+
+        //the start of the longest (or shortest) match -- ending at epos -- without finding every match start
+        virtual std::optional<int64_t> matchBackStart(TStr* sstr, int64_t spos, int64_t epos, MatchMode mode) = 0;
+
+        //test a string that arrives in pieces -- streamStart and then streamStep on each char -- streamAccepted is test on the chars so far
+        //streamLive is false once no more chars can change the result to accepted (so the rest of the input can be skipped)
+        virtual void streamStart() = 0;
+        virtual void streamStep(RegexChar c) = 0;
+        virtual bool streamAccepted() const = 0;
+        virtual bool streamLive() const = 0;
+
+        //acceptance bitmaps over every position so checking an anchor for a candidate is O(1) -- bits has epos - spos + 2 entries
+        //only the entries for positions on char boundaries are set (p is the last byte of a char going forward and the first byte of one in reverse -- see common.h)
+        //forward: bits[p - spos + 1] = test(spos, p) for p in [spos - 1, epos] -- in reverse: bits[p - spos] = test(p, epos) for p in [spos, epos + 1]
+        virtual void testBits(TStr* sstr, int64_t spos, int64_t epos, bool forward, std::vector<bool>& bits) = 0;
+
+        //bits[p - spos + 1] = testBack(spos, p) for p in [spos - 1, epos]
+        virtual void testBackBits(TStr* sstr, int64_t spos, int64_t epos, std::vector<bool>& bits) = 0;
+
+        //bits[p - spos] = testFront(p, epos) for p in [spos, epos + 1]
+        virtual void testFrontBits(TStr* sstr, int64_t spos, int64_t epos, std::vector<bool>& bits) = 0;
     };
 
     template <typename TStr, typename TIter>
@@ -56,8 +85,11 @@ namespace brex
         std::string smtre;
         std::string cppstd;
 
+        //a front check in a stream holds from its first accept on
+        bool streamsticky;
+
         SingleCheckREInfo() = default;
-        SingleCheckREInfo(const NFAExecutor<TStr, TIter>& executor, bool isNegative, bool isFrontCheck, bool isBackCheck, std::string bsqnf, std::string smtre, std::string cppstd) : ComponentCheckREInfo<TStr, TIter>(), executor(executor), isNegative(isNegative), isFrontCheck(isFrontCheck), isBackCheck(isBackCheck), bsqnf(bsqnf), smtre(smtre), cppstd(cppstd) {;}
+        SingleCheckREInfo(const NFAExecutor<TStr, TIter>& executor, bool isNegative, bool isFrontCheck, bool isBackCheck, std::string bsqnf, std::string smtre, std::string cppstd) : ComponentCheckREInfo<TStr, TIter>(), executor(executor), isNegative(isNegative), isFrontCheck(isFrontCheck), isBackCheck(isBackCheck), bsqnf(bsqnf), smtre(smtre), cppstd(cppstd), streamsticky(false) {;}
         virtual ~SingleCheckREInfo() = default;
 
         SingleCheckREInfo(const SingleCheckREInfo& other) = default;
@@ -96,7 +128,8 @@ namespace brex
                 accepted = this->executor.matchTestReverse(sstr, spos, epos);
             }
             else {
-                accepted = this->executor.test(sstr, spos, epos);
+                //a negated entry runs on the complement so it can stop early either way
+                return this->isNegative ? this->executor.testComplement(sstr, spos, epos) : this->executor.test(sstr, spos, epos);
             }
 
             return this->isNegative ? !accepted : accepted;
@@ -104,30 +137,13 @@ namespace brex
 
         bool test(TStr* sstr, int64_t spos, int64_t epos) override final
         {
-            bool accepted = false;
-            if(this->isFrontCheck) {
-                accepted = this->executor.matchTestForward(sstr, spos, epos);
-            }
-            else if(this->isBackCheck) {
-                accepted = this->executor.matchTestReverse(sstr, spos, epos);
-            }
-            else {
-                accepted = this->executor.test(sstr, spos, epos);
-            }
-
-            return this->isNegative ? !accepted : accepted;
+            return this->validateSingleOp(sstr, spos, epos);
         }
 
         bool testContains(TStr* sstr, int64_t spos, int64_t epos) override final
         {
             //by def a single option that is not negative or front/back marked
-            for(int64_t ii = spos; ii <= epos; ++ii) {
-                if(this->executor.matchTestForward(sstr, ii, epos)) {
-                    return true;
-                }
-            }
-
-            return false;
+            return this->executor.matchTestContains(sstr, spos, epos);
         }
 
         bool testFront(TStr* sstr, int64_t spos, int64_t epos) override final
@@ -144,21 +160,58 @@ namespace brex
 
         std::vector<std::pair<int64_t, int64_t>> matchContains(TStr* sstr, int64_t spos, int64_t epos) override final
         {
-            std::vector<std::pair<int64_t, int64_t>> matches;
+            //one pass to find the offsets where some match starts so we only run the forward machine from those (nothing more if there is no match)
+            auto starts = this->executor.scanReverseStarts(sstr, spos, epos);
 
-            for(int64_t ii = spos; ii <= epos; ++ii) {
+            std::vector<std::pair<int64_t, int64_t>> matches;
+            for(auto iter = starts.crbegin(); iter != starts.crend(); ++iter) {
+                const int64_t ii = *iter;
                 auto mm = this->executor.matchForward(sstr, ii, epos);
 
-                if(!mm.empty()) {
-                    std::transform(mm.cbegin(), mm.cend(), std::back_inserter(matches), [ii](int64_t epos) {
-                        return std::make_pair(ii, epos);
-                    });
-                }
+                std::transform(mm.cbegin(), mm.cend(), std::back_inserter(matches), [ii](int64_t epos) {
+                    return std::make_pair(ii, epos);
+                });
             }
 
             return matches;
         }
 
+        std::optional<std::pair<int64_t, int64_t>> matchContainsFirst(TStr* sstr, int64_t spos, int64_t epos) override final
+        {
+            //by def a single option that is not negative or front/back marked
+            //find the first start with the unanchored reverse machine and then the longest match from it with the forward machine
+            auto mstart = this->executor.scanReverseFirstStart(sstr, spos, epos);
+            if(!mstart.has_value()) {
+                return std::nullopt;
+            }
+
+            auto mend = this->executor.matchForwardEnd(sstr, mstart.value(), epos, MatchMode::Longest);
+            BREX_ASSERT(mend.has_value(), "Reverse scan found a start with no forward match");
+            if(!mend.has_value()) {
+                return std::nullopt;
+            }
+
+            return std::make_optional(std::make_pair(mstart.value(), mend.value()));
+        }
+
+        std::optional<std::pair<int64_t, int64_t>> matchContainsLast(TStr* sstr, int64_t spos, int64_t epos) override final
+        {
+            //by def a single option that is not negative or front/back marked
+            //find the last end with the unanchored forward machine and then the longest match to it with the reverse machine
+            auto mend = this->executor.scanForwardLastEnd(sstr, spos, epos);
+            if(!mend.has_value()) {
+                return std::nullopt;
+            }
+
+            auto mstart = this->executor.matchReverseStart(sstr, spos, mend.value(), MatchMode::Longest);
+            BREX_ASSERT(mstart.has_value(), "Forward scan found an end with no reverse match");
+            if(!mstart.has_value()) {
+                return std::nullopt;
+            }
+
+            return std::make_optional(std::make_pair(mstart.value(), mend.value()));
+        }
+
         std::vector<int64_t> matchFront(TStr* sstr, int64_t spos, int64_t epos) override final
         {
             return this->executor.matchForward(sstr, spos, epos);
@@ -168,6 +221,122 @@ namespace brex
         {
             return this->executor.matchReverse(sstr, spos, epos);
         }
+
+        std::optional<int64_t> matchFrontEnd(TStr* sstr, int64_t spos, int64_t epos, MatchMode mode) override final
+        {
+            return this->executor.matchForwardEnd(sstr, spos, epos, mode);
+        }
+
+        std::optional<int64_t> matchBackStart(TStr* sstr, int64_t spos, int64_t epos, MatchMode mode) override final
+        {
+            return this->executor.matchReverseStart(sstr, spos, epos, mode);
+        }
+
+        //a stream is a forward lock-step run -- anchored for a plain check and unanchored for a back check
+        void streamStart() override final
+        {
+            this->executor.startLockStep(true, this->isBackCheck);
+            this->streamsticky = this->isFrontCheck && this->executor.lockStepAccepted();
+        }
+
+        void streamStep(RegexChar c) override final
+        {
+            if(this->streamsticky) {
+                return;
+            }
+
+            this->executor.stepLockStep(c, this->isBackCheck);
+            this->streamsticky = this->isFrontCheck && this->executor.lockStepAccepted();
+        }
+
+        bool streamAccepted() const override final
+        {
+            const bool accepted = this->isFrontCheck ? this->streamsticky : this->executor.lockStepAccepted();
+            return this->isNegative ? !accepted : accepted;
+        }
+
+        bool streamLive() const override final
+        {
+            if(this->isBackCheck) {
+                //a later suffix can always match (or not)
+                return true;
+            }
+
+            if(this->isFrontCheck) {
+                return this->isNegative ? !this->streamsticky : (this->streamsticky || !this->executor.lockStepRejected());
+            }
+
+            return this->isNegative ? !this->executor.lockStepAcceptsAll() : !this->executor.lockStepRejected();
+        }
+
+        //one pass of the machine from spos (or from epos in reverse) with the acceptance for each position in bits (indexed as for testBits)
+        //an anchored run accepts where the range matches, a sticky one where some part of it that starts at the run start matches, and an unanchored one where some part of it that ends at the position matches
+        void runAcceptBits(TStr* sstr, int64_t spos, int64_t epos, bool forward, bool unanchored, bool sticky, std::vector<bool>& bits)
+        {
+            bits.assign((size_t)(epos - spos + 2), false);
+
+            this->executor.startLockStep(forward, unanchored);
+            bool accepted = this->executor.lockStepAccepted();
+            bits[forward ? 0 : (size_t)(epos - spos + 1)] = accepted;
+
+            TIter iter = forward ? TIter{sstr, spos, epos, spos} : TIter{sstr, spos, epos, epos + 1};
+            if(!forward) {
+                iter.dec(); //start on the first byte of the last char
+            }
+
+            while(iter.valid()) {
+                //an anchored run that is dead, accepts everything, or is sticky and has accepted has the same value for the rest of the positions
+                if(!unanchored && (this->executor.lockStepRejected() || this->executor.lockStepAcceptsAll() || (sticky && accepted))) {
+                    if(accepted) {
+                        std::fill(bits.begin() + (forward ? (iter.curr - spos + 1) : 0), bits.begin() + (forward ? bits.size() : (iter.curr - spos + 1)), true);
+                    }
+                    return;
+                }
+
+                this->executor.stepLockStep(iter.get(), unanchored);
+                accepted = (sticky && accepted) || this->executor.lockStepAccepted();
+
+                //forward the position is the last byte of the char and in reverse it is the first
+                if(forward) {
+                    iter.inc();
+                    bits[(size_t)(iter.curr - spos)] = accepted;
+                }
+                else {
+                    bits[(size_t)(iter.curr - spos)] = accepted;
+                    iter.dec();
+                }
+            }
+        }
+
+        void testBits(TStr* sstr, int64_t spos, int64_t epos, bool forward, std::vector<bool>& bits) override final
+        {
+            //front checks are sticky going forward and unanchored in reverse (back checks are the other way around)
+            const bool unanchored = forward ? this->isBackCheck : this->isFrontCheck;
+            const bool sticky = forward ? this->isFrontCheck : this->isBackCheck;
+            this->runAcceptBits(sstr, spos, epos, forward, unanchored, sticky, bits);
+
+            if(this->isNegative) {
+                bits.flip();
+            }
+        }
+
+        void testBackBits(TStr* sstr, int64_t spos, int64_t epos, std::vector<bool>& bits) override final
+        {
+            this->runAcceptBits(sstr, spos, epos, true, true, false, bits);
+
+            if(this->isNegative) {
+                bits.flip();
+            }
+        }
+
+        void testFrontBits(TStr* sstr, int64_t spos, int64_t epos, std::vector<bool>& bits) override final
+        {
+            this->runAcceptBits(sstr, spos, epos, false, true, false, bits);
+
+            if(this->isNegative) {
+                bits.flip();
+            }
+        }
     };
 
     template <typename TStr, typename TIter>
@@ -176,7 +345,11 @@ namespace brex
     public:
         std::vector<SingleCheckREInfo<TStr, TIter>*> checks;
 
-        MultiCheckREInfo(const std::vector<SingleCheckREInfo<TStr, TIter>*>& checks) : ComponentCheckREInfo<TStr, TIter>(), checks(checks) {;}
+        //the checks that are still stepped in a stream and if the stream can still be accepted
+        std::vector<bool> streamrunning;
+        bool streamlive;
+
+        MultiCheckREInfo(const std::vector<SingleCheckREInfo<TStr, TIter>*>& checks) : ComponentCheckREInfo<TStr, TIter>(), checks(checks), streamrunning(), streamlive(false) {;}
         virtual ~MultiCheckREInfo() = default;
 
         std::pair<std::string, std::string> getBSQIRInfo() const override final
@@ -201,52 +374,284 @@ namespace brex
             return std::make_pair("[NOT SUPPORTED (MultiCheck)]", "[NOT SUPPORTED (MultiCheck)]");
         }
 
-        void splitBindingOps(std::vector<SingleCheckREInfo<TStr, TIter>*>& bindingopts, std::vector<SingleCheckREInfo<TStr, TIter>*>& checkopts)
+        static bool validateOpSet(std::vector<SingleCheckREInfo<TStr, TIter>*>& opts, TStr* sstr, int64_t spos, int64_t epos)
         {
-            for(auto iter = this->checks.begin(); iter != this->checks.end(); ++iter) {
-                SingleCheckREInfo<TStr, TIter>* chk = *iter;
-                if(!chk->isNegative && !chk->isFrontCheck && !chk->isBackCheck) {
-                    bindingopts.push_back(chk);
+            return std::all_of(opts.begin(), opts.end(), [sstr, spos, epos](SingleCheckREInfo<TStr, TIter>* check) {
+                return check->validateSingleOp(sstr, spos, epos);
+            });
+        }
+
+        //a match has to be bound by a plain (not negative, front, or back) check
+        bool hasBindingCheck() const
+        {
+            return std::any_of(this->checks.cbegin(), this->checks.cend(), [](const SingleCheckREInfo<TStr, TIter>* check) {
+                return !check->isNegative && !check->isFrontCheck && !check->isBackCheck;
+            });
+        }
+
+        //in a lock-step run sticky checks hold from their first accept on (a front check run forward or a back check run in reverse) and
+        //floating checks are unanchored runs that hold where some part of the string ending there matches (a back check run forward or a front check run in reverse)
+        static bool isStickyCheck(const SingleCheckREInfo<TStr, TIter>* check, bool forward)
+        {
+            return forward ? check->isFrontCheck : check->isBackCheck;
+        }
+
+        static bool isFloatingCheck(const SingleCheckREInfo<TStr, TIter>* check, bool forward)
+        {
+            return forward ? check->isBackCheck : check->isFrontCheck;
+        }
+
+        //settle the checks that have the same value for every later position (and stop stepping them) -- false if one of them has settled on false so nothing later can match
+        bool settleChecks(bool forward, std::vector<bool>& running) const
+        {
+            for(size_t i = 0; i < this->checks.size(); ++i) {
+                const SingleCheckREInfo<TStr, TIter>* check = this->checks[i];
+                if(!running[i] || MultiCheckREInfo::isFloatingCheck(check, forward)) {
+                    continue;
+                }
+
+                const bool accepted = check->executor.lockStepAccepted();
+                const bool rejected = check->executor.lockStepRejected();
+                if(MultiCheckREInfo::isStickyCheck(check, forward)) {
+                    if(accepted || rejected) {
+                        //settled on accepted for the rest of the run
+                        if(accepted == check->isNegative) {
+                            return false;
+                        }
+                        running[i] = false;
+                    }
                 }
                 else {
-                    checkopts.push_back(chk);
+                    if(rejected || check->executor.lockStepAcceptsAll()) {
+                        //never accepts again or always accepts from here on
+                        if(rejected != check->isNegative) {
+                            return false;
+                        }
+                        running[i] = false;
+                    }
                 }
             }
+
+            return true;
         }
 
-        static std::vector<int64_t> computeSharedMatches(const std::vector<std::vector<int64_t>>& matches)
+        //a run in runMergedAcceptBits is the DFA state of each check with STICKY_ACCEPTED for a sticky check once it has accepted
+        static constexpr DFAStateID STICKY_ACCEPTED = -2;
+
+        //false if some check in the run can no longer hold at any later position (as in settleChecks)
+        bool mergedRunLive(const std::vector<const DFAMachine*>& dfas, bool forward, const std::vector<DFAStateID>& run) const
         {
-            if(matches.empty()) {
-                return std::vector<int64_t>();
+            for(size_t i = 0; i < this->checks.size(); ++i) {
+                const bool isNegative = this->checks[i]->isNegative;
+                if(run[i] == MultiCheckREInfo::STICKY_ACCEPTED) {
+                    if(isNegative) {
+                        return false;
+                    }
+                }
+                else if(dfas[i]->isDead(run[i])) {
+                    if(!isNegative) {
+                        return false;
+                    }
+                }
+                else if(dfas[i]->acceptsAll(run[i]) && !MultiCheckREInfo::isStickyCheck(this->checks[i], forward)) {
+                    if(isNegative) {
+                        return false;
+                    }
+                }
+                else {
+                    ;
+                }
             }
 
-            std::vector<int64_t> sharedmatches = matches[0];
-            for(auto iter = matches.cbegin() + 1; iter != matches.cend(); ++iter) {
-                std::vector<int64_t> newmatches;
-                std::set_intersection(sharedmatches.cbegin(), sharedmatches.cend(), iter->cbegin(), iter->cend(), std::back_inserter(newmatches));
-                sharedmatches = std::move(newmatches);
+            return true;
+        }
+
+        bool mergedRunHolds(const std::vector<const DFAMachine*>& dfas, bool forward, const std::vector<DFAStateID>& run) const
+        {
+            for(size_t i = 0; i < this->checks.size(); ++i) {
+                const bool accepted = MultiCheckREInfo::isStickyCheck(this->checks[i], forward) ? (run[i] == MultiCheckREInfo::STICKY_ACCEPTED) : dfas[i]->isAccepting(run[i]);
+                if(accepted == this->checks[i]->isNegative) {
+                    return false;
+                }
             }
 
-            return sharedmatches;
+            return true;
         }
 
-        static bool validateOpSet(std::vector<SingleCheckREInfo<TStr, TIter>*>& opts, TStr* sstr, int64_t spos, int64_t epos)
+        //the bits for testBackBits (forward) or testFrontBits (reverse) in one pass -- a run of all the checks is started on every char and runs that reach the same DFA states are merged
+        //so the number of runs in flight is bounded by the DFA sizes and not by the length of the string -- false (and nothing is done) if a check has no DFA or is floating (its runs would not merge)
+        bool runMergedAcceptBits(TStr* sstr, int64_t spos, int64_t epos, bool forward, std::vector<bool>& bits) const
         {
-            return std::all_of(opts.begin(), opts.end(), [sstr, spos, epos](SingleCheckREInfo<TStr, TIter>* check) {
-                return check->validateSingleOp(sstr, spos, epos);
-            });
+            std::vector<const DFAMachine*> dfas;
+            for(auto iter = this->checks.cbegin(); iter != this->checks.cend(); ++iter) {
+                const DFAMachine* dfa = forward ? (*iter)->executor.getForwardDFA() : (*iter)->executor.getReverseDFA();
+                if(dfa == nullptr || MultiCheckREInfo::isFloatingCheck(*iter, forward)) {
+                    return false;
+                }
+                dfas.push_back(dfa);
+            }
+
+            bits.assign((size_t)(epos - spos + 2), false);
+            if(!this->hasBindingCheck()) {
+                return true;
+            }
+
+            std::vector<DFAStateID> initial(this->checks.size(), 0);
+            for(size_t i = 0; i < this->checks.size(); ++i) {
+                const bool sticky = MultiCheckREInfo::isStickyCheck(this->checks[i], forward);
+                initial[i] = (sticky && dfas[i]->isAccepting(dfas[i]->startstate)) ? MultiCheckREInfo::STICKY_ACCEPTED : dfas[i]->startstate;
+            }
+            const bool initiallive = this->mergedRunLive(dfas, forward, initial);
+
+            std::set<std::vector<DFAStateID>> runs;
+            std::set<std::vector<DFAStateID>> nruns;
+            std::vector<DFAStateID> next(this->checks.size(), 0);
+
+            TIter iter = forward ? TIter{sstr, spos, epos, spos} : TIter{sstr, spos, epos, epos + 1};
+            if(!forward) {
+                iter.dec(); //start on the first byte of the last char
+            }
+
+            while(iter.valid()) {
+                if(initiallive) {
+                    runs.insert(initial);
+                }
+
+                const RegexChar c = iter.get();
+                bool holds = false;
+                for(auto riter = runs.cbegin(); riter != runs.cend(); ++riter) {
+                    for(size_t i = 0; i < this->checks.size(); ++i) {
+                        const DFAStateID dstate = (*riter)[i];
+                        if(dstate == MultiCheckREInfo::STICKY_ACCEPTED) {
+                            next[i] = dstate;
+                        }
+                        else {
+                            const DFAStateID nstate = dfas[i]->step(dstate, c);
+                            next[i] = (MultiCheckREInfo::isStickyCheck(this->checks[i], forward) && dfas[i]->isAccepting(nstate)) ? MultiCheckREInfo::STICKY_ACCEPTED : nstate;
+                        }
+                    }
+
+                    if(this->mergedRunLive(dfas, forward, next)) {
+                        holds = holds || this->mergedRunHolds(dfas, forward, next);
+                        nruns.insert(next);
+                    }
+                }
+
+                runs.swap(nruns);
+                nruns.clear();
+
+                //forward the position is the last byte of the char and in reverse it is the first
+                if(forward) {
+                    iter.inc();
+                    bits[(size_t)(iter.curr - spos)] = holds;
+                }
+                else {
+                    bits[(size_t)(iter.curr - spos)] = holds;
+                    iter.dec();
+                }
+            }
+
+            return true;
         }
 
-        static std::vector<int64_t> validateMatchSetOptions(const std::vector<int64_t>& opts, std::vector<SingleCheckREInfo<TStr, TIter>*>& checks, TStr* sstr, int64_t spos)
+        bool allChecksHold(bool forward, const std::vector<bool>& running) const
+        {
+            for(size_t i = 0; i < this->checks.size(); ++i) {
+                const SingleCheckREInfo<TStr, TIter>* check = this->checks[i];
+                if(running[i]) {
+                    //a running sticky check has not accepted yet
+                    const bool accepted = !MultiCheckREInfo::isStickyCheck(check, forward) && check->executor.lockStepAccepted();
+                    if(accepted == check->isNegative) {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        //run all the checks in lock-step over [spos, epos] (forward from spos or in reverse from epos) -- a single pass that steps every check on each char
+        //fn is called with each position (the match end going forward or the match start in reverse) where all the checks hold until it returns false
+        //the run stops as soon as some check can no longer hold at any later position
+        template <typename FN>
+        void runLockStep(TStr* sstr, int64_t spos, int64_t epos, bool forward, FN fn)
+        {
+            std::vector<bool> running(this->checks.size(), true);
+            for(size_t i = 0; i < this->checks.size(); ++i) {
+                this->checks[i]->executor.startLockStep(forward, MultiCheckREInfo::isFloatingCheck(this->checks[i], forward));
+            }
+
+            TIter iter = forward ? TIter{sstr, spos, epos, spos} : TIter{sstr, spos, epos, epos + 1};
+            if(!forward) {
+                iter.dec(); //start on the first byte of the last char
+            }
+
+            bool live = this->settleChecks(forward, running);
+            while(live && iter.valid()) {
+                const RegexChar c = iter.get();
+                for(size_t i = 0; i < this->checks.size(); ++i) {
+                    if(running[i]) {
+                        this->checks[i]->executor.stepLockStep(c, MultiCheckREInfo::isFloatingCheck(this->checks[i], forward));
+                    }
+                }
+
+                //forward the position is the last byte of the char (a match end) and in reverse it is the first (a match start)
+                int64_t pos = iter.curr;
+                if(forward) {
+                    iter.inc();
+                    pos = iter.curr - 1;
+                }
+                else {
+                    iter.dec();
+                }
+
+                live = this->settleChecks(forward, running);
+                if(live && this->allChecksHold(forward, running) && !fn(pos)) {
+                    return;
+                }
+            }
+        }
+
+        std::vector<int64_t> lockStepMatches(TStr* sstr, int64_t spos, int64_t epos, bool forward)
         {
             std::vector<int64_t> matches;
-            std::copy_if(opts.begin(), opts.end(), std::back_inserter(matches), [sstr, spos, &checks](int64_t epos) {
-                return MultiCheckREInfo::validateOpSet(checks, sstr, spos, epos);
-            });
+            if(this->hasBindingCheck()) {
+                this->runLockStep(sstr, spos, epos, forward, [&matches](int64_t pos) {
+                    matches.push_back(pos);
+                    return true;
+                });
+            }
 
             return matches;
         }
 
+        //the last position the conjunction matches at (or the first one for the shortest match)
+        std::optional<int64_t> lockStepMatch(TStr* sstr, int64_t spos, int64_t epos, bool forward, MatchMode mode)
+        {
+            std::optional<int64_t> match = std::nullopt;
+            if(this->hasBindingCheck()) {
+                this->runLockStep(sstr, spos, epos, forward, [&match, mode](int64_t pos) {
+                    match = pos;
+                    return mode == MatchMode::Longest;
+                });
+            }
+
+            return match;
+        }
+
+        bool lockStepAnyMatch(TStr* sstr, int64_t spos, int64_t epos, bool forward)
+        {
+            bool found = false;
+            if(this->hasBindingCheck()) {
+                this->runLockStep(sstr, spos, epos, forward, [&found](int64_t pos) {
+                    found = true;
+                    return false;
+                });
+            }
+
+            return found;
+        }
+
         bool test(TStr* sstr, int64_t spos, int64_t epos) override final
         {
             return MultiCheckREInfo::validateOpSet(this->checks, sstr, spos, epos);
@@ -260,98 +665,130 @@ namespace brex
 
         bool testFront(TStr* sstr, int64_t spos, int64_t epos) override final
         {
-            std::vector<SingleCheckREInfo<TStr, TIter>*> matchopts;
-            std::vector<SingleCheckREInfo<TStr, TIter>*> checkops;
-            this->splitBindingOps(matchopts, checkops);
+            return this->lockStepAnyMatch(sstr, spos, epos, true);
+        }
 
-            std::vector<int64_t> realmatches;
-            if(matchopts.size() == 1) {
-                realmatches = matchopts.front()->executor.matchForward(sstr, spos, epos);
-            }
-            else {
-                std::vector<std::vector<int64_t>> matches;
-                std::transform(matchopts.cbegin(), matchopts.cend(), std::back_inserter(matches), [sstr, spos, epos](SingleCheckREInfo<TStr, TIter>* check) {
-                    return check->executor.matchForward(sstr, spos, epos);
-                });
+        bool testBack(TStr* sstr, int64_t spos, int64_t epos) override final
+        {
+            return this->lockStepAnyMatch(sstr, spos, epos, false);
+        }
 
-                realmatches = MultiCheckREInfo::computeSharedMatches(matches);
-            }
+        std::vector<std::pair<int64_t, int64_t>> matchContains(TStr* sstr, int64_t spos, int64_t epos) override final
+        {
+            //CANNOT HAPPEN -- by def a matchable is a single option that is not negative or front/back marked
+            return std::vector<std::pair<int64_t, int64_t>>{};
+        }
 
-            auto validmatches = MultiCheckREInfo::validateMatchSetOptions(realmatches, checkops, sstr, spos);
-            return !validmatches.empty();
+        std::optional<std::pair<int64_t, int64_t>> matchContainsFirst(TStr* sstr, int64_t spos, int64_t epos) override final
+        {
+            //CANNOT HAPPEN -- by def a matchable is a single option that is not negative or front/back marked
+            return std::nullopt;
         }
 
-        bool testBack(TStr* sstr, int64_t spos, int64_t epos) override final
+        std::optional<std::pair<int64_t, int64_t>> matchContainsLast(TStr* sstr, int64_t spos, int64_t epos) override final
         {
-            std::vector<SingleCheckREInfo<TStr, TIter>*> matchopts;
-            std::vector<SingleCheckREInfo<TStr, TIter>*> checkops;
-            this->splitBindingOps(matchopts, checkops);
+            //CANNOT HAPPEN -- by def a matchable is a single option that is not negative or front/back marked
+            return std::nullopt;
+        }
 
-            std::vector<int64_t> realmatches;
-            if(matchopts.size() == 1) {
-                realmatches = matchopts.front()->executor.matchReverse(sstr, spos, epos);
-            }
-            else {
-                std::vector<std::vector<int64_t>> matches;
-                std::transform(matchopts.cbegin(), matchopts.cend(), std::back_inserter(matches), [sstr, spos, epos](SingleCheckREInfo<TStr, TIter>* check) {
-                    return check->executor.matchReverse(sstr, spos, epos);
-                });
+        std::vector<int64_t> matchFront(TStr* sstr, int64_t spos, int64_t epos) override final
+        {
+            return this->lockStepMatches(sstr, spos, epos, true);
+        }
 
-                realmatches = MultiCheckREInfo::computeSharedMatches(matches);
-            }
+        std::vector<int64_t> matchBack(TStr* sstr, int64_t spos, int64_t epos) override final
+        {
+            return this->lockStepMatches(sstr, spos, epos, false);
+        }
 
-            auto validmatches = MultiCheckREInfo::validateMatchSetOptions(realmatches, checkops, sstr, spos);
-            return !validmatches.empty();
+        std::optional<int64_t> matchFrontEnd(TStr* sstr, int64_t spos, int64_t epos, MatchMode mode) override final
+        {
+            return this->lockStepMatch(sstr, spos, epos, true, mode);
         }
 
-        std::vector<std::pair<int64_t, int64_t>> matchContains(TStr* sstr, int64_t spos, int64_t epos) override final
+        std::optional<int64_t> matchBackStart(TStr* sstr, int64_t spos, int64_t epos, MatchMode mode) override final
         {
-            //CANNOT HAPPEN -- by def a matchable is a single option that is not negative or front/back marked
-            return std::vector<std::pair<int64_t, int64_t>>{};
+            return this->lockStepMatch(sstr, spos, epos, false, mode);
         }
 
-        std::vector<int64_t> matchFront(TStr* sstr, int64_t spos, int64_t epos) override final
+        //a stream is a forward lock-step run of all the checks that is stepped one char at a time
+        void streamStart() override final
         {
-            std::vector<SingleCheckREInfo<TStr, TIter>*> matchopts;
-            std::vector<SingleCheckREInfo<TStr, TIter>*> checkops;
-            this->splitBindingOps(matchopts, checkops);
+            this->streamrunning.assign(this->checks.size(), true);
+            for(size_t i = 0; i < this->checks.size(); ++i) {
+                this->checks[i]->executor.startLockStep(true, MultiCheckREInfo::isFloatingCheck(this->checks[i], true));
+            }
 
-            std::vector<int64_t> realmatches;
-            if(matchopts.size() == 1) {
-                realmatches = matchopts.front()->executor.matchForward(sstr, spos, epos);
+            this->streamlive = this->settleChecks(true, this->streamrunning);
+        }
+
+        void streamStep(RegexChar c) override final
+        {
+            if(!this->streamlive) {
+                return;
             }
-            else {
-                std::vector<std::vector<int64_t>> matches;
-                std::transform(matchopts.cbegin(), matchopts.cend(), std::back_inserter(matches), [sstr, spos, epos](SingleCheckREInfo<TStr, TIter>* check) {
-                    return check->executor.matchForward(sstr, spos, epos);
-                });
 
-                realmatches = MultiCheckREInfo::computeSharedMatches(matches);
+            for(size_t i = 0; i < this->checks.size(); ++i) {
+                if(this->streamrunning[i]) {
+                    this->checks[i]->executor.stepLockStep(c, MultiCheckREInfo::isFloatingCheck(this->checks[i], true));
+                }
             }
 
-            return MultiCheckREInfo::validateMatchSetOptions(realmatches, checkops, sstr, spos);
+            this->streamlive = this->settleChecks(true, this->streamrunning);
         }
 
-        std::vector<int64_t> matchBack(TStr* sstr, int64_t spos, int64_t epos) override final
+        bool streamAccepted() const override final
+        {
+            return this->streamlive && this->allChecksHold(true, this->streamrunning);
+        }
+
+        bool streamLive() const override final
         {
-            std::vector<SingleCheckREInfo<TStr, TIter>*> matchopts;
-            std::vector<SingleCheckREInfo<TStr, TIter>*> checkops;
-            this->splitBindingOps(matchopts, checkops);
+            return this->streamlive;
+        }
 
-            std::vector<int64_t> realmatches;
-            if(matchopts.size() == 1) {
-                realmatches = matchopts.front()->executor.matchReverse(sstr, spos, epos);
+        void testBits(TStr* sstr, int64_t spos, int64_t epos, bool forward, std::vector<bool>& bits) override final
+        {
+            //a range passes when it passes every check so we and the bits of the checks
+            std::vector<bool> cbits;
+            bits.assign((size_t)(epos - spos + 2), true);
+            for(auto iter = this->checks.begin(); iter != this->checks.end(); ++iter) {
+                (*iter)->testBits(sstr, spos, epos, forward, cbits);
+                for(size_t i = 0; i < bits.size(); ++i) {
+                    bits[i] = bits[i] && cbits[i];
+                }
             }
-            else {
-                std::vector<std::vector<int64_t>> matches;
-                std::transform(matchopts.cbegin(), matchopts.cend(), std::back_inserter(matches), [sstr, spos, epos](SingleCheckREInfo<TStr, TIter>* check) {
-                    return check->executor.matchReverse(sstr, spos, epos);
-                });
+        }
 
-                realmatches = MultiCheckREInfo::computeSharedMatches(matches);
+        void testBackBits(TStr* sstr, int64_t spos, int64_t epos, std::vector<bool>& bits) override final
+        {
+            if(this->runMergedAcceptBits(sstr, spos, epos, true, bits)) {
+                return;
             }
 
-            return MultiCheckREInfo::validateMatchSetOptions(realmatches, checkops, sstr, spos);
+            //otherwise a reverse lock-step run from the end of each char
+            bits.assign((size_t)(epos - spos + 2), false);
+            TIter iter{sstr, spos, epos, spos};
+            while(iter.valid()) {
+                iter.inc();
+                bits[(size_t)(iter.curr - spos)] = this->testBack(sstr, spos, iter.curr - 1);
+            }
+        }
+
+        void testFrontBits(TStr* sstr, int64_t spos, int64_t epos, std::vector<bool>& bits) override final
+        {
+            if(this->runMergedAcceptBits(sstr, spos, epos, false, bits)) {
+                return;
+            }
+
+            //otherwise a forward lock-step run from the start of each char
+            bits.assign((size_t)(epos - spos + 2), false);
+            TIter iter{sstr, spos, epos, epos + 1};
+            iter.dec();
+            while(iter.valid()) {
+                bits[(size_t)(iter.curr - spos)] = this->testFront(sstr, iter.curr, epos);
+                iter.dec();
+            }
         }
     };
 
@@ -408,6 +845,46 @@ namespace brex
             }
         }
 
+        //keep the options that pass the pre/post checks -- each check runs once over the string into a bitmap and the options just look up their positions in it
+        //for a test the checks are on the whole range before/after the option otherwise (contains) a pre check is on some range that ends before it and a post check on some range that starts after it
+        std::vector<std::pair<int64_t, int64_t>> filterAnchoredOptions(TStr* sstr, int64_t spos, int64_t epos, const std::vector<std::pair<int64_t, int64_t>>& opts, bool fullrange)
+        {
+            std::vector<std::pair<int64_t, int64_t>> mmr;
+            if(opts.empty()) {
+                return mmr;
+            }
+
+            std::vector<bool> prebits;
+            if(this->optPre != nullptr) {
+                if(fullrange) {
+                    this->optPre->testBits(sstr, spos, epos, true, prebits);
+                }
+                else {
+                    this->optPre->testBackBits(sstr, spos, epos, prebits);
+                }
+            }
+
+            std::vector<bool> postbits;
+            if(this->optPost != nullptr) {
+                if(fullrange) {
+                    this->optPost->testBits(sstr, spos, epos, false, postbits);
+                }
+                else {
+                    this->optPost->testFrontBits(sstr, spos, epos, postbits);
+                }
+            }
+
+            //an option ends on the last byte of its last char so the range after it starts at opt.second + 1 (see common.h)
+            std::copy_if(opts.cbegin(), opts.cend(), std::back_inserter(mmr), [this, spos, &prebits, &postbits](const std::pair<int64_t, int64_t>& opt) {
+                bool prechk = this->optPre == nullptr || prebits[(size_t)(opt.first - spos)];
+                bool postchk = this->optPost == nullptr || postbits[(size_t)(opt.second + 1 - spos)];
+
+                return prechk && postchk;
+            });
+
+            return mmr;
+        }
+
         bool test(TStr* sstr, int64_t spos, int64_t epos, ExecutorError& error)
         {
             error = ExecutorError::Ok;
@@ -421,13 +898,7 @@ namespace brex
             }
             else {
                 auto opts = this->re->matchContains(sstr, spos, epos);
-
-                return std::any_of(opts.cbegin(), opts.cend(), [this, sstr, spos, epos](const std::pair<int64_t, int64_t>& opt) {
-                    bool prechk = this->optPre == nullptr || this->optPre->test(sstr, spos, opt.first - 1);
-                    bool postchk = this->optPost == nullptr || this->optPost->test(sstr, opt.second + 1, epos);
-
-                    return prechk && postchk;
-                });
+                return !this->filterAnchoredOptions(sstr, spos, epos, opts, true).empty();
             }
         }
         
@@ -444,13 +915,7 @@ namespace brex
             }
             else {
                 auto opts = this->re->matchContains(sstr, spos, epos);
-
-                return std::any_of(opts.cbegin(), opts.cend(), [this, sstr, spos, epos](const std::pair<int64_t, int64_t>& opt) {
-                    bool prechk = this->optPre == nullptr || this->optPre->testBack(sstr, spos, opt.first - 1);
-                    bool postchk = this->optPost == nullptr || this->optPost->testFront(sstr, opt.second + 1, epos);
-
-                    return prechk && postchk;
-                });
+                return !this->filterAnchoredOptions(sstr, spos, epos, opts, false).empty();
             }
         }
 
@@ -467,9 +932,14 @@ namespace brex
             }
             else {
                 auto opts = this->re->matchFront(sstr, spos, epos);
+                if(opts.empty()) {
+                    return false;
+                }
 
-                return std::any_of(opts.cbegin(), opts.cend(), [this, sstr, epos](const int64_t opt) {
-                    return this->optPost->testFront(sstr, opt + 1, epos);
+                std::vector<bool> postbits;
+                this->optPost->testFrontBits(sstr, spos, epos, postbits);
+                return std::any_of(opts.cbegin(), opts.cend(), [spos, &postbits](const int64_t opt) {
+                    return postbits[(size_t)(opt + 1 - spos)];
                 });
             }
         }
@@ -487,9 +957,14 @@ namespace brex
             }
             else {
                 auto opts = this->re->matchBack(sstr, spos, epos);
+                if(opts.empty()) {
+                    return false;
+                }
 
-                return std::any_of(opts.cbegin(), opts.cend(), [this, sstr, spos](const int64_t opt) {
-                    return this->optPre->testBack(sstr, spos, opt - 1);
+                std::vector<bool> prebits;
+                this->optPre->testBackBits(sstr, spos, epos, prebits);
+                return std::any_of(opts.cbegin(), opts.cend(), [spos, &prebits](const int64_t opt) {
+                    return prebits[(size_t)(opt - spos)];
                 });
             }
         }
@@ -502,20 +977,13 @@ namespace brex
                 return std::nullopt;
             }
 
-            std::vector<std::pair<int64_t, int64_t>> mmr;
             if(this->optPre == nullptr && this->optPost == nullptr) {
-                mmr = this->re->matchContains(sstr, spos, epos);
+                return this->re->matchContainsFirst(sstr, spos, epos);
             }
-            else {
-                auto opts = this->re->matchContains(sstr, spos, epos);
 
-                std::copy_if(opts.cbegin(), opts.cend(), std::back_inserter(mmr), [this, sstr, spos, epos](const std::pair<int64_t, int64_t>& opt) {
-                    bool prechk = this->optPre == nullptr || this->optPre->testBack(sstr, spos, opt.first - 1);
-                    bool postchk = this->optPost == nullptr || this->optPost->testFront(sstr, opt.second + 1, epos);
-
-                    return prechk && postchk;
-                });
-            }
+            //the pre/post checks can reject the first/last match so we need all the options here
+            auto opts = this->re->matchContains(sstr, spos, epos);
+            auto mmr = this->filterAnchoredOptions(sstr, spos, epos, opts, false);
 
             if(mmr.empty()) {
                 return std::nullopt;
@@ -546,20 +1014,13 @@ namespace brex
                 return std::nullopt;
             }
 
-            std::vector<std::pair<int64_t, int64_t>> mmr;
             if(this->optPre == nullptr && this->optPost == nullptr) {
-                mmr = this->re->matchContains(sstr, spos, epos);
+                return this->re->matchContainsLast(sstr, spos, epos);
             }
-            else {
-                auto opts = this->re->matchContains(sstr, spos, epos);
 
-                std::copy_if(opts.cbegin(), opts.cend(), std::back_inserter(mmr), [this, sstr, spos, epos](const std::pair<int64_t, int64_t>& opt) {
-                    bool prechk = this->optPre == nullptr || this->optPre->testBack(sstr, spos, opt.first - 1);
-                    bool postchk = this->optPost == nullptr || this->optPost->testFront(sstr, opt.second + 1, epos);
-
-                    return prechk && postchk;
-                });
-            }
+            //the pre/post checks can reject the first/last match so we need all the options here
+            auto opts = this->re->matchContains(sstr, spos, epos);
+            auto mmr = this->filterAnchoredOptions(sstr, spos, epos, opts, false);
 
             if(mmr.empty()) {
                 return std::nullopt;
@@ -582,7 +1043,7 @@ namespace brex
             return std::make_optional(maxmmr.front());
         }
 
-        std::optional<int64_t> matchFront(TStr* sstr, int64_t spos, int64_t epos, ExecutorError& error)
+        std::optional<int64_t> matchFront(TStr* sstr, int64_t spos, int64_t epos, ExecutorError& error, MatchMode mode = MatchMode::Longest)
         {
             error = ExecutorError::Ok;
             if(!this->declre->canStartsOperation()) {
@@ -590,22 +1051,34 @@ namespace brex
                 return std::nullopt;
             }
 
-            std::vector<int64_t> mmr;
             if(this->optPost == nullptr) {
-                mmr = this->re->matchFront(sstr, spos, epos);
+                return this->re->matchFrontEnd(sstr, spos, epos, mode);
             }
-            else {
-                auto opts = this->re->matchFront(sstr, spos, epos);
 
-                std::copy_if(opts.cbegin(), opts.cend(), std::back_inserter(mmr), [this, sstr, epos](const int64_t opt) {
-                    return this->optPost->testFront(sstr, opt + 1, epos);
-                });
+            auto opts = this->re->matchFront(sstr, spos, epos);
+            if(opts.empty()) {
+                return std::nullopt;
             }
 
-            return !mmr.empty() ? std::make_optional(mmr.back()) : std::nullopt;
+            std::vector<bool> postbits;
+            this->optPost->testFrontBits(sstr, spos, epos, postbits);
+
+            //the options go from the shortest to the longest match
+            auto chkfn = [spos, &postbits](const int64_t opt) {
+                return postbits[(size_t)(opt + 1 - spos)];
+            };
+
+            if(mode == MatchMode::Shortest) {
+                auto miter = std::find_if(opts.cbegin(), opts.cend(), chkfn);
+                return miter != opts.cend() ? std::make_optional(*miter) : std::nullopt;
+            }
+            else {
+                auto miter = std::find_if(opts.crbegin(), opts.crend(), chkfn);
+                return miter != opts.crend() ? std::make_optional(*miter) : std::nullopt;
+            }
         }
 
-        std::optional<int64_t> matchBack(TStr* sstr, int64_t spos, int64_t epos, ExecutorError& error)
+        std::optional<int64_t> matchBack(TStr* sstr, int64_t spos, int64_t epos, ExecutorError& error, MatchMode mode = MatchMode::Longest)
         {
             error = ExecutorError::Ok;
             if(!this->declre->canEndOperation()) {
@@ -613,19 +1086,31 @@ namespace brex
                 return std::nullopt;
             }
 
-            std::vector<int64_t> mmr;
             if(this->optPre == nullptr) {
-                mmr = this->re->matchBack(sstr, spos, epos);
+                return this->re->matchBackStart(sstr, spos, epos, mode);
             }
-            else {
-                auto opts = this->re->matchBack(sstr, spos, epos);
 
-                std::copy_if(opts.cbegin(), opts.cend(), std::back_inserter(mmr), [this, sstr, spos](const int64_t opt) {
-                    return this->optPre->testBack(sstr, spos, opt - 1);
-                });
+            auto opts = this->re->matchBack(sstr, spos, epos);
+            if(opts.empty()) {
+                return std::nullopt;
             }
 
-            return !mmr.empty() ? std::make_optional(mmr.back()) : std::nullopt;
+            std::vector<bool> prebits;
+            this->optPre->testBackBits(sstr, spos, epos, prebits);
+
+            //the options go from the shortest to the longest match
+            auto chkfn = [spos, &prebits](const int64_t opt) {
+                return prebits[(size_t)(opt - spos)];
+            };
+
+            if(mode == MatchMode::Shortest) {
+                auto miter = std::find_if(opts.cbegin(), opts.cend(), chkfn);
+                return miter != opts.cend() ? std::make_optional(*miter) : std::nullopt;
+            }
+            else {
+                auto miter = std::find_if(opts.crbegin(), opts.crend(), chkfn);
+                return miter != opts.crend() ? std::make_optional(*miter) : std::nullopt;
+            }
         }
 
         bool test(TStr* sstr, ExecutorError& error) { return this->test(sstr, 0, (int64_t)sstr->size() - 1, error); }
@@ -636,10 +1121,199 @@ namespace brex
 
         std::optional<std::pair<int64_t, int64_t>> matchContainsFirst(TStr* sstr, ExecutorError& error) { return this->matchContainsFirst(sstr, 0, (int64_t)sstr->size() - 1, error); }
         std::optional<std::pair<int64_t, int64_t>> matchContainsLast(TStr* sstr, ExecutorError& error) { return this->matchContainsLast(sstr, 0, (int64_t)sstr->size() - 1, error); }
-        std::optional<int64_t> matchFront(TStr* sstr, ExecutorError& error) { return this->matchFront(sstr, 0, (int64_t)sstr->size() - 1, error); }
-        std::optional<int64_t> matchBack(TStr* sstr, ExecutorError& error) { return this->matchBack(sstr, 0, (int64_t)sstr->size() - 1, error); }
+        std::optional<int64_t> matchFront(TStr* sstr, ExecutorError& error, MatchMode mode = MatchMode::Longest) { return this->matchFront(sstr, 0, (int64_t)sstr->size() - 1, error, mode); }
+        std::optional<int64_t> matchBack(TStr* sstr, ExecutorError& error, MatchMode mode = MatchMode::Longest) { return this->matchBack(sstr, 0, (int64_t)sstr->size() - 1, error, mode); }
+    };
+
+    //A set of regexes that are tested together -- matches gives the indices (increasing) of the regexes that accept the string
+    //The regexes that are a single plain (or negated) entry are all run in one pass of the SetMachine and the others (anchors, conjunctions, front/back checks) are tested on their own
+    template <typename TStr, typename TIter, bool isunicode>
+    class RegexSet
+    {
+    private:
+        NFAStepScratch scratch;
+
+        void matchMachine(TStr* sstr, int64_t spos, int64_t epos, std::vector<size_t>& accepted)
+        {
+            TIter iter{sstr, spos, epos, spos};
+
+            std::vector<size_t> maccepted;
+            if(this->machine->hasDFA()) {
+                DFAStateID dstate = 0;
+                while(iter.valid() && !this->machine->isDead(dstate)) {
+                    dstate = this->machine->step(dstate, iter.get());
+                    iter.inc();
+                }
+
+                maccepted = this->machine->accepts[dstate];
+            }
+            else {
+                const NFAMachine* nfa = this->machine->nfa;
+
+                nfa->intitializeMachine(this->scratch);
+                while(iter.valid() && !nfa->allRejected(this->scratch.getCurrentState())) {
+                    nfa->stepMachine(iter.get(), this->scratch);
+                    iter.inc();
+                }
+
+                this->machine->acceptedPatterns(this->scratch.getCurrentState(), maccepted);
+            }
+
+            //a negated regex is in the set when its pattern did not accept
+            auto miter = maccepted.cbegin();
+            for(size_t pidx = 0; pidx < this->machineregexes.size(); ++pidx) {
+                const bool pacc = (miter != maccepted.cend() && *miter == pidx);
+                if(pacc) {
+                    miter++;
+                }
+
+                if(pacc != this->machinenegated[pidx]) {
+                    accepted.push_back(this->machineregexes[pidx]);
+                }
+            }
+        }
+
+    public:
+        const size_t regexcount;
+
+        //the machine for the plain regexes (nullptr if there are none) and the index in the set of each of its patterns and if it is negated
+        SetMachine* machine;
+        std::vector<size_t> machineregexes;
+        std::vector<bool> machinenegated;
+
+        //the other regexes with their index in the set
+        std::vector<std::pair<size_t, REExecutor<TStr, TIter, isunicode>*>> separate;
+
+        RegexSet(size_t regexcount, SetMachine* machine, std::vector<size_t> machineregexes, std::vector<bool> machinenegated, std::vector<std::pair<size_t, REExecutor<TStr, TIter, isunicode>*>> separate) : scratch(), regexcount(regexcount), machine(machine), machineregexes(machineregexes), machinenegated(machinenegated), separate(separate) {;}
+        ~RegexSet() = default;
+
+        std::vector<size_t> matches(TStr* sstr, int64_t spos, int64_t epos, ExecutorError& error)
+        {
+            error = ExecutorError::Ok;
+
+            std::vector<size_t> accepted;
+            if(this->machine != nullptr) {
+                this->matchMachine(sstr, spos, epos, accepted);
+            }
+
+            std::for_each(this->separate.begin(), this->separate.end(), [sstr, spos, epos, &error, &accepted](std::pair<size_t, REExecutor<TStr, TIter, isunicode>*>& sre) {
+                ExecutorError serror = ExecutorError::Ok;
+                if(sre.second->test(sstr, spos, epos, serror)) {
+                    accepted.push_back(sre.first);
+                }
+
+                if(serror != ExecutorError::Ok) {
+                    error = serror;
+                }
+            });
+
+            std::sort(accepted.begin(), accepted.end());
+            return accepted;
+        }
+
+        std::vector<size_t> matches(TStr* sstr, ExecutorError& error) { return this->matches(sstr, 0, (int64_t)sstr->size() - 1, error); }
+    };
+
+    //Test a regex on a string that arrives in chunks (from a socket or a large file) without buffering it -- feed each chunk and then finish for the result
+    //The run is over the executor's own machines so the executor cannot be used for anything else until the stream is finished (or reset)
+    //If the machine runs on code points then a utf8 char that is split across chunks is held until its last byte arrives
+    template <typename TStr, typename TIter, bool isunicode>
+    class StreamMatcher
+    {
+    private:
+        REExecutor<TStr, TIter, isunicode>* executor;
+
+        //the bytes seen so far of a char that is split across chunks
+        std::array<uint8_t, 4> pending;
+        size_t pendingcount;
+
+        bool live;
+
+        inline void stepChar(RegexChar c)
+        {
+            this->executor->re->streamStep(c);
+            this->live = this->executor->re->streamLive();
+        }
+
+    public:
+        //true if the machine runs on code points (and not on bytes)
+        static constexpr bool decodeutf8 = std::is_same<TIter, UnicodeRegexIterator>::value;
+
+        StreamMatcher(REExecutor<TStr, TIter, isunicode>* executor) : executor(executor), pending(), pendingcount(0), live(false)
+        {
+            this->reset();
+        }
+        ~StreamMatcher() = default;
+
+        //the matcher for the executor or nullptr (with the error set) if it cannot be used in a test or it has pre/post anchors (which need the whole string)
+        static StreamMatcher* create(REExecutor<TStr, TIter, isunicode>* executor, ExecutorError& error)
+        {
+            error = ExecutorError::Ok;
+            if(!executor->declre->canUseInTestOperation() || executor->optPre != nullptr || executor->optPost != nullptr) {
+                error = ExecutorError::InvalidRegexStructure;
+                return nullptr;
+            }
+
+            return new StreamMatcher(executor);
+        }
+
+        //start over on a new string
+        void reset()
+        {
+            this->pendingcount = 0;
+            this->executor->re->streamStart();
+            this->live = this->executor->re->streamLive();
+        }
+
+        //the next chunk of the string -- returns canStillMatch() so the caller can stop reading as soon as the string is rejected
+        bool feed(const TStr* chunk)
+        {
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(chunk->data());
+            const size_t size = chunk->size();
+            for(size_t i = 0; i < size && this->live; ++i) {
+                const uint8_t b = data[i];
+                if(!StreamMatcher::decodeutf8 || (this->pendingcount == 0 && UTF8_IS_SINGLEBYTE_ENCODING(b))) {
+                    this->stepChar((RegexChar)b);
+                    continue;
+                }
+
+                this->pending[this->pendingcount++] = b;
+                if(this->pendingcount == charCodeByteCount(this->pending.data())) {
+                    this->stepChar(toRegexCharCodeFromBytes(this->pending.data(), this->pendingcount));
+                    this->pendingcount = 0;
+                }
+            }
+
+            return this->live;
+        }
+
+        //false once the string is rejected whatever comes after it
+        bool canStillMatch() const
+        {
+            return this->live;
+        }
+
+        //the end of the string -- true if it matches
+        bool finish()
+        {
+            if(this->pendingcount != 0 && this->live) {
+                //a char cut off at the end of the string decodes to 0 (as it does for the iterators)
+                this->stepChar(0);
+                this->pendingcount = 0;
+            }
+
+            return this->executor->re->streamAccepted();
+        }
     };
 
     typedef REExecutor<UnicodeString, UnicodeRegexIterator, true> UnicodeRegexExecutor;
+    typedef REExecutor<UnicodeString, UnicodeByteRegexIterator, true> UnicodeByteRegexExecutor;
     typedef REExecutor<CString, CRegexIterator, false> CRegexExecutor;
+
+    typedef RegexSet<UnicodeString, UnicodeRegexIterator, true> UnicodeRegexSet;
+    typedef RegexSet<CString, CRegexIterator, false> CRegexSet;
+
+    typedef StreamMatcher<UnicodeString, UnicodeRegexIterator, true> UnicodeStreamMatcher;
+    typedef StreamMatcher<UnicodeString, UnicodeByteRegexIterator, true> UnicodeByteStreamMatcher;
+    typedef StreamMatcher<CString, CRegexIterator, false> CStreamMatcher;
 }
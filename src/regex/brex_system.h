@@ -182,6 +182,9 @@ namespace brex
         std::vector<ReSystemEntry*> entries;
         std::map<std::string, std::vector<ReSystemEntry*>> depmap;
 
+        //the regexes that are referenced by other entries (filled in by processSystem)
+        std::map<std::string, const RegexOpt*> namedRegexes;
+
         ReSystem() {;}
         ~ReSystem() {;}
 
@@ -354,10 +357,9 @@ namespace brex
             }
 
             //compile the values
-            std::map<std::string, const RegexOpt*> namedRegexes;
             for(auto iter = rsystem.entries.begin(); iter != rsystem.entries.end(); ++iter) {
                 std::vector<std::string> pending;
-                if(!rsystem.processRERecursive(*iter, namedRegexes, errors, pending)) {
+                if(!rsystem.processRERecursive(*iter, rsystem.namedRegexes, errors, pending)) {
                     return rsystem;
                 }
             }
@@ -392,5 +394,117 @@ namespace brex
             auto uentry = static_cast<ReSystemCEntry*>(*iter);
             return uentry->executor;
         }
+
+        //find the entries for a set of regexes (all unicode or all char) and the resolver info for each of them -- false if one is missing or of the other kind
+        bool gatherSetEntries(const std::vector<std::string>& fullnames, bool isunicode, std::vector<ReSystemResolverInfo>& rmps, std::vector<const Regex*>& res, std::vector<std::u8string>& errors) const
+        {
+            bool ok = true;
+            std::for_each(fullnames.cbegin(), fullnames.cend(), [this, isunicode, &rmps, &res, &errors, &ok](const std::string& fullname) {
+                auto iter = std::find_if(this->entries.begin(), this->entries.end(), [&fullname](const ReSystemEntry* entry) {
+                    return entry->fullname == fullname;
+                });
+
+                if(iter == this->entries.end() || (*iter)->isUnicode() != isunicode) {
+                    errors.push_back((isunicode ? u8"No unicode regex named " : u8"No char regex named ") + std::u8string(fullname.cbegin(), fullname.cend()));
+                    ok = false;
+                }
+                else {
+                    rmps.push_back(ReSystemResolverInfo((*iter)->ns, &this->remapper));
+                    res.push_back((*iter)->re);
+                }
+            });
+
+            return ok;
+        }
+
+        //compile the regexes with the given full names into a set that tests them all in one pass -- the matches of the set are indices into fullnames
+        //processSystem must have succeeded
+        UnicodeRegexSet* compileUnicodeRESet(const std::vector<std::string>& fullnames, std::vector<std::u8string>& errors, const RegexCompilerOptions& options = RegexCompilerOptions())
+        {
+            std::vector<ReSystemResolverInfo> rmps;
+            std::vector<const Regex*> res;
+            if(!this->gatherSetEntries(fullnames, true, rmps, res, errors)) {
+                return nullptr;
+            }
+
+            std::vector<std::pair<const Regex*, NameResolverState>> setres;
+            for(size_t i = 0; i < res.size(); ++i) {
+                setres.push_back(std::make_pair(res[i], &rmps[i]));
+            }
+
+            std::vector<brex::RegexCompileError> compileerror;
+            auto rset = RegexCompiler::compileUnicodeRegexSet(setres, this->namedRegexes, {}, false, &ReSystem::resolveREName, compileerror, options);
+            std::transform(compileerror.begin(), compileerror.end(), std::back_inserter(errors), [](const RegexCompileError& rce) {
+                return rce.msg + u8" in regex set";
+            });
+
+            return rset;
+        }
+
+        CRegexSet* compileCStringRESet(const std::vector<std::string>& fullnames, std::vector<std::u8string>& errors, const RegexCompilerOptions& options = RegexCompilerOptions())
+        {
+            std::vector<ReSystemResolverInfo> rmps;
+            std::vector<const Regex*> res;
+            if(!this->gatherSetEntries(fullnames, false, rmps, res, errors)) {
+                return nullptr;
+            }
+
+            std::vector<std::pair<const Regex*, NameResolverState>> setres;
+            for(size_t i = 0; i < res.size(); ++i) {
+                setres.push_back(std::make_pair(res[i], &rmps[i]));
+            }
+
+            std::vector<brex::RegexCompileError> compileerror;
+            auto rset = RegexCompiler::compileCRegexSet(setres, this->namedRegexes, {}, false, &ReSystem::resolveREName, compileerror, options);
+            std::transform(compileerror.begin(), compileerror.end(), std::back_inserter(errors), [](const RegexCompileError& rce) {
+                return rce.msg + u8" in regex set";
+            });
+
+            return rset;
+        }
+
+        //compile an entry again with other options (e.g. for code generation where much larger DFAs are fine) -- processSystem must have succeeded
+        //unicode entries are compiled to run on their UTF-8 bytes
+        UnicodeByteRegexExecutor* compileUnicodeByteRE(const std::string& fullname, const RegexCompilerOptions& options, std::vector<std::u8string>& errors)
+        {
+            auto iter = std::find_if(this->entries.begin(), this->entries.end(), [fullname](const ReSystemEntry* entry) {
+                return entry->fullname == fullname;
+            });
+
+            if(iter == this->entries.end() || !(*iter)->isUnicode()) {
+                errors.push_back(u8"No unicode regex named " + std::u8string(fullname.cbegin(), fullname.cend()));
+                return nullptr;
+            }
+
+            auto rmp = ReSystemResolverInfo((*iter)->ns, &this->remapper);
+            std::vector<brex::RegexCompileError> compileerror;
+            auto executor = RegexCompiler::compileUnicodeRegexToByteExecutor((*iter)->re, this->namedRegexes, {}, false, &rmp, &ReSystem::resolveREName, compileerror, options);
+            std::transform(compileerror.begin(), compileerror.end(), std::back_inserter(errors), [&fullname](const RegexCompileError& rce) {
+                return rce.msg + u8" in regex " + std::u8string(fullname.cbegin(), fullname.cend());
+            });
+
+            return executor;
+        }
+
+        CRegexExecutor* compileCStringRE(const std::string& fullname, const RegexCompilerOptions& options, std::vector<std::u8string>& errors)
+        {
+            auto iter = std::find_if(this->entries.begin(), this->entries.end(), [fullname](const ReSystemEntry* entry) {
+                return entry->fullname == fullname;
+            });
+
+            if(iter == this->entries.end() || (*iter)->isUnicode()) {
+                errors.push_back(u8"No char regex named " + std::u8string(fullname.cbegin(), fullname.cend()));
+                return nullptr;
+            }
+
+            auto rmp = ReSystemResolverInfo((*iter)->ns, &this->remapper);
+            std::vector<brex::RegexCompileError> compileerror;
+            auto executor = RegexCompiler::compileCRegexToExecutor((*iter)->re, this->namedRegexes, {}, false, &rmp, &ReSystem::resolveREName, compileerror, options);
+            std::transform(compileerror.begin(), compileerror.end(), std::back_inserter(errors), [&fullname](const RegexCompileError& rce) {
+                return rce.msg + u8" in regex " + std::u8string(fullname.cbegin(), fullname.cend());
+            });
+
+            return executor;
+        }
     };
 }
@@ -0,0 +1,223 @@
+#include "brex.h"
+#include "brex_parser.h"
+#include "brex_compiler.h"
+#include "brex_system.h"
+#include "brex_codegen.h"
+
+#include <iostream>
+#include <fstream>
+
+void useage(std::optional<std::string> msg)
+{
+    if(msg.has_value()) {
+        std::cout << msg.value() << std::endl;
+    }
+
+    std::cout << "Usage: brexc [-o <file> -p <namespace> -n <name>] <regex>" << std::endl;
+    std::cout << "       brexc [-o <file> -p <namespace>] -s <system>" << std::endl;
+    std::cout << "  <regex> - The regex to generate a matcher for" << std::endl;
+    std::cout << "  <system> - A JSON file with the namespaces of a regex system -- [{\"ns\": \"Main\", \"remap\": {...}, \"regexes\": [{\"name\": \"Foo\", \"regex\": \"/.../\"}, ...]}, ...]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  -o - Write the generated C++ header to <file> (default stdout)" << std::endl;
+    std::cout << "  -p - The C++ namespace for the generated code (default brexgen)" << std::endl;
+    std::cout << "  -n - The name of the matcher for a single regex (default match)" << std::endl;
+    std::cout << "  -s - Generate matchers for every regex in a system file" << std::endl;
+    std::cout << "  -h - Print this help message" << std::endl;
+    std::exit(1);
+}
+
+bool processCmdLine(int argc, char** argv, std::optional<std::string>& re, std::optional<std::string>& system, std::string& out, std::string& nspace, std::string& name, std::string& helpmsg)
+{
+    out = "";
+    nspace = "brexgen";
+    name = "match";
+    helpmsg = "";
+
+    for(int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if(arg == "-h") {
+            return false;
+        }
+        else if(arg == "-o" || arg == "-p" || arg == "-n" || arg == "-s") {
+            if(i + 1 == argc) {
+                helpmsg = "Missing value for argument: " + arg;
+                return false;
+            }
+
+            std::string val = argv[++i];
+            if(arg == "-o") {
+                out = val;
+            }
+            else if(arg == "-p") {
+                nspace = val;
+            }
+            else if(arg == "-n") {
+                name = val;
+            }
+            else {
+                system = val;
+            }
+        }
+        else {
+            if(arg.starts_with("-")) {
+                helpmsg = "Unknown argument: " + arg;
+                return false;
+            }
+            else if(!re.has_value()) {
+                re = arg;
+            }
+            else {
+                helpmsg = "Unknown argument: " + arg;
+                return false;
+            }
+        }
+    }
+
+    if(re.has_value() == system.has_value()) {
+        helpmsg = "Specify exactly one of a regex or a system file (-s)";
+        return false;
+    }
+
+    return true;
+}
+
+bool generateSingle(const std::string& name, const std::string& re, brex::RegexCodeGenerator& generator)
+{
+    std::u8string ure(re.cbegin(), re.cend());
+    const bool isunicode = !ure.ends_with(u8"/c");
+
+    auto pr = isunicode ? brex::RegexParser::parseUnicodeRegex(ure, false) : brex::RegexParser::parseCRegex(ure, false);
+    if(!pr.first.has_value() || !pr.second.empty()) {
+        std::cout << "Parse errors in regex:" << std::endl;
+        for(auto iter = pr.second.begin(); iter != pr.second.end(); ++iter) {
+            std::cout << std::string(iter->msg.cbegin(), iter->msg.cend()) << std::endl;
+        }
+        return false;
+    }
+
+    std::map<std::string, const brex::RegexOpt*> emptymap;
+    std::map<std::string, const brex::LiteralOpt*> emptyenv;
+    std::vector<brex::RegexCompileError> compileerror;
+
+    std::string error;
+    bool ok = false;
+    if(isunicode) {
+        auto executor = brex::RegexCompiler::compileUnicodeRegexToByteExecutor(pr.first.value(), emptymap, emptyenv, false, nullptr, nullptr, compileerror, brex::RegexCodeGenerator::codegenOptions());
+        ok = compileerror.empty() && generator.addRegex(name, ure, executor, error);
+    }
+    else {
+        auto executor = brex::RegexCompiler::compileCRegexToExecutor(pr.first.value(), emptymap, emptyenv, false, nullptr, nullptr, compileerror, brex::RegexCodeGenerator::codegenOptions());
+        ok = compileerror.empty() && generator.addRegex(name, ure, executor, error);
+    }
+
+    if(!compileerror.empty()) {
+        std::cout << "Errors compiling regex:" << std::endl;
+        for(auto iter = compileerror.begin(); iter != compileerror.end(); ++iter) {
+            std::cout << std::string(iter->msg.cbegin(), iter->msg.cend()) << std::endl;
+        }
+    }
+    else if(!ok) {
+        std::cout << "Cannot generate code for regex -- " << error << std::endl;
+    }
+
+    return ok;
+}
+
+bool generateSystem(const std::string& file, brex::RegexCodeGenerator& generator)
+{
+    std::vector<brex::RENSInfo> sinfo;
+    try {
+        std::ifstream istr(file);
+        json jsys = json::parse(istr);
+
+        for(auto nsiter = jsys.cbegin(); nsiter != jsys.cend(); ++nsiter) {
+            std::vector<std::pair<std::string, std::string>> nsmappings;
+            if(nsiter->contains("remap")) {
+                auto jremap = (*nsiter)["remap"];
+                for(auto riter = jremap.cbegin(); riter != jremap.cend(); ++riter) {
+                    nsmappings.push_back({ riter.key(), riter.value().get<std::string>() });
+                }
+            }
+
+            std::vector<brex::REInfo> reinfos;
+            auto jres = (*nsiter)["regexes"];
+            for(auto riter = jres.cbegin(); riter != jres.cend(); ++riter) {
+                std::string restr = (*riter)["regex"].get<std::string>();
+                reinfos.push_back(brex::REInfo{ (*riter)["name"].get<std::string>(), std::u8string(restr.cbegin(), restr.cend()) });
+            }
+
+            sinfo.push_back(brex::RENSInfo{ brex::NSRemapInfo{ (*nsiter)["ns"].get<std::string>(), nsmappings }, reinfos });
+        }
+    }
+    catch(const std::exception& e) {
+        std::cout << "Error reading system file: " << e.what() << std::endl;
+        return false;
+    }
+
+    std::vector<std::u8string> errors;
+    auto rsystem = brex::ReSystem::processSystem(sinfo, errors);
+
+    for(auto iter = rsystem.entries.cbegin(); iter != rsystem.entries.cend() && errors.empty(); ++iter) {
+        const brex::ReSystemEntry* entry = *iter;
+
+        std::string error;
+        bool ok = false;
+        if(entry->isUnicode()) {
+            auto executor = rsystem.compileUnicodeByteRE(entry->fullname, brex::RegexCodeGenerator::codegenOptions(), errors);
+            ok = errors.empty() && generator.addRegex(entry->fullname, static_cast<const brex::ReSystemUnicodeEntry*>(entry)->restr, executor, error);
+        }
+        else {
+            auto executor = rsystem.compileCStringRE(entry->fullname, brex::RegexCodeGenerator::codegenOptions(), errors);
+            ok = errors.empty() && generator.addRegex(entry->fullname, static_cast<const brex::ReSystemCEntry*>(entry)->restr, executor, error);
+        }
+
+        if(errors.empty() && !ok) {
+            errors.push_back(u8"Cannot generate code for " + std::u8string(entry->fullname.cbegin(), entry->fullname.cend()) + u8" -- " + std::u8string(error.cbegin(), error.cend()));
+        }
+    }
+
+    if(!errors.empty()) {
+        std::cout << "Errors in regex system:" << std::endl;
+        for(auto iter = errors.begin(); iter != errors.end(); ++iter) {
+            std::cout << std::string(iter->cbegin(), iter->cend()) << std::endl;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    std::optional<std::string> re;
+    std::optional<std::string> system;
+    std::string out;
+    std::string nspace;
+    std::string name;
+    std::string helpmsg;
+
+    if(!processCmdLine(argc, argv, re, system, out, nspace, name, helpmsg)) {
+        useage(!helpmsg.empty() ? std::optional<std::string>(helpmsg) : std::nullopt);
+    }
+
+    brex::RegexCodeGenerator generator(nspace);
+    const bool ok = re.has_value() ? generateSingle(name, re.value(), generator) : generateSystem(system.value(), generator);
+    if(!ok) {
+        return 1;
+    }
+
+    if(out.empty()) {
+        std::cout << generator.emit();
+    }
+    else {
+        std::ofstream ostr(out);
+        ostr << generator.emit();
+        if(!ostr) {
+            std::cout << "Error writing output file: " << out << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
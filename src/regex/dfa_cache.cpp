@@ -0,0 +1,93 @@
+#include "dfa_cache.h"
+
+namespace brex
+{
+    LazyDFACache* LazyDFACache::tryCreateCache(const NFAMachine* m, size_t budget)
+    {
+        if(!m->counterfree) {
+            return nullptr;
+        }
+
+        return new LazyDFACache(m, budget);
+    }
+
+    void LazyDFACache::clearCache()
+    {
+        this->states.clear();
+        this->transitions.clear();
+        this->stateids.clear();
+        this->usedbytes = 0;
+
+        this->startstate = UNKNOWN_TRANSITION;
+
+        this->clearcount++;
+        this->charssinceclear = 0;
+    }
+
+    DFAStateID LazyDFACache::internState(std::vector<StateID>&& nfastates)
+    {
+        auto iter = this->stateids.find(nfastates);
+        if(iter != this->stateids.end()) {
+            return iter->second;
+        }
+
+        //the state set is stored in both the map key and the state info
+        const size_t cost = sizeof(DFAStateInfo) + (2 * nfastates.size() * sizeof(StateID)) + (this->nclasses * sizeof(DFAStateID));
+        if(this->usedbytes + cost > this->budget && !this->states.empty()) {
+            bool thrashing = this->clearcount >= MIN_CLEARS_FOR_FAIL && this->charssinceclear < THRASH_FACTOR * this->states.size();
+
+            this->clearCache();
+            if(thrashing) {
+                this->failed = true;
+                return UNKNOWN_TRANSITION;
+            }
+        }
+
+        const DFAStateID dstate = (DFAStateID)this->states.size();
+        const bool accepting = std::binary_search(nfastates.cbegin(), nfastates.cend(), this->m->acceptstate);
+        const bool dead = nfastates.empty();
+
+        this->stateids.insert({ nfastates, dstate });
+        this->states.push_back(DFAStateInfo{ std::move(nfastates), accepting, dead });
+        this->transitions.resize(this->transitions.size() + this->nclasses, UNKNOWN_TRANSITION);
+        this->usedbytes += cost;
+
+        return dstate;
+    }
+
+    DFAStateID LazyDFACache::getStartState()
+    {
+        if(this->startstate == UNKNOWN_TRANSITION) {
+            NFAState nstates;
+            this->m->intitializeMachine(nstates);
+
+            this->startstate = this->internState(nstates.toSortedSimpleStates());
+        }
+
+        return this->startstate;
+    }
+
+    bool LazyDFACache::computeTransition(DFAStateID& dstate, uint32_t cls, NFAState& nstates)
+    {
+        NFAState ostates(this->m->nfaopts.size());
+        ostates.loadSimpleStates(this->states[dstate].nfastates);
+
+        //every char in the class behaves the same so we step on the low char
+        NFAState next = this->m->stepMachine(this->m->charclasses.classlows[cls], ostates);
+
+        const size_t oclearcount = this->clearcount;
+        const DFAStateID ndstate = this->internState(next.toSortedSimpleStates());
+        if(ndstate == UNKNOWN_TRANSITION) {
+            nstates = std::move(next);
+            return false;
+        }
+
+        //if the cache was cleared then the source state no longer exists so we can only record the transition if it did not
+        if(oclearcount == this->clearcount) {
+            this->transitions[(dstate * this->nclasses) + cls] = ndstate;
+        }
+
+        dstate = ndstate;
+        return true;
+    }
+}
@@ -0,0 +1,243 @@
+#include "dfa_machine.h"
+
+namespace brex
+{
+    bool DFAMachine::buildSubsetMachine(const NFAMachine* m, size_t maxstates, std::vector<DFAStateID>& transitions, std::vector<std::vector<StateID>>& statesets, DFAStateID& deadstate)
+    {
+        const std::vector<RegexChar>& classlows = m->charclasses.classlows;
+        const size_t nclasses = classlows.size();
+
+        std::map<std::vector<StateID>, DFAStateID> stateids;
+
+        NFAState istates;
+        m->intitializeMachine(istates);
+
+        statesets.push_back(istates.toSortedSimpleStates());
+        stateids.insert({ statesets.back(), 0 });
+
+        //states are numbered in discovery order so the worklist is just the tail of statesets
+        for(size_t i = 0; i < statesets.size(); ++i) {
+            transitions.resize(transitions.size() + nclasses, 0);
+
+            for(size_t k = 0; k < nclasses; ++k) {
+                NFAState ostates(m->nfaopts.size());
+                ostates.loadSimpleStates(statesets[i]);
+
+                NFAState nstates = m->stepMachine(classlows[k], ostates);
+                std::vector<StateID> nset = nstates.toSortedSimpleStates();
+
+                auto iter = stateids.find(nset);
+                if(iter != stateids.end()) {
+                    transitions[(i * nclasses) + k] = iter->second;
+                }
+                else {
+                    if(statesets.size() >= maxstates) {
+                        return false;
+                    }
+
+                    const DFAStateID nid = (DFAStateID)statesets.size();
+                    stateids.insert({ nset, nid });
+                    statesets.push_back(std::move(nset));
+
+                    transitions[(i * nclasses) + k] = nid;
+                }
+            }
+        }
+
+        deadstate = -1;
+        for(size_t i = 0; i < statesets.size(); ++i) {
+            if(statesets[i].empty()) {
+                deadstate = (DFAStateID)i;
+            }
+        }
+
+        return true;
+    }
+
+    void DFAMachine::minimize(size_t nclasses, const std::vector<DFAStateID>& transitions, const std::vector<bool>& accepting, std::vector<DFAStateID>& blockof, size_t& nblocks)
+    {
+        const size_t nstates = accepting.size();
+
+        //inverse transitions for each class in CSR form -- preds of q on class k are predlist[predoffsets[k][q] .. predoffsets[k][q + 1])
+        std::vector<std::vector<size_t>> predoffsets(nclasses, std::vector<size_t>(nstates + 1, 0));
+        std::vector<std::vector<DFAStateID>> predlists(nclasses, std::vector<DFAStateID>(nstates, 0));
+        for(size_t k = 0; k < nclasses; ++k) {
+            for(size_t q = 0; q < nstates; ++q) {
+                predoffsets[k][transitions[(q * nclasses) + k] + 1]++;
+            }
+            for(size_t q = 0; q < nstates; ++q) {
+                predoffsets[k][q + 1] += predoffsets[k][q];
+            }
+
+            std::vector<size_t> fill(predoffsets[k].cbegin(), predoffsets[k].cend() - 1);
+            for(size_t q = 0; q < nstates; ++q) {
+                const DFAStateID tgt = transitions[(q * nclasses) + k];
+                predlists[k][fill[tgt]++] = (DFAStateID)q;
+            }
+        }
+
+        //initial partition is accepting and non-accepting states
+        std::vector<std::vector<DFAStateID>> blocks;
+        blockof.assign(nstates, 0);
+
+        std::vector<DFAStateID> acc;
+        std::vector<DFAStateID> nonacc;
+        for(size_t q = 0; q < nstates; ++q) {
+            (accepting[q] ? acc : nonacc).push_back((DFAStateID)q);
+        }
+
+        std::vector<DFAStateID> worklist;
+        std::vector<bool> inworklist;
+        if(!acc.empty()) {
+            blocks.push_back(acc);
+        }
+        if(!nonacc.empty()) {
+            blocks.push_back(nonacc);
+        }
+
+        for(size_t b = 0; b < blocks.size(); ++b) {
+            std::for_each(blocks[b].cbegin(), blocks[b].cend(), [&blockof, b](DFAStateID q) {
+                blockof[q] = (DFAStateID)b;
+            });
+        }
+
+        if(blocks.size() == 2) {
+            worklist.push_back(blocks[0].size() <= blocks[1].size() ? 0 : 1);
+        }
+        inworklist.assign(blocks.size(), false);
+        std::for_each(worklist.cbegin(), worklist.cend(), [&inworklist](DFAStateID b) {
+            inworklist[b] = true;
+        });
+
+        std::vector<size_t> mark(nstates, 0);
+        size_t stamp = 0;
+        std::vector<size_t> touchcount;
+        std::vector<DFAStateID> touched;
+        while(!worklist.empty()) {
+            const DFAStateID splitter = worklist.back();
+            worklist.pop_back();
+            inworklist[splitter] = false;
+
+            const std::vector<DFAStateID> members = blocks[splitter];
+            for(size_t k = 0; k < nclasses; ++k) {
+                stamp++;
+                touched.clear();
+                touchcount.resize(blocks.size(), 0);
+
+                //mark all the predecessors of the splitter on k and count them by block
+                std::for_each(members.cbegin(), members.cend(), [&](DFAStateID q) {
+                    for(size_t pi = predoffsets[k][q]; pi < predoffsets[k][q + 1]; ++pi) {
+                        const DFAStateID p = predlists[k][pi];
+                        if(mark[p] != stamp) {
+                            mark[p] = stamp;
+
+                            const DFAStateID pb = blockof[p];
+                            if(touchcount[pb] == 0) {
+                                touched.push_back(pb);
+                            }
+                            touchcount[pb]++;
+                        }
+                    }
+                });
+
+                //split each touched block that is only partially covered
+                for(auto titer = touched.cbegin(); titer != touched.cend(); ++titer) {
+                    const DFAStateID tb = *titer;
+                    if(touchcount[tb] != blocks[tb].size()) {
+                        std::vector<DFAStateID> inside;
+                        std::vector<DFAStateID> outside;
+                        std::for_each(blocks[tb].cbegin(), blocks[tb].cend(), [&](DFAStateID q) {
+                            (mark[q] == stamp ? inside : outside).push_back(q);
+                        });
+
+                        const DFAStateID nb = (DFAStateID)blocks.size();
+                        blocks[tb] = std::move(outside);
+                        blocks.push_back(std::move(inside));
+                        std::for_each(blocks[nb].cbegin(), blocks[nb].cend(), [&blockof, nb](DFAStateID q) {
+                            blockof[q] = nb;
+                        });
+
+                        inworklist.push_back(false);
+                        touchcount.push_back(0);
+                        if(inworklist[tb]) {
+                            worklist.push_back(nb);
+                            inworklist[nb] = true;
+                        }
+                        else {
+                            const DFAStateID addb = blocks[tb].size() <= blocks[nb].size() ? tb : nb;
+                            worklist.push_back(addb);
+                            inworklist[addb] = true;
+                        }
+                    }
+
+                    touchcount[tb] = 0;
+                }
+            }
+        }
+
+        nblocks = blocks.size();
+    }
+
+    DFAMachine* DFAMachine::tryCompile(const NFAMachine* m, size_t maxstates)
+    {
+        if(!m->counterfree) {
+            return nullptr;
+        }
+
+        const size_t nclasses = m->charclasses.classCount();
+
+        std::vector<DFAStateID> transitions;
+        std::vector<std::vector<StateID>> statesets;
+        DFAStateID deadstate = -1;
+        if(!DFAMachine::buildSubsetMachine(m, maxstates, transitions, statesets, deadstate)) {
+            return nullptr;
+        }
+
+        std::vector<bool> accepting;
+        std::transform(statesets.cbegin(), statesets.cend(), std::back_inserter(accepting), [m](const std::vector<StateID>& sset) {
+            return std::binary_search(sset.cbegin(), sset.cend(), m->acceptstate);
+        });
+
+        std::vector<DFAStateID> blockof;
+        size_t nblocks = 0;
+        DFAMachine::minimize(nclasses, transitions, accepting, blockof, nblocks);
+
+        //every state in a block is equivalent so we can take the transitions from any of them
+        std::vector<DFAStateID> mtransitions(nblocks * nclasses, 0);
+        std::vector<bool> maccepting(nblocks, false);
+        for(size_t q = 0; q < accepting.size(); ++q) {
+            const DFAStateID b = blockof[q];
+            maccepting[b] = accepting[q];
+            for(size_t k = 0; k < nclasses; ++k) {
+                mtransitions[(b * nclasses) + k] = blockof[transitions[(q * nclasses) + k]];
+            }
+        }
+
+        const DFAStateID mdead = deadstate != -1 ? blockof[deadstate] : -1;
+
+        //after minimization there is at most one accepting state that loops to itself on every class
+        DFAStateID macceptall = -1;
+        for(size_t b = 0; b < nblocks; ++b) {
+            auto btransitions = mtransitions.cbegin() + (b * nclasses);
+            const bool loops = std::all_of(btransitions, btransitions + nclasses, [b](DFAStateID next) {
+                return next == (DFAStateID)b;
+            });
+
+            if(maccepting[b] && loops) {
+                macceptall = (DFAStateID)b;
+            }
+        }
+
+        return new DFAMachine(blockof[0], m->charclasses, mtransitions, maccepting, mdead, macceptall);
+    }
+
+    DFAMachine* DFAMachine::complement(const DFAMachine* m)
+    {
+        std::vector<bool> caccepting;
+        std::transform(m->accepting.cbegin(), m->accepting.cend(), std::back_inserter(caccepting), [](bool acc) {
+            return !acc;
+        });
+
+        return new DFAMachine(m->startstate, m->charclasses, m->transitions, caccepting, m->acceptallstate, m->deadstate);
+    }
+}
@@ -0,0 +1,73 @@
+#include "glushkov_machine.h"
+
+namespace brex
+{
+    GlushkovMachine* GlushkovMachine::tryCompile(const NFAMachine* m, size_t maxpositions)
+    {
+        if(!m->counterfree) {
+            return nullptr;
+        }
+
+        //every epsilon closure is a set of concrete states so these are the positions
+        std::vector<size_t> positionof(m->nfaopts.size(), SIZE_MAX);
+        std::vector<StateID> positions;
+        for(StateID i = 0; i < m->nfaopts.size(); ++i) {
+            if(m->nfaopts[i]->concreteTransition()) {
+                positionof[i] = positions.size();
+                positions.push_back(i);
+            }
+        }
+
+        if(positions.size() > std::min(maxpositions, MAX_POSITIONS)) {
+            return nullptr;
+        }
+
+        const size_t npositions = positions.size();
+        const size_t nwords = (npositions + 63) / 64;
+        auto setPositions = [&positionof](const std::vector<StateID>& states, uint64_t* bits) {
+            std::for_each(states.cbegin(), states.cend(), [&positionof, bits](StateID sid) {
+                const size_t pos = positionof[sid];
+                bits[pos / 64] |= ((uint64_t)1 << (pos % 64));
+            });
+        };
+
+        GlushkovStateSet initial;
+        setPositions(m->epsilonclosures[m->startstate].value(), initial.words.data());
+
+        const size_t nclasses = m->charclasses.classCount();
+        std::vector<uint64_t> classmasks(nclasses * nwords, 0);
+        std::vector<uint64_t> follows(npositions * nwords, 0);
+        for(size_t p = 0; p < npositions; ++p) {
+            const StateID sid = positions[p];
+            if(sid == m->acceptstate) {
+                continue;
+            }
+
+            for(size_t k = 0; k < nclasses; ++k) {
+                if(NFAMachine::hasCharTransition(m->nfaopts[sid], m->charclasses.classlows[k])) {
+                    classmasks[(k * nwords) + (p / 64)] |= ((uint64_t)1 << (p % 64));
+                }
+            }
+
+            setPositions(m->epsilonclosures[m->program.instructions[sid].follow].value(), follows.data() + (p * nwords));
+        }
+
+        //each table entry is the entry without its low bit plus the follows of that bit
+        const size_t nchunks = nwords * (64 / CHUNK_BITS);
+        std::vector<uint64_t> followtables(nchunks * CHUNK_ENTRIES * nwords, 0);
+        for(size_t k = 0; k < nchunks; ++k) {
+            for(size_t b = 1; b < CHUNK_ENTRIES; ++b) {
+                const size_t low = __builtin_ctzll(b);
+                const size_t pos = (k * CHUNK_BITS) + low;
+
+                uint64_t* entry = followtables.data() + (((k * CHUNK_ENTRIES) + b) * nwords);
+                const uint64_t* rest = followtables.data() + (((k * CHUNK_ENTRIES) + (b & (b - 1))) * nwords);
+                for(size_t i = 0; i < nwords; ++i) {
+                    entry[i] = rest[i] | (pos < npositions ? follows[(pos * nwords) + i] : 0);
+                }
+            }
+        }
+
+        return new GlushkovMachine(npositions, initial, positionof[m->acceptstate], m->charclasses, classmasks, followtables);
+    }
+}
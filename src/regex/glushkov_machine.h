@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../common.h"
+
+#include "nfa_machine.h"
+
+namespace brex
+{
+    //The set of active positions of a GlushkovMachine -- only the first nwords of the machine are used
+    class GlushkovStateSet
+    {
+    public:
+        static constexpr size_t MAX_WORDS = 4;
+
+        std::array<uint64_t, MAX_WORDS> words;
+
+        GlushkovStateSet() : words({ 0, 0, 0, 0 }) {;}
+        ~GlushkovStateSet() = default;
+
+        GlushkovStateSet(const GlushkovStateSet& other) = default;
+        GlushkovStateSet(GlushkovStateSet&& other) = default;
+
+        GlushkovStateSet& operator=(const GlushkovStateSet& other) = default;
+        GlushkovStateSet& operator=(GlushkovStateSet&& other) = default;
+    };
+
+    //An epsilon free (Glushkov) version of a counter free NFAMachine run bit-parallel
+    //The positions are the concrete states of the machine (the char states and accept) and the active set is a bitset of them so a step is
+    //next = union of follow[p] for the active p that match the char -- the follow unions are tabled for each byte of the active set
+    class GlushkovMachine
+    {
+    public:
+        static constexpr size_t MAX_POSITIONS = GlushkovStateSet::MAX_WORDS * 64;
+        static constexpr size_t CHUNK_BITS = 8;
+        static constexpr size_t CHUNK_ENTRIES = 1 << CHUNK_BITS;
+
+        const size_t npositions;
+        const size_t nwords;
+
+        const GlushkovStateSet initial;
+        const size_t acceptposition;
+
+        const NFACharClasses charclasses;
+
+        //the positions with a transition on each class (nwords per class)
+        const std::vector<uint64_t> classmasks;
+
+        //for byte k of the active set and value b the union of the follows of the positions in b (nwords per entry at ((k * CHUNK_ENTRIES) + b) * nwords)
+        const std::vector<uint64_t> followtables;
+
+        GlushkovMachine(size_t npositions, const GlushkovStateSet& initial, size_t acceptposition, const NFACharClasses& charclasses, std::vector<uint64_t> classmasks, std::vector<uint64_t> followtables) : npositions(npositions), nwords((npositions + 63) / 64), initial(initial), acceptposition(acceptposition), charclasses(charclasses), classmasks(classmasks), followtables(followtables) {;}
+        ~GlushkovMachine() = default;
+
+        //build the machine if it is counter free and has at most maxpositions (<= MAX_POSITIONS) positions -- otherwise nullptr
+        static GlushkovMachine* tryCompile(const NFAMachine* m, size_t maxpositions);
+
+        inline void step(GlushkovStateSet& active, RegexChar c) const
+        {
+            const uint64_t* cmask = this->classmasks.data() + (this->charclasses.classOf(c) * this->nwords);
+
+            GlushkovStateSet next;
+            for(size_t w = 0; w < this->nwords; ++w) {
+                uint64_t matched = active.words[w] & cmask[w];
+                for(size_t k = w * (64 / CHUNK_BITS); matched != 0; ++k) {
+                    const uint64_t b = matched & (CHUNK_ENTRIES - 1);
+                    if(b != 0) {
+                        const uint64_t* follows = this->followtables.data() + (((k * CHUNK_ENTRIES) + b) * this->nwords);
+                        for(size_t i = 0; i < this->nwords; ++i) {
+                            next.words[i] |= follows[i];
+                        }
+                    }
+
+                    matched >>= CHUNK_BITS;
+                }
+            }
+
+            active = next;
+        }
+
+        inline bool isAccepting(const GlushkovStateSet& active) const
+        {
+            return (active.words[this->acceptposition / 64] >> (this->acceptposition % 64)) & 0x1;
+        }
+
+        inline bool isDead(const GlushkovStateSet& active) const
+        {
+            return std::all_of(active.words.cbegin(), active.words.cbegin() + this->nwords, [](uint64_t w) {
+                return w == 0;
+            });
+        }
+    };
+}
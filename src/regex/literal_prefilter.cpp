@@ -0,0 +1,203 @@
+#include "literal_prefilter.h"
+
+#include <cstring>
+
+namespace brex
+{
+    static void addFirstBytes(RegexChar low, RegexChar high, bool utf8, std::array<uint64_t, 4>& bytes)
+    {
+        auto addByte = [&bytes](uint32_t b) {
+            bytes[b >> 6] |= ((uint64_t)1 << (b & 0x3F));
+        };
+
+        const RegexChar asciihigh = std::min(high, (RegexChar)0x7F);
+        for(RegexChar c = low; c <= asciihigh; ++c) {
+            addByte(c);
+        }
+
+        //the C iterator sign extends the high bytes (and the utf8 byte iterator does not) so either char for the byte is a match
+        if(!utf8) {
+            for(uint32_t b = 0x80; b <= 0xFF; ++b) {
+                const RegexChar sxc = (RegexChar)(int32_t)(int8_t)b;
+                if((low <= b && b <= high) || (low <= sxc && sxc <= high)) {
+                    addByte(b);
+                }
+            }
+        }
+
+        //the lead byte of a utf8 encoding only grows with the char code so the lead bytes of the range are the ones between the lead bytes of its ends
+        if(utf8 && high > 0x7F && low <= 0x10FFFF) {
+            const uint8_t lowlead = extractRegexCharToBytes(std::max(low, (RegexChar)0x80))[0];
+            const uint8_t highlead = extractRegexCharToBytes(std::min(high, (RegexChar)0x10FFFF))[0];
+            for(uint32_t b = lowlead; b <= highlead; ++b) {
+                addByte(b);
+            }
+        }
+    }
+
+    static std::vector<StateID> initialConcreteStates(const NFAMachine* m)
+    {
+        if(m->epsilonclosures[m->startstate].has_value()) {
+            return m->epsilonclosures[m->startstate].value();
+        }
+
+        //a range is reachable so the closure needs the workset -- the counted tokens are on concrete states too
+        NFAState nstates;
+        m->intitializeMachine(nstates);
+
+        std::vector<StateID> states;
+        std::transform(nstates.simplestates.cbegin(), nstates.simplestates.cend(), std::back_inserter(states), [](const NFASimpleStateToken& t) {
+            return t.cstate;
+        });
+        std::transform(nstates.countedstates.cbegin(), nstates.countedstates.cend(), std::back_inserter(states), [](const NFACountedStateToken& t) {
+            return t.cstate;
+        });
+
+        return states;
+    }
+
+    size_t LiteralPrefilter::countBytes(const std::array<uint64_t, 4>& bytes)
+    {
+        size_t count = 0;
+        for(size_t i = 0; i < bytes.size(); ++i) {
+            count += __builtin_popcountll(bytes[i]);
+        }
+
+        return count;
+    }
+
+    uint8_t LiteralPrefilter::lowestByte(const std::array<uint64_t, 4>& bytes)
+    {
+        for(size_t i = 0; i < bytes.size(); ++i) {
+            if(bytes[i] != 0) {
+                return (uint8_t)((i * 64) + __builtin_ctzll(bytes[i]));
+            }
+        }
+
+        return 0;
+    }
+
+    LiteralPrefilter* LiteralPrefilter::tryCompile(const NFAMachine* m, bool utf8)
+    {
+        const std::vector<StateID> initial = initialConcreteStates(m);
+
+        //empty matches are never reported so the first byte is always from a char transition of an initial state
+        std::array<uint64_t, 4> firstbytes = { 0, 0, 0, 0 };
+        const size_t nclasses = m->charclasses.classCount();
+        for(auto iter = initial.cbegin(); iter != initial.cend(); ++iter) {
+            for(size_t k = 0; k < nclasses; ++k) {
+                if(m->classtransitions[(*iter * nclasses) + k]) {
+                    const RegexChar high = (k + 1 < nclasses) ? m->charclasses.classlows[k + 1] - 1 : UINT32_MAX;
+                    addFirstBytes(m->charclasses.classlows[k], high, utf8, firstbytes);
+                }
+            }
+        }
+
+        //follow the chain of single char states from the start for the literal prefix
+        std::vector<uint8_t> prefix;
+        std::vector<StateID> states = initial;
+        while(prefix.size() < MAX_PREFIX && states.size() == 1 && m->nfaopts[states[0]]->tag == NFAOptTag::CharCode) {
+            const NFAOptCharCode* cc = static_cast<const NFAOptCharCode*>(m->nfaopts[states[0]]);
+            if(utf8) {
+                auto bytes = extractRegexCharToBytes(cc->c);
+                std::copy(bytes.cbegin(), bytes.cend(), std::back_inserter(prefix));
+            }
+            else {
+                if(cc->c > 0xFF) {
+                    break;
+                }
+                prefix.push_back((uint8_t)cc->c);
+            }
+
+            if(!m->epsilonclosures[cc->follow].has_value()) {
+                break;
+            }
+            states = m->epsilonclosures[cc->follow].value();
+        }
+
+        if(prefix.size() <= 1 && LiteralPrefilter::countBytes(firstbytes) == 256) {
+            return nullptr;
+        }
+
+        return new LiteralPrefilter(prefix, firstbytes);
+    }
+
+    int64_t LiteralPrefilter::findCandidate(const uint8_t* data, int64_t spos, int64_t epos) const
+    {
+        if(spos > epos) {
+            return -1;
+        }
+
+        const uint8_t* sdata = data + spos;
+        const size_t length = (size_t)(epos - spos + 1);
+        if(this->prefix.size() > 1) {
+            const void* mpos = memmem(sdata, length, this->prefix.data(), this->prefix.size());
+            return mpos != nullptr ? (int64_t)(static_cast<const uint8_t*>(mpos) - data) : -1;
+        }
+
+        if(this->firstbytecount == 1) {
+            const void* mpos = memchr(sdata, this->onlybyte, length);
+            return mpos != nullptr ? (int64_t)(static_cast<const uint8_t*>(mpos) - data) : -1;
+        }
+
+        const uint8_t* mpos = std::find_if(sdata, sdata + length, [this](uint8_t b) {
+            return this->hasFirstByte(b);
+        });
+        return mpos != sdata + length ? (int64_t)(mpos - data) : -1;
+    }
+
+    LiteralFactorFilter* LiteralFactorFilter::tryCreate(const std::vector<RegexChar>& literal, bool issuffix, bool utf8)
+    {
+        if(literal.empty()) {
+            return nullptr;
+        }
+
+        std::vector<uint8_t> factor;
+        for(auto iter = literal.cbegin(); iter != literal.cend(); ++iter) {
+            if(utf8) {
+                auto bytes = extractRegexCharToBytes(*iter);
+                std::copy(bytes.cbegin(), bytes.cend(), std::back_inserter(factor));
+            }
+            else {
+                if(*iter > 0xFF) {
+                    return nullptr;
+                }
+                factor.push_back((uint8_t)*iter);
+            }
+        }
+
+        return new LiteralFactorFilter(factor, issuffix);
+    }
+
+    int64_t LiteralFactorFilter::findFirst(const uint8_t* data, int64_t spos, int64_t epos) const
+    {
+        if(epos - spos + 1 < (int64_t)this->factor.size()) {
+            return -1;
+        }
+
+        const void* mpos = memmem(data + spos, (size_t)(epos - spos + 1), this->factor.data(), this->factor.size());
+        return mpos != nullptr ? (int64_t)(static_cast<const uint8_t*>(mpos) - data) : -1;
+    }
+
+    int64_t LiteralFactorFilter::findLastEnd(const uint8_t* data, int64_t spos, int64_t epos) const
+    {
+        //find the last byte of the literal going backwards and then check the rest of it
+        const int64_t flength = (int64_t)this->factor.size();
+        int64_t hpos = epos;
+        while(hpos - spos + 1 >= flength) {
+            const void* mpos = memrchr(data + spos + (flength - 1), this->factor.back(), (size_t)(hpos - (spos + flength - 1) + 1));
+            if(mpos == nullptr) {
+                return -1;
+            }
+
+            const int64_t lpos = (int64_t)(static_cast<const uint8_t*>(mpos) - data);
+            if(std::memcmp(data + lpos - (flength - 1), this->factor.data(), this->factor.size()) == 0) {
+                return lpos;
+            }
+
+            hpos = lpos - 1;
+        }
+
+        return -1;
+    }
+}
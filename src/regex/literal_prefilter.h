@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../common.h"
+
+#include "nfa_machine.h"
+
+namespace brex
+{
+    //A quick scan for the positions where a (non-empty) match of a machine can start -- every match starts with the literal prefix and its first byte is in firstbytes
+    //Positions are in the bytes of the string (the utf8 bytes for unicode strings) so the scan can use memchr/memmem and skip over the text that cannot start a match
+    class LiteralPrefilter
+    {
+    public:
+        static constexpr size_t MAX_PREFIX = 64;
+
+        const std::vector<uint8_t> prefix;
+        const std::array<uint64_t, 4> firstbytes;
+        const size_t firstbytecount;
+        const uint8_t onlybyte; //the first byte when there is just one
+
+        LiteralPrefilter(std::vector<uint8_t> prefix, const std::array<uint64_t, 4>& firstbytes) : prefix(prefix), firstbytes(firstbytes), firstbytecount(LiteralPrefilter::countBytes(firstbytes)), onlybyte(LiteralPrefilter::lowestByte(firstbytes)) {;}
+        ~LiteralPrefilter() = default;
+
+        //build the prefilter for the machine -- utf8 if the chars of the machine are code points that are matched against utf8 bytes
+        //nullptr if every byte can start a match so the scan would not skip anything
+        static LiteralPrefilter* tryCompile(const NFAMachine* m, bool utf8);
+
+        static size_t countBytes(const std::array<uint64_t, 4>& bytes);
+        static uint8_t lowestByte(const std::array<uint64_t, 4>& bytes);
+
+        inline bool hasFirstByte(uint8_t b) const
+        {
+            return (this->firstbytes[b >> 6] >> (b & 0x3F)) & 0x1;
+        }
+
+        //the first position in [spos, epos] where a match can start or -1 if there is none
+        int64_t findCandidate(const uint8_t* data, int64_t spos, int64_t epos) const;
+    };
+
+    //A literal that every match contains (from RegexLiteralFactors on the regex) as bytes of the string -- if there is no occurrence there is no match
+    //When it is a suffix of every match the matches can only end where an occurrence ends so the reverse machine is only started from those
+    class LiteralFactorFilter
+    {
+    public:
+        const std::vector<uint8_t> factor;
+        const bool issuffix;
+
+        LiteralFactorFilter(std::vector<uint8_t> factor, bool issuffix) : factor(factor), issuffix(issuffix) {;}
+        ~LiteralFactorFilter() = default;
+
+        //the filter for the literal -- utf8 if the string is unicode -- nullptr if the literal is empty (or has chars that are not bytes in a C string)
+        static LiteralFactorFilter* tryCreate(const std::vector<RegexChar>& literal, bool issuffix, bool utf8);
+
+        //the start of the first occurrence in [spos, epos] or -1 if there is none
+        int64_t findFirst(const uint8_t* data, int64_t spos, int64_t epos) const;
+
+        //the end (last byte) of the last occurrence in [spos, epos] or -1 if there is none
+        int64_t findLastEnd(const uint8_t* data, int64_t spos, int64_t epos) const;
+    };
+}
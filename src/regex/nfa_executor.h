@@ -3,9 +3,20 @@
 #include "../common.h"
 
 #include "nfa_machine.h"
+#include "dfa_cache.h"
+#include "dfa_machine.h"
+#include "glushkov_machine.h"
+#include "literal_prefilter.h"
 
 namespace brex
 {
+    //which single match to find from a fixed start (or end) -- the longest one runs until the machine is dead and the shortest one stops at the first accept
+    enum class MatchMode
+    {
+        Longest,
+        Shortest
+    };
+
     template <typename TStr, typename TIter>
     class NFAExecutor
     {
@@ -13,27 +24,263 @@ namespace brex
         NFAMachine* forward; 
         NFAMachine* reverse;
 
+        //full DFAs for the machines if they were built ahead of time (nullptr otherwise)
+        DFAMachine* forwarddfa;
+        DFAMachine* reversedfa;
+
+        //the complement of the forward DFA for a negated entry (nullptr if the entry is not negated or there is no forward DFA)
+        DFAMachine* complementdfa;
+
+        //bit-parallel machines used when there is no full DFA (nullptr if the machine is not counter free or is too large)
+        GlushkovMachine* forwardgm;
+        GlushkovMachine* reversegm;
+
+        //lazy DFA caches for the machines (nullptr if the machine is not counter free or we have a full DFA or bit-parallel machine)
+        LazyDFACache* forwardcache;
+        LazyDFACache* reversecache;
+
+        //the scan for where a forward match can start (nullptr if any byte can start a match)
+        LiteralPrefilter* forwardprefilter;
+
+        //a literal every match contains (nullptr if there is none)
+        LiteralFactorFilter* factorfilter;
+
         TIter iter;
 
         NFAMachine* m;
-        NFAState cstates;
+
+        //the NFA simulation state for each machine -- kept across calls so stepping does not allocate once they have grown
+        NFAStepScratch forwardscratch;
+        NFAStepScratch reversescratch;
+
+        //the DFA, bit-parallel machine, or cache we are running on (all nullptr if we are simulating the NFA) and the current state for it
+        DFAMachine* dfa;
+        GlushkovMachine* gm;
+        LazyDFACache* cache;
+        DFAStateID dstate;
+        GlushkovStateSet gstate;
+
+        inline NFAStepScratch& getScratch()
+        {
+            return (this->m == this->forward) ? this->forwardscratch : this->reversescratch;
+        }
+
+        inline const NFAStepScratch& getScratch() const
+        {
+            return (this->m == this->forward) ? this->forwardscratch : this->reversescratch;
+        }
 
         void runIntialStep()
         {
-            this->m->intitializeMachine(this->cstates);
+            this->dfa = (this->m == this->forward) ? this->forwarddfa : this->reversedfa;
+            if(this->dfa != nullptr) {
+                this->dstate = this->dfa->startstate;
+                return;
+            }
+
+            this->gm = (this->m == this->forward) ? this->forwardgm : this->reversegm;
+            if(this->gm != nullptr) {
+                this->gstate = this->gm->initial;
+                return;
+            }
+
+            this->getScratch().prepare(this->m->nfaopts.size());
+
+            this->cache = (this->m == this->forward) ? this->forwardcache : this->reversecache;
+            if(this->cache != nullptr && !this->cache->hasFailed()) {
+                this->dstate = this->cache->getStartState();
+                if(this->dstate != LazyDFACache::UNKNOWN_TRANSITION) {
+                    return;
+                }
+            }
+
+            this->cache = nullptr;
+            this->m->intitializeMachine(this->getScratch());
         }
 
         void runStep(RegexChar c)
         {
-            this->cstates = this->m->stepMachine(c, this->cstates);
+            if(this->dfa != nullptr) {
+                this->dstate = this->dfa->step(this->dstate, c);
+                return;
+            }
+
+            if(this->gm != nullptr) {
+                this->gm->step(this->gstate, c);
+                return;
+            }
+
+            if(this->cache != nullptr) {
+                if(!this->cache->step(this->dstate, c, this->getScratch().getCurrentState())) {
+                    //cache gave up so the current scratch state is the state after c and we continue with NFA simulation
+                    this->cache = nullptr;
+                }
+                return;
+            }
+
+            this->m->stepMachine(c, this->getScratch());
+        }
+
+        inline bool accepted() const 
+        { 
+            if(this->dfa != nullptr) {
+                return this->dfa->isAccepting(this->dstate);
+            }
+
+            if(this->gm != nullptr) {
+                return this->gm->isAccepting(this->gstate);
+            }
+
+            return this->cache != nullptr ? this->cache->isAccepting(this->dstate) : this->m->inAccepted(this->getScratch().getCurrentState()); 
         }
 
-        inline bool accepted() const { return this->m->inAccepted(this->cstates); }
-        inline bool rejected() const { return this->m->allRejected(this->cstates); }
+        inline bool rejected() const 
+        { 
+            if(this->dfa != nullptr) {
+                return this->dfa->isDead(this->dstate);
+            }
+
+            if(this->gm != nullptr) {
+                return this->gm->isDead(this->gstate);
+            }
+
+            return this->cache != nullptr ? this->cache->isDead(this->dstate) : this->m->allRejected(this->getScratch().getCurrentState()); 
+        }
+
+        //the unanchored runs (the machine as .* R) -- there is no DFA for these so they use the bit-parallel machine or the NFA simulation
+        void runUnanchoredInitialStep()
+        {
+            this->dfa = nullptr;
+            this->cache = nullptr;
+
+            this->gm = (this->m == this->forward) ? this->forwardgm : this->reversegm;
+            if(this->gm != nullptr) {
+                this->gstate = this->gm->initial;
+                return;
+            }
+
+            this->m->intitializeMachine(this->getScratch());
+        }
+
+        void runUnanchoredStep(RegexChar c)
+        {
+            if(this->gm != nullptr) {
+                this->gm->step(this->gstate, c);
+                return;
+            }
+
+            this->m->stepMachine(c, this->getScratch());
+        }
+
+        inline int64_t nextForwardCandidate(TStr* sstr, int64_t spos, int64_t epos) const
+        {
+            return this->forwardprefilter->findCandidate(reinterpret_cast<const uint8_t*>(sstr->data()), spos, epos);
+        }
+
+        inline int64_t firstFactor(TStr* sstr, int64_t spos, int64_t epos) const
+        {
+            return this->factorfilter->findFirst(reinterpret_cast<const uint8_t*>(sstr->data()), spos, epos);
+        }
+
+        inline int64_t lastFactorEnd(TStr* sstr, int64_t spos, int64_t epos) const
+        {
+            return this->factorfilter->findLastEnd(reinterpret_cast<const uint8_t*>(sstr->data()), spos, epos);
+        }
+
+        //after a step of an unanchored forward run -- if nothing is in flight skip ahead to the next place a match can start (false if there is none) otherwise start a new match here
+        bool advanceUnanchoredForward(TStr* sstr, int64_t epos)
+        {
+            if(this->forwardprefilter != nullptr && this->rejected() && this->iter.valid()) {
+                const int64_t next = this->nextForwardCandidate(sstr, this->iter.curr, epos);
+                if(next == -1) {
+                    return false;
+                }
+
+                this->iter.curr = next;
+                this->runUnanchoredInitialStep();
+                return true;
+            }
+
+            this->addUnanchoredStart();
+            return true;
+        }
+
+        //start a new match at the next position -- done after checking for acceptance so empty matches are never reported
+        void addUnanchoredStart()
+        {
+            if(this->gm != nullptr) {
+                for(size_t w = 0; w < this->gm->nwords; ++w) {
+                    this->gstate.words[w] |= this->gm->initial.words[w];
+                }
+                return;
+            }
+
+            this->m->addInitialState(this->getScratch());
+        }
+
+        //the unanchored reverse run over [spos, epos] -- calls fn on each match start (in decreasing order) until it returns false
+        //if the literal factor is a suffix then matches only end where an occurrence of it ends so new matches are only started from those and we jump between them when nothing is in flight
+        template <typename FN>
+        void runUnanchoredReverse(TStr* sstr, int64_t spos, int64_t epos, FN fn)
+        {
+            //no match can start before the first candidate position so the reverse run can stop there
+            const int64_t lpos = (this->forwardprefilter != nullptr) ? this->nextForwardCandidate(sstr, spos, epos) : spos;
+            if(lpos == -1) {
+                return;
+            }
+
+            const bool fromhits = (this->factorfilter != nullptr) && this->factorfilter->issuffix;
+            int64_t hpos = epos;
+            if(this->factorfilter != nullptr) {
+                hpos = fromhits ? this->lastFactorEnd(sstr, lpos, epos) : (this->firstFactor(sstr, lpos, epos) != -1 ? epos : -1);
+                if(hpos == -1) {
+                    return;
+                }
+            }
+            int64_t nexthit = fromhits ? this->lastFactorEnd(sstr, lpos, hpos - 1) : -1;
+
+            this->m = this->reverse;
+            this->iter = TIter{sstr, lpos, hpos, hpos + 1};
+            this->iter.dec(); //start on the first byte of the last char
+
+            this->runUnanchoredInitialStep();
+            while(this->iter.valid()) {
+                this->runUnanchoredStep(this->iter.get());
+
+                if(this->accepted() && !fn(this->iter.curr)) {
+                    return;
+                }
+
+                const int64_t cend = this->iter.curr - 1; //the last byte of the next char
+                this->iter.dec();
+
+                if(!fromhits || cend == nexthit) {
+                    this->addUnanchoredStart();
+                    if(fromhits) {
+                        nexthit = this->lastFactorEnd(sstr, lpos, nexthit - 1);
+                    }
+                }
+                else if(this->rejected()) {
+                    if(nexthit == -1) {
+                        return;
+                    }
+
+                    this->iter = TIter{sstr, lpos, nexthit, nexthit + 1};
+                    this->iter.dec();
+                    this->runUnanchoredInitialStep();
+
+                    nexthit = this->lastFactorEnd(sstr, lpos, nexthit - 1);
+                }
+                else {
+                    ;
+                }
+            }
+        }
 
     public:
-        NFAExecutor(): forward(nullptr), reverse(nullptr), TIter(), m(nullptr), cstates() {;}
-        NFAExecutor(NFAMachine* forward, NFAMachine* reverse) : forward(forward), reverse(reverse), iter(), m(nullptr), cstates() {;}
+        NFAExecutor(): forward(nullptr), reverse(nullptr), forwarddfa(nullptr), reversedfa(nullptr), complementdfa(nullptr), forwardgm(nullptr), reversegm(nullptr), forwardcache(nullptr), reversecache(nullptr), forwardprefilter(nullptr), factorfilter(nullptr), iter(), m(nullptr), forwardscratch(), reversescratch(), dfa(nullptr), gm(nullptr), cache(nullptr), dstate(0), gstate() {;}
+        NFAExecutor(NFAMachine* forward, NFAMachine* reverse) : forward(forward), reverse(reverse), forwarddfa(nullptr), reversedfa(nullptr), complementdfa(nullptr), forwardgm(nullptr), reversegm(nullptr), forwardcache(LazyDFACache::tryCreateCache(forward, LazyDFACache::DEFAULT_BUDGET)), reversecache(LazyDFACache::tryCreateCache(reverse, LazyDFACache::DEFAULT_BUDGET)), forwardprefilter(LiteralPrefilter::tryCompile(forward, std::is_same<TIter, UnicodeRegexIterator>::value)), factorfilter(nullptr), iter(), m(nullptr), forwardscratch(), reversescratch(), dfa(nullptr), gm(nullptr), cache(nullptr), dstate(0), gstate() {;}
+        NFAExecutor(NFAMachine* forward, NFAMachine* reverse, DFAMachine* forwarddfa, DFAMachine* reversedfa, GlushkovMachine* forwardgm, GlushkovMachine* reversegm, size_t dfabudget, LiteralFactorFilter* factorfilter, DFAMachine* complementdfa) : forward(forward), reverse(reverse), forwarddfa(forwarddfa), reversedfa(reversedfa), complementdfa(complementdfa), forwardgm(forwarddfa == nullptr ? forwardgm : nullptr), reversegm(reversedfa == nullptr ? reversegm : nullptr), forwardcache(forwarddfa == nullptr && forwardgm == nullptr ? LazyDFACache::tryCreateCache(forward, dfabudget) : nullptr), reversecache(reversedfa == nullptr && reversegm == nullptr ? LazyDFACache::tryCreateCache(reverse, dfabudget) : nullptr), forwardprefilter(LiteralPrefilter::tryCompile(forward, std::is_same<TIter, UnicodeRegexIterator>::value)), factorfilter(factorfilter), iter(), m(nullptr), forwardscratch(), reversescratch(), dfa(nullptr), gm(nullptr), cache(nullptr), dstate(0), gstate() {;}
         ~NFAExecutor() = default;
 
         NFAExecutor(const NFAExecutor& other) = default;
@@ -42,6 +289,42 @@ namespace brex
         NFAExecutor& operator=(const NFAExecutor& other) = default;
         NFAExecutor& operator=(NFAExecutor&& other) = default;
 
+        const DFAMachine* getForwardDFA() const { return this->forwarddfa; }
+        const DFAMachine* getReverseDFA() const { return this->reversedfa; }
+
+        const GlushkovMachine* getForwardGlushkov() const { return this->forwardgm; }
+        const GlushkovMachine* getReverseGlushkov() const { return this->reversegm; }
+
+        const LiteralPrefilter* getForwardPrefilter() const { return this->forwardprefilter; }
+        const LiteralFactorFilter* getFactorFilter() const { return this->factorfilter; }
+
+        //lock-step runs (for the parts of a conjunction) -- the caller walks the string and steps the executor of each part on the same chars
+        //an unanchored run starts the machine again after every char so it accepts when some part of the string ending there (including the empty one) matches
+        void startLockStep(bool forward, bool unanchored)
+        {
+            this->m = forward ? this->forward : this->reverse;
+            if(unanchored) {
+                this->runUnanchoredInitialStep();
+            }
+            else {
+                this->runIntialStep();
+            }
+        }
+
+        void stepLockStep(RegexChar c, bool unanchored)
+        {
+            this->runStep(c);
+            if(unanchored) {
+                this->addUnanchoredStart();
+            }
+        }
+
+        bool lockStepAccepted() const { return this->accepted(); }
+        bool lockStepRejected() const { return this->rejected(); }
+
+        //true if the run is in a full DFA state that accepts whatever comes next
+        bool lockStepAcceptsAll() const { return this->dfa != nullptr && this->dfa->acceptsAll(this->dstate); }
+
         bool test(TStr* sstr, int64_t spos, int64_t epos)
         {
             this->m = this->forward;
@@ -55,11 +338,32 @@ namespace brex
                 if(this->rejected()) {
                     return false;
                 }
+
+                if(this->lockStepAcceptsAll()) {
+                    return true;
+                }
             }
 
             return this->accepted();
         }
 
+        //true if [spos, epos] does not match -- on the complement DFA the run stops as soon as it reaches its dead or accept-all state
+        bool testComplement(TStr* sstr, int64_t spos, int64_t epos)
+        {
+            if(this->complementdfa == nullptr) {
+                return !this->test(sstr, spos, epos);
+            }
+
+            TIter citer{sstr, spos, epos, spos};
+            DFAStateID cstate = this->complementdfa->startstate;
+            while(citer.valid() && !this->complementdfa->isDead(cstate) && !this->complementdfa->acceptsAll(cstate)) {
+                cstate = this->complementdfa->step(cstate, citer.get());
+                citer.inc();
+            }
+
+            return this->complementdfa->isAccepting(cstate);
+        }
+
         bool matchTestForward(TStr* sstr, int64_t spos, int64_t epos)
         {
             this->m = this->forward;
@@ -77,7 +381,8 @@ namespace brex
         bool matchTestReverse(TStr* sstr, int64_t spos, int64_t epos)
         {
             this->m = this->reverse;
-            this->iter = TIter{sstr, spos, epos, epos};
+            this->iter = TIter{sstr, spos, epos, epos + 1};
+            this->iter.dec(); //start on the first byte of the last char
 
             this->runIntialStep();
             while(this->iter.valid() && !(this->accepted() || this->rejected())) {
@@ -97,12 +402,11 @@ namespace brex
             this->runIntialStep();
             while(this->iter.valid() && !this->rejected()) {
                 this->runStep(this->iter.get());
+                this->iter.inc();
 
                 if(this->accepted()) {
-                    matches.push_back(this->iter.curr);
+                    matches.push_back(this->iter.curr - 1); //the last byte of the char
                 }
-
-                this->iter.inc();
             }
 
             return matches;
@@ -111,7 +415,8 @@ namespace brex
         std::vector<int64_t> matchReverse(TStr* sstr, int64_t spos, int64_t epos)
         {
             this->m = this->reverse;
-            this->iter = TIter{sstr, spos, epos, epos};
+            this->iter = TIter{sstr, spos, epos, epos + 1};
+            this->iter.dec(); //start on the first byte of the last char
 
             std::vector<int64_t> matches;
             this->runIntialStep();
@@ -127,5 +432,182 @@ namespace brex
 
             return matches;
         }
+
+        //true if any substring in [spos, epos] matches -- one unanchored pass of the forward machine that stops at the first match end
+        //an empty match counts when the range is not empty (so a regex that accepts "" is contained in any non-empty string)
+        bool matchTestContains(TStr* sstr, int64_t spos, int64_t epos)
+        {
+            if(spos <= epos) {
+                this->m = this->forward;
+                this->runIntialStep();
+                if(this->accepted()) {
+                    return true;
+                }
+            }
+
+            if(this->factorfilter != nullptr) {
+                if(this->factorfilter->issuffix) {
+                    bool found = false;
+                    this->runUnanchoredReverse(sstr, spos, epos, [&found](int64_t start) {
+                        found = true;
+                        return false;
+                    });
+
+                    return found;
+                }
+
+                if(this->firstFactor(sstr, spos, epos) == -1) {
+                    return false;
+                }
+            }
+
+            this->m = this->forward;
+            this->iter = TIter{sstr, spos, epos, spos};
+            if(this->forwardprefilter != nullptr) {
+                this->iter.curr = this->nextForwardCandidate(sstr, spos, epos);
+                if(this->iter.curr == -1) {
+                    return false;
+                }
+            }
+
+            this->runUnanchoredInitialStep();
+            while(this->iter.valid()) {
+                this->runUnanchoredStep(this->iter.get());
+
+                if(this->accepted()) {
+                    return true;
+                }
+
+                this->iter.inc();
+                if(!this->advanceUnanchoredForward(sstr, epos)) {
+                    return false;
+                }
+            }
+
+            return false;
+        }
+
+        //the starts of all the (non-empty) matches in [spos, epos] in decreasing order -- one unanchored pass of the reverse machine
+        std::vector<int64_t> scanReverseStarts(TStr* sstr, int64_t spos, int64_t epos)
+        {
+            std::vector<int64_t> starts;
+            this->runUnanchoredReverse(sstr, spos, epos, [&starts](int64_t start) {
+                starts.push_back(start);
+                return true;
+            });
+
+            return starts;
+        }
+
+        //the end of the longest (or shortest) match starting at spos -- same as matchForward(...).back() (or front()) without building the vector
+        //the run stops once the answer is known -- at the first accept for the shortest or when the machine is dead or accepts everything that follows for the longest
+        std::optional<int64_t> matchForwardEnd(TStr* sstr, int64_t spos, int64_t epos, MatchMode mode)
+        {
+            this->m = this->forward;
+            this->iter = TIter{sstr, spos, epos, spos};
+
+            std::optional<int64_t> last = std::nullopt;
+            this->runIntialStep();
+            while(this->iter.valid() && !this->rejected()) {
+                this->runStep(this->iter.get());
+                this->iter.inc();
+
+                if(this->accepted()) {
+                    last = this->iter.curr - 1; //the last byte of the char
+                    if(mode == MatchMode::Shortest) {
+                        return last;
+                    }
+
+                    if(this->lockStepAcceptsAll()) {
+                        //every longer prefix matches so the longest ends at epos
+                        return std::make_optional(epos);
+                    }
+                }
+            }
+
+            return last;
+        }
+
+        //the start of the longest (or shortest) match ending at epos -- same as matchReverse(...).back() (or front()) without building the vector
+        std::optional<int64_t> matchReverseStart(TStr* sstr, int64_t spos, int64_t epos, MatchMode mode)
+        {
+            this->m = this->reverse;
+            this->iter = TIter{sstr, spos, epos, epos + 1};
+            this->iter.dec(); //start on the first byte of the last char
+
+            std::optional<int64_t> first = std::nullopt;
+            this->runIntialStep();
+            while(this->iter.valid() && !this->rejected()) {
+                this->runStep(this->iter.get());
+
+                if(this->accepted()) {
+                    first = this->iter.curr;
+                    if(mode == MatchMode::Shortest) {
+                        return first;
+                    }
+
+                    if(this->lockStepAcceptsAll()) {
+                        //every longer suffix matches so the longest starts at spos
+                        return std::make_optional(spos);
+                    }
+                }
+
+                this->iter.dec();
+            }
+
+            return first;
+        }
+
+        //the largest end of any (non-empty) match in [spos, epos] -- one unanchored pass of the forward machine
+        std::optional<int64_t> scanForwardLastEnd(TStr* sstr, int64_t spos, int64_t epos)
+        {
+            if(this->factorfilter != nullptr) {
+                //no match ends after the last occurrence of a suffix
+                const int64_t lastend = this->lastFactorEnd(sstr, spos, epos);
+                if(lastend == -1) {
+                    return std::nullopt;
+                }
+
+                epos = this->factorfilter->issuffix ? lastend : epos;
+            }
+
+            this->m = this->forward;
+            this->iter = TIter{sstr, spos, epos, spos};
+            if(this->forwardprefilter != nullptr) {
+                this->iter.curr = this->nextForwardCandidate(sstr, spos, epos);
+                if(this->iter.curr == -1) {
+                    return std::nullopt;
+                }
+            }
+
+            std::optional<int64_t> last = std::nullopt;
+            this->runUnanchoredInitialStep();
+            while(this->iter.valid()) {
+                this->runUnanchoredStep(this->iter.get());
+                this->iter.inc();
+
+                if(this->accepted()) {
+                    last = this->iter.curr - 1; //the last byte of the char
+                }
+
+                if(!this->advanceUnanchoredForward(sstr, epos)) {
+                    break;
+                }
+            }
+
+            return last;
+        }
+
+        //the smallest start of any (non-empty) match in [spos, epos] -- one unanchored pass of the reverse machine
+        std::optional<int64_t> scanReverseFirstStart(TStr* sstr, int64_t spos, int64_t epos)
+        {
+            std::optional<int64_t> first = std::nullopt;
+            this->runUnanchoredReverse(sstr, spos, epos, [&first](int64_t start) {
+                first = start;
+                return true;
+            });
+
+            return first;
+        }
     };
 }
@@ -1,136 +1,465 @@
 #include "nfa_machine.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace brex
 {
-    uint16_t saturateNFATokenIncrement(uint16_t count)
+    bool NFACountSet::hasAtLeast(uint16_t count) const
     {
-        return count == UINT16_MAX ? count : count + 1;
-    }
+        const size_t wi = count >> 6;
+        if((this->words[wi] >> (count & 0x3F)) != 0) {
+            return true;
+        }
 
-    bool NFAMachine::inAccepted(const NFAState& ostates) const
-    {
-        return ostates.simplestates.find(this->acceptstate) != ostates.simplestates.cend();
+        return std::any_of(this->words.cbegin() + wi + 1, this->words.cend(), [](uint64_t w) {
+            return w != 0;
+        });
     }
 
-    bool NFAMachine::allRejected(const NFAState& ostates) const
+    void NFACountSet::increment(uint16_t capacity, bool unbounded, NFACountSet& next) const
     {
-        return ostates.simplestates.empty() && ostates.singlestates.empty() && ostates.fullstates.empty();
+        next.words.assign((capacity / 64) + 1, 0);
+
+        uint64_t carry = 0;
+        for(size_t i = 0; i < this->words.size(); ++i) {
+            next.words[i] = (this->words[i] << 1) | carry;
+            carry = this->words[i] >> 63;
+        }
+
+        //drop everything past the capacity (the words have room for capacity + 1 bits)
+        const size_t ci = capacity >> 6;
+        const uint64_t keepmask = ((capacity & 0x3F) == 0x3F) ? UINT64_MAX : (((uint64_t)1 << ((capacity & 0x3F) + 1)) - 1);
+        next.words[ci] &= keepmask;
+
+        if(unbounded && this->contains(capacity)) {
+            next.insert(capacity);
+        }
     }
 
-    void NFAMachine::advanceCharForSimpleStates(RegexChar c, const NFAState& ostates, NFAEpsilonWorkSet& workset, NFAState& nstates) const
+    std::vector<StateID> NFAMachine::computeRangeBody(const std::vector<NFAOpt*>& nfaopts, const NFAOptRangeK* rngk)
     {
-        for(auto iter = ostates.simplestates.cbegin(); iter != ostates.simplestates.cend(); ++iter) {
-            const NFAOpt* opt = this->nfaopts[iter->cstate];
-            const NFAOptTag tag = opt->tag;
+        //the body is compiled with the range as its follow so everything reachable from the infollow (without going through the range) is in it
+        std::vector<StateID> body;
+        std::vector<bool> visited(nfaopts.size(), false);
+        visited[rngk->stateid] = true;
 
-            switch(tag) {
+        std::vector<StateID> pending = { rngk->infollow };
+        while(!pending.empty()) {
+            const StateID cstate = pending.back();
+            pending.pop_back();
+
+            if(visited[cstate]) {
+                continue;
+            }
+            visited[cstate] = true;
+            body.push_back(cstate);
+
+            const NFAOpt* opt = nfaopts[cstate];
+            switch(opt->tag) {
                 case NFAOptTag::CharCode: {
-                    const NFAOptCharCode* cc = static_cast<const NFAOptCharCode*>(opt);
-                    if(cc->c == c) {
-                        this->addNextSimpleState(nstates, workset, iter->toNextState(cc->follow));
-                    }
+                    pending.push_back(static_cast<const NFAOptCharCode*>(opt)->follow);
                     break;
                 }
                 case NFAOptTag::CharRange: {
-                    const NFAOptRange* range = static_cast<const NFAOptRange*>(opt);
-                    auto inrng = std::find_if(range->ranges.cbegin(), range->ranges.cend(), [c](const SingleCharRange& rr) {
-                        return (rr.low <= c && c <= rr.high);
-                    }) != range->ranges.cend();
-
-                    bool doinsert = !range->compliment == inrng; //either both true or both false
-                    if(doinsert) {
-                        this->addNextSimpleState(nstates, workset, iter->toNextState(range->follow));
-                    }
+                    pending.push_back(static_cast<const NFAOptRange*>(opt)->follow);
                     break;
                 }
                 case NFAOptTag::Dot: {
-                    const NFAOptDot* dot = static_cast<const NFAOptDot*>(opt);
-                    this->addNextSimpleState(nstates, workset, iter->toNextState(dot->follow));
+                    pending.push_back(static_cast<const NFAOptDot*>(opt)->follow);
+                    break;
+                }
+                case NFAOptTag::AnyOf: {
+                    const NFAOptAnyOf* anyof = static_cast<const NFAOptAnyOf*>(opt);
+                    std::copy(anyof->follows.cbegin(), anyof->follows.cend(), std::back_inserter(pending));
+                    break;
+                }
+                case NFAOptTag::Star: {
+                    const NFAOptStar* star = static_cast<const NFAOptStar*>(opt);
+                    pending.push_back(star->matchfollow);
+                    pending.push_back(star->skipfollow);
+                    break;
+                }
+                case NFAOptTag::RangeK: {
+                    const NFAOptRangeK* inner = static_cast<const NFAOptRangeK*>(opt);
+                    pending.push_back(inner->infollow);
+                    pending.push_back(inner->outfollow);
                     break;
                 }
                 default: {
-                    //No char transitions for these so just drop token
+                    //accept is never in a range body
                     break;
                 }
             }
         }
+
+        return body;
     }
 
-    void NFAMachine::advanceCharForSingleStates(RegexChar c, const NFAState& ostates, NFAEpsilonWorkSet& workset, NFAState& nstates) const
+    std::vector<StateID> NFAMachine::computeCounterScopes(const std::vector<NFAOpt*>& nfaopts)
     {
-        for(auto iter = ostates.singlestates.cbegin(); iter != ostates.singlestates.cend(); ++iter) {
-            const NFAOpt* opt = this->nfaopts[iter->cstate];
-            const NFAOptTag tag = opt->tag;
+        //bodies of ranges are either nested or disjoint so the innermost range of a state is the one with the smallest body containing it
+        std::vector<StateID> scopes(nfaopts.size(), NO_COUNTER_SCOPE);
+        std::vector<size_t> scopesizes(nfaopts.size(), SIZE_MAX);
+        for(auto iter = nfaopts.cbegin(); iter != nfaopts.cend(); ++iter) {
+            if((*iter)->tag != NFAOptTag::RangeK) {
+                continue;
+            }
 
-            switch(tag) {
-                case NFAOptTag::CharCode: {
-                    const NFAOptCharCode* cc = static_cast<const NFAOptCharCode*>(opt);
-                    if(cc->c == c) {
-                        this->addNextSingleState(nstates, workset, iter->toNextState(cc->follow));
-                    }
-                    break;
+            const NFAOptRangeK* rngk = static_cast<const NFAOptRangeK*>(*iter);
+            const std::vector<StateID> body = NFAMachine::computeRangeBody(nfaopts, rngk);
+            std::for_each(body.cbegin(), body.cend(), [&](StateID sid) {
+                if(body.size() < scopesizes[sid]) {
+                    scopes[sid] = rngk->stateid;
+                    scopesizes[sid] = body.size();
                 }
-                case NFAOptTag::CharRange: {
-                    const NFAOptRange* range = static_cast<const NFAOptRange*>(opt);
-                    auto inrng = std::find_if(range->ranges.cbegin(), range->ranges.cend(), [c](const SingleCharRange& rr) {
-                        return (rr.low <= c && c <= rr.high);
-                    }) != range->ranges.cend();
-
-                    bool doinsert = !range->compliment == inrng; //either both true or both false
-                    if(doinsert) {
-                        this->addNextSingleState(nstates, workset, iter->toNextState(range->follow));
-                    }
-                    break;
-                }
-                case NFAOptTag::Dot: {
-                    const NFAOptDot* dot = static_cast<const NFAOptDot*>(opt);
-                    this->addNextSingleState(nstates, workset, iter->toNextState(dot->follow));
-                    break;
+            });
+        }
+
+        return scopes;
+    }
+
+    std::optional<std::vector<StateID>> NFAMachine::computeEpsilonClosure(const std::vector<NFAOpt*>& nfaopts, StateID state)
+    {
+        std::vector<StateID> closure;
+        std::vector<bool> visited(nfaopts.size(), false);
+        std::vector<StateID> pending = { state };
+        while(!pending.empty()) {
+            const StateID cstate = pending.back();
+            pending.pop_back();
+
+            if(visited[cstate]) {
+                continue;
+            }
+            visited[cstate] = true;
+
+            const NFAOpt* opt = nfaopts[cstate];
+            if(opt->concreteTransition()) {
+                closure.push_back(cstate);
+            }
+            else if(opt->tag == NFAOptTag::AnyOf) {
+                const NFAOptAnyOf* anyof = static_cast<const NFAOptAnyOf*>(opt);
+                std::copy(anyof->follows.cbegin(), anyof->follows.cend(), std::back_inserter(pending));
+            }
+            else if(opt->tag == NFAOptTag::Star) {
+                const NFAOptStar* star = static_cast<const NFAOptStar*>(opt);
+                pending.push_back(star->matchfollow);
+                pending.push_back(star->skipfollow);
+            }
+            else {
+                //RangeK turns the token into a counter token so this must be done at runtime
+                return std::nullopt;
+            }
+        }
+
+        std::sort(closure.begin(), closure.end());
+        return std::make_optional(closure);
+    }
+
+    std::vector<std::optional<std::vector<StateID>>> NFAMachine::computeEpsilonClosures(const std::vector<NFAOpt*>& nfaopts)
+    {
+        std::vector<std::optional<std::vector<StateID>>> closures;
+        for(StateID i = 0; i < nfaopts.size(); ++i) {
+            closures.push_back(NFAMachine::computeEpsilonClosure(nfaopts, i));
+        }
+
+        return closures;
+    }
+
+    NFACharSet::NFACharSet(const std::vector<SingleCharRange>& ranges) : bytebitmap({ 0, 0, 0, 0 }), intervals()
+    {
+        std::vector<SingleCharRange> sorted;
+        std::for_each(ranges.cbegin(), ranges.cend(), [this, &sorted](const SingleCharRange& rr) {
+            for(RegexChar c = rr.low; c <= std::min(rr.high, (RegexChar)255); ++c) {
+                this->bytebitmap[c >> 6] |= ((uint64_t)1 << (c & 0x3F));
+            }
+
+            if(rr.high >= 256) {
+                sorted.push_back({ std::max(rr.low, (RegexChar)256), rr.high });
+            }
+        });
+
+        std::sort(sorted.begin(), sorted.end(), [](const SingleCharRange& r1, const SingleCharRange& r2) {
+            return r1.low < r2.low;
+        });
+
+        for(auto ii = sorted.cbegin(); ii != sorted.cend(); ++ii) {
+            if(!this->intervals.empty() && (ii->low <= this->intervals.back().high || ii->low - 1 == this->intervals.back().high)) {
+                this->intervals.back().high = std::max(this->intervals.back().high, ii->high);
+            }
+            else {
+                this->intervals.push_back(*ii);
+            }
+        }
+    }
+
+    NFACharClasses::NFACharClasses(std::vector<RegexChar> classlows) : classlows(classlows), byteclasses(), pagelowclasses(), pagehighclasses()
+    {
+        auto slowClassOf = [this](RegexChar c) {
+            auto iter = std::upper_bound(this->classlows.cbegin(), this->classlows.cend(), c);
+            return (uint32_t)((iter - this->classlows.cbegin()) - 1);
+        };
+
+        for(size_t i = 0; i < BYTE_CLASS_WIDTH; ++i) {
+            this->byteclasses[i] = slowClassOf((RegexChar)i);
+        }
+
+        for(size_t i = 0; i < BMP_PAGE_COUNT; ++i) {
+            this->pagelowclasses[i] = slowClassOf((RegexChar)(i << 8));
+            this->pagehighclasses[i] = slowClassOf((RegexChar)((i << 8) | 0xFF));
+        }
+    }
+
+    uint32_t NFACharClasses::searchClass(uint32_t lo, uint32_t hi, RegexChar c) const
+    {
+        //the class is lo + the number of lows in (lo, hi] that are <= c (since the lows are sorted)
+        const RegexChar* lows = this->classlows.data();
+        uint32_t count = lo;
+        uint32_t i = lo + 1;
+
+        if(hi - lo > LINEAR_SEARCH_LIMIT) {
+#ifdef __AVX2__
+            //unsigned compare by flipping the sign bits -- lows[i] <= c is !(lows[i] > c)
+            const __m256i signbit = _mm256_set1_epi32((int32_t)0x80000000);
+            const __m256i cv = _mm256_xor_si256(_mm256_set1_epi32((int32_t)c), signbit);
+            while(i + 8 <= hi + 1) {
+                const __m256i lv = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(lows + i)), signbit);
+                const uint32_t gtmask = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(lv, cv)));
+                count += 8 - __builtin_popcount(gtmask);
+                if(gtmask != 0) {
+                    return count;
                 }
-                default: {
-                    //No char transitions for these so just drop token
-                    break;
+
+                i += 8;
+            }
+#else
+            auto iter = std::upper_bound(lows + lo + 1, lows + hi + 1, c);
+            return (uint32_t)((iter - lows) - 1);
+#endif
+        }
+
+        while(i <= hi && lows[i] <= c) {
+            count++;
+            i++;
+        }
+
+        return count;
+    }
+
+    NFACharClasses NFACharClasses::computeClasses(const std::vector<NFAOpt*>& nfaopts)
+    {
+        std::set<RegexChar> lows = { 0 };
+        for(auto iter = nfaopts.cbegin(); iter != nfaopts.cend(); ++iter) {
+            const NFAOpt* opt = *iter;
+            if(opt->tag == NFAOptTag::CharCode) {
+                const NFAOptCharCode* cc = static_cast<const NFAOptCharCode*>(opt);
+                lows.insert(cc->c);
+                if(cc->c != UINT32_MAX) {
+                    lows.insert(cc->c + 1);
                 }
             }
+            else if(opt->tag == NFAOptTag::CharRange) {
+                const NFAOptRange* range = static_cast<const NFAOptRange*>(opt);
+                std::for_each(range->ranges.cbegin(), range->ranges.cend(), [&lows](const SingleCharRange& rr) {
+                    lows.insert(rr.low);
+                    if(rr.high != UINT32_MAX) {
+                        lows.insert(rr.high + 1);
+                    }
+                });
+            }
+            else {
+                ;
+            }
         }
+
+        return NFACharClasses(std::vector<RegexChar>(lows.cbegin(), lows.cend()));
     }
-        
-    void NFAMachine::advanceCharForFullStates(RegexChar c, const NFAState& ostates, NFAEpsilonWorkSet& workset, NFAState& nstates) const
+
+    NFAProgram NFAProgram::compile(const std::vector<NFAOpt*>& nfaopts, const std::vector<std::optional<std::vector<StateID>>>& epsilonclosures)
     {
-        for(auto iter = ostates.fullstates.cbegin(); iter != ostates.fullstates.cend(); ++iter) {
-            const NFAOpt* opt = this->nfaopts[iter->cstate];
-            const NFAOptTag tag = opt->tag;
+        NFAProgram program;
+        for(size_t i = 0; i < nfaopts.size(); ++i) {
+            const NFAOpt* opt = nfaopts[i];
 
-            switch(tag) {
+            NFAInstruction inst = { opt->tag, false, 0, 0, 0, (StateID)i, (StateID)i, 0, NFAInstruction::NO_CLOSURE };
+            switch(opt->tag) {
                 case NFAOptTag::CharCode: {
-                    const NFAOptCharCode* cc = static_cast<const NFAOptCharCode*>(opt);
-                    if(cc->c == c) {
-                        this->addNextFullState(nstates, workset, iter->toNextState(cc->follow));
-                    }
+                    inst.follow = static_cast<const NFAOptCharCode*>(opt)->follow;
                     break;
                 }
                 case NFAOptTag::CharRange: {
-                    const NFAOptRange* range = static_cast<const NFAOptRange*>(opt);
-                    auto inrng = std::find_if(range->ranges.cbegin(), range->ranges.cend(), [c](const SingleCharRange& rr) {
-                        return (rr.low <= c && c <= rr.high);
-                    }) != range->ranges.cend();
-
-                    bool doinsert = !range->compliment == inrng; //either both true or both false
-                    if(doinsert) {
-                        this->addNextFullState(nstates, workset, iter->toNextState(range->follow));
-                    }
+                    inst.follow = static_cast<const NFAOptRange*>(opt)->follow;
                     break;
                 }
                 case NFAOptTag::Dot: {
-                    const NFAOptDot* dot = static_cast<const NFAOptDot*>(opt);
-                    this->addNextFullState(nstates, workset, iter->toNextState(dot->follow));
+                    inst.follow = static_cast<const NFAOptDot*>(opt)->follow;
+                    break;
+                }
+                case NFAOptTag::AnyOf: {
+                    const NFAOptAnyOf* anyof = static_cast<const NFAOptAnyOf*>(opt);
+                    inst.follow = (StateID)program.follows.size();
+                    inst.altfollow = (StateID)anyof->follows.size();
+                    std::copy(anyof->follows.cbegin(), anyof->follows.cend(), std::back_inserter(program.follows));
+                    break;
+                }
+                case NFAOptTag::Star: {
+                    const NFAOptStar* star = static_cast<const NFAOptStar*>(opt);
+                    inst.follow = star->matchfollow;
+                    inst.altfollow = star->skipfollow;
+                    break;
+                }
+                case NFAOptTag::RangeK: {
+                    const NFAOptRangeK* rngk = static_cast<const NFAOptRangeK*>(opt);
+                    inst.unbounded = rngk->unbounded;
+                    inst.mink = rngk->mink;
+                    inst.maxk = rngk->maxk;
+                    inst.capacity = rngk->capacity;
+                    inst.follow = rngk->infollow;
+                    inst.altfollow = rngk->outfollow;
                     break;
                 }
                 default: {
-                    //No char transitions for these so just drop token
+                    //accept has no follows
                     break;
                 }
             }
+
+            if(epsilonclosures[i].has_value()) {
+                const std::vector<StateID>& closure = epsilonclosures[i].value();
+                inst.closurestart = (uint32_t)program.closures.size();
+                inst.closurecount = (uint32_t)closure.size();
+                std::copy(closure.cbegin(), closure.cend(), std::back_inserter(program.closures));
+            }
+
+            program.instructions.push_back(inst);
+        }
+
+        return program;
+    }
+
+    bool NFAMachine::hasCharTransition(const NFAOpt* opt, RegexChar c)
+    {
+        switch(opt->tag) {
+            case NFAOptTag::CharCode: {
+                return static_cast<const NFAOptCharCode*>(opt)->c == c;
+            }
+            case NFAOptTag::CharRange: {
+                return static_cast<const NFAOptRange*>(opt)->matches(c);
+            }
+            case NFAOptTag::Dot: {
+                return true;
+            }
+            default: {
+                return false;
+            }
+        }
+    }
+
+    std::vector<bool> NFAMachine::computeClassTransitions(const std::vector<NFAOpt*>& nfaopts, const NFACharClasses& charclasses)
+    {
+        //every char in a class behaves the same so we can just check the low char of each class
+        const size_t nclasses = charclasses.classCount();
+
+        std::vector<bool> transitions(nfaopts.size() * nclasses, false);
+        for(size_t i = 0; i < nfaopts.size(); ++i) {
+            if(!nfaopts[i]->concreteTransition()) {
+                continue;
+            }
+
+            for(size_t k = 0; k < nclasses; ++k) {
+                transitions[(i * nclasses) + k] = NFAMachine::hasCharTransition(nfaopts[i], charclasses.classlows[k]);
+            }
+        }
+
+        return transitions;
+    }
+
+    bool NFAMachine::inAccepted(const NFAState& ostates) const
+    {
+        return ostates.simplestates.contains(this->acceptStateRepr);
+    }
+
+    bool NFAMachine::allRejected(const NFAState& ostates) const
+    {
+        return ostates.simplestates.empty() && ostates.countedstates.empty();
+    }
+
+    void NFAMachine::processCountedStateTransition(NFAState& nstates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, StateID next, StateID scope, const std::vector<uint16_t>& outercounts, const NFACountSet& counts) const
+    {
+        const NFAInstruction& inst = this->program.instructions[next];
+        if(inst.concreteTransition()) {
+            nstates.countedstates.insert(next, outercounts, counts);
+        }
+        else if(inst.tag == NFAOptTag::RangeK && next != scope) {
+            //a nested range so each count of this range becomes an outer count for the new tokens
+            std::vector<uint16_t>& nestedcounts = workset.getDepthOuterCounts(outercounts.size() + 1);
+            counts.forEach([&](uint16_t count) {
+                nestedcounts.assign(outercounts.cbegin(), outercounts.cend());
+                nestedcounts.push_back(count);
+
+                this->enterRange(nstates, fixpoint, workset, next, nestedcounts);
+            });
+
+            if(inst.mink == 0) {
+                this->processCountedStateTransition(nstates, fixpoint, workset, inst.altfollow, scope, outercounts, counts);
+            }
+        }
+        else {
+            //epsilon states and the end of an iteration (the scope range itself) are done from the workset
+            if(fixpoint.countedstates.insertNew(next, outercounts, counts, workset.added)) {
+                workset.countedstates.insert(next, outercounts, workset.added);
+            }
+        }
+    }
+
+    void NFAMachine::enterRange(NFAState& nstates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, StateID range, const std::vector<uint16_t>& outercounts) const
+    {
+        const NFAInstruction& inst = this->program.instructions[range];
+
+        NFACountSet& counts = workset.getDepthCounts(outercounts.size());
+        counts.assignSingleton(inst.capacity, 1);
+        this->processCountedStateTransition(nstates, fixpoint, workset, inst.follow, range, outercounts, counts);
+    }
+
+    void NFAMachine::exitRange(NFAState& nstates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, StateID range, const std::vector<uint16_t>& outercounts) const
+    {
+        const NFAInstruction& inst = this->program.instructions[range];
+
+        const StateID scope = this->counterscopes[range];
+        if(scope == NO_COUNTER_SCOPE) {
+            this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, NFASimpleStateToken(inst.altfollow));
+        }
+        else {
+            //the innermost outer count becomes the count set for the enclosing range
+            const size_t depth = outercounts.size() - 1;
+
+            std::vector<uint16_t>& scopecounts = workset.getDepthOuterCounts(depth);
+            scopecounts.assign(outercounts.cbegin(), outercounts.cend() - 1);
+
+            NFACountSet& counts = workset.getDepthCounts(depth);
+            counts.assignSingleton(this->program.instructions[scope].capacity, outercounts.back());
+
+            this->processCountedStateTransition(nstates, fixpoint, workset, inst.altfollow, scope, scopecounts, counts);
+        }
+    }
+
+    void NFAMachine::advanceCharForSimpleStates(uint32_t cls, const NFAState& ostates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const
+    {
+        for(auto iter = ostates.simplestates.cbegin(); iter != ostates.simplestates.cend(); ++iter) {
+            if(this->hasClassTransition(iter->cstate, cls)) {
+                this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, iter->toNextState(this->program.instructions[iter->cstate].follow));
+            }
+        }
+    }
+
+    void NFAMachine::advanceCharForCountedStates(uint32_t cls, const NFAState& ostates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const
+    {
+        for(auto iter = ostates.countedstates.cbegin(); iter != ostates.countedstates.cend(); ++iter) {
+            const StateID cstate = iter->cstate;
+            if(this->hasClassTransition(cstate, cls)) {
+                this->processCountedStateTransition(nstates, fixpoint, workset, this->program.instructions[cstate].follow, this->counterscopes[cstate], iter->outercounts, iter->counts);
+            }
         }
     }
 
@@ -138,32 +467,28 @@ namespace brex
     {
         while(workset.hasSimpleStates()) {
             const NFASimpleStateToken stok = workset.getNextSimpleState();
+            const NFAInstruction& inst = this->program.instructions[stok.cstate];
 
-            const NFAOpt* opt = this->nfaopts[stok.cstate];
-            const NFAOptTag tag = opt->tag;
-
-            switch(tag) {
+            switch(inst.tag) {
                 case NFAOptTag::AnyOf: {
-                    const NFAOptAnyOf* anyof = static_cast<const NFAOptAnyOf*>(opt);
-                    for(auto iter = anyof->follows.cbegin(); iter != anyof->follows.cend(); ++iter) {
-                        this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextState(*iter));
+                    const StateID* follows = this->program.follows.data() + inst.follow;
+                    for(StateID i = 0; i < inst.altfollow; ++i) {
+                        this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextState(follows[i]));
                     }
 
                     break;
                 }
                 case NFAOptTag::Star: {
-                    const NFAOptStar* star = static_cast<const NFAOptStar*>(opt);
-                    this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextState(star->matchfollow));
-                    this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextState(star->skipfollow));
+                    this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextState(inst.follow));
+                    this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextState(inst.altfollow));
 
                     break;
                 }
                 case NFAOptTag::RangeK: {
-                    const NFAOptRangeK* rngk = static_cast<const NFAOptRangeK*>(opt);
-                    nstates.singlestates.insert(NFASingleStateToken::toNextStateWithInitialize(rngk->infollow, rngk->stateid));
+                    this->enterRange(nstates, fixpoint, workset, stok.cstate, {});
 
-                    if(rngk->mink == 0) {
-                        this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextState(rngk->outfollow));
+                    if(inst.mink == 0) {
+                        this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextState(inst.altfollow));
                     }
 
                     break;
@@ -176,50 +501,39 @@ namespace brex
         }
     }
 
-    void NFAMachine::advanceEpsilonForSingleStates(NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const
+    void NFAMachine::advanceEpsilonForCountedStates(NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const
     {
-        while(workset.hasSingleStates()) {
-            const NFASingleStateToken stok = workset.getNextSingleState();
-
-            const NFAOpt* opt = this->nfaopts[stok.cstate];
-            const NFAOptTag tag = opt->tag;
+        while(workset.hasCountedStates()) {
+            const NFACountedStateToken& ctok = workset.getNextCountedState();
+            const StateID cstate = ctok.cstate;
+            const std::vector<uint16_t>& outercounts = ctok.outercounts;
+            const NFACountSet& counts = ctok.counts;
 
-            switch(tag) {
+            const NFAInstruction& inst = this->program.instructions[cstate];
+            switch(inst.tag) {
                 case NFAOptTag::AnyOf: {
-                    const NFAOptAnyOf* anyof = static_cast<const NFAOptAnyOf*>(opt);
-                    for(auto iter = anyof->follows.cbegin(); iter != anyof->follows.cend(); ++iter) {
-                        this->processSingleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextState(*iter));
+                    const StateID* follows = this->program.follows.data() + inst.follow;
+                    for(StateID i = 0; i < inst.altfollow; ++i) {
+                        this->processCountedStateTransition(nstates, fixpoint, workset, follows[i], this->counterscopes[cstate], outercounts, counts);
                     }
 
                     break;
                 }
                 case NFAOptTag::Star: {
-                    const NFAOptStar* star = static_cast<const NFAOptStar*>(opt);
-                    this->processSingleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextState(star->matchfollow));
-                    this->processSingleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextState(star->skipfollow));
+                    this->processCountedStateTransition(nstates, fixpoint, workset, inst.follow, this->counterscopes[cstate], outercounts, counts);
+                    this->processCountedStateTransition(nstates, fixpoint, workset, inst.altfollow, this->counterscopes[cstate], outercounts, counts);
 
                     break;
                 }
                 case NFAOptTag::RangeK: {
-                    const NFAOptRangeK* rngk = static_cast<const NFAOptRangeK*>(opt);
-                    if(rngk->stateid != stok.rangecount.first) {
-                        this->processFullStateEpsilonTransition(nstates, fixpoint, workset, NFAFullStateToken::toNextStateWithInitialize(rngk->infollow, stok.rangecount, rngk->stateid));
-
-                        if(rngk->mink == 0) {
-                            this->processSingleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextState(rngk->outfollow));
-                        }
+                    //the end of an iteration of this range -- counts are the number of completed iterations
+                    if(counts.hasAtLeast(inst.mink)) {
+                        this->exitRange(nstates, fixpoint, workset, cstate, outercounts);
                     }
-                    else {
-                        if(stok.rangecount.second < rngk->mink) {
-                            this->processSingleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextStateWithIncrement(rngk->infollow));
-                        }
-                        else if(rngk->maxk != INT16_MAX && stok.rangecount.second == rngk->maxk) {
-                            this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextStateWithDoneRange(rngk->outfollow));
-                        }
-                        else {
-                            this->processSingleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextStateWithIncrement(rngk->infollow));
-                            this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, stok.toNextStateWithDoneRange(rngk->outfollow));
-                        }
+
+                    counts.increment(inst.capacity, inst.unbounded, workset.loopcounts);
+                    if(!workset.loopcounts.empty()) {
+                        this->processCountedStateTransition(nstates, fixpoint, workset, inst.follow, cstate, outercounts, workset.loopcounts);
                     }
 
                     break;
@@ -231,11 +545,4 @@ namespace brex
             }
         }
     }
-
-    void NFAMachine::advanceEpsilonForFullStates(NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const
-    {
-        while(workset.hasFullStates()) {
-            BREX_ASSERT(false, "Not implemented");
-        }
-    }
 }
@@ -4,10 +4,8 @@
 
 namespace brex
 {
-    typedef size_t StateID;
+    typedef uint32_t StateID;
     
-    uint16_t saturateNFATokenIncrement(uint16_t count);
-
     class NFASimpleStateToken
     {
     public:
@@ -44,128 +42,311 @@ namespace brex
         }
     };
 
-    class NFASingleStateToken
+    //The set of counts of a range -- bit i is set if there is a token with count i (bit 0 is never used since counts start at 1)
+    //All the tokens on a state that differ only in the count of their innermost range share one of these so incrementing them all is a shift
+    class NFACountSet
     {
     public:
-        StateID cstate;
-        std::pair<StateID, uint16_t> rangecount;
+        std::vector<uint64_t> words;
 
-        NFASingleStateToken() : cstate(0), rangecount(0, 0) {;}
-        NFASingleStateToken(StateID cstate, std::pair<StateID, uint16_t> rangecount) : cstate(cstate), rangecount(rangecount) {;}
-        ~NFASingleStateToken() {;}
+        NFACountSet() : words() {;}
+        NFACountSet(uint16_t capacity) : words((capacity / 64) + 1, 0) {;}
+        ~NFACountSet() {;}
 
-        NFASingleStateToken(const NFASingleStateToken& other) = default;
-        NFASingleStateToken(NFASingleStateToken&& other) = default;
+        NFACountSet(const NFACountSet& other) = default;
+        NFACountSet(NFACountSet&& other) = default;
 
-        NFASingleStateToken& operator=(const NFASingleStateToken& other) = default;
-        NFASingleStateToken& operator=(NFASingleStateToken&& other) = default;
+        NFACountSet& operator=(const NFACountSet& other) = default;
+        NFACountSet& operator=(NFACountSet&& other) = default;
 
-        bool operator==(const NFASingleStateToken& other) const
+        static NFACountSet singleton(uint16_t capacity, uint16_t count)
         {
-            return this->cstate == other.cstate && this->rangecount == other.rangecount;
+            NFACountSet cs;
+            cs.assignSingleton(capacity, count);
+
+            return cs;
         }
 
-        bool operator!=(const NFASingleStateToken& other) const
+        //make this just {count} -- reuses the storage of this set
+        inline void assignSingleton(uint16_t capacity, uint16_t count)
         {
-            return this->cstate != other.cstate && this->rangecount != other.rangecount;
+            this->words.assign((capacity / 64) + 1, 0);
+            this->insert(count);
         }
 
-        static bool cmp(const NFASingleStateToken& t1, const NFASingleStateToken& t2)
+        inline void assign(const NFACountSet& other)
         {
-            if(t1.cstate < t2.cstate) {
-                return true;
-            }
-            else if(t1.cstate > t2.cstate) {
-                return false;
-            }
-            else {
-                return t1.rangecount < t2.rangecount;
-            }
+            this->words.assign(other.words.cbegin(), other.words.cend());
         }
 
-        inline NFASingleStateToken toNextState(StateID next) const
+        inline bool empty() const
         {
-            return NFASingleStateToken(next, this->rangecount);
+            return std::all_of(this->words.cbegin(), this->words.cend(), [](uint64_t w) {
+                return w == 0;
+            });
         }
 
-        inline static NFASingleStateToken toNextStateWithInitialize(StateID next, StateID incState)
+        inline bool contains(uint16_t count) const
         {
-            return NFASingleStateToken(next, std::make_pair(incState, 1));
+            return (this->words[count >> 6] >> (count & 0x3F)) & 0x1;
         }
 
-        inline NFASingleStateToken toNextStateWithIncrement(StateID next) const
+        inline void insert(uint16_t count)
         {
-            return NFASingleStateToken(next, std::make_pair(this->rangecount.first, saturateNFATokenIncrement(this->rangecount.second)));
+            this->words[count >> 6] |= ((uint64_t)1 << (count & 0x3F));
         }
 
-        inline NFASimpleStateToken toNextStateWithDoneRange(StateID next) const
+        inline void unionWith(const NFACountSet& other)
         {
-            return NFASimpleStateToken(next);
+            for(size_t i = 0; i < this->words.size(); ++i) {
+                this->words[i] |= other.words[i];
+            }
+        }
+
+        //add the counts from other and set added to the ones that were not already in this set -- false if there were none
+        bool unionWithNew(const NFACountSet& other, NFACountSet& added)
+        {
+            added.assign(other);
+
+            bool any = false;
+            for(size_t i = 0; i < this->words.size(); ++i) {
+                added.words[i] &= ~this->words[i];
+                this->words[i] |= other.words[i];
+
+                any |= (added.words[i] != 0);
+            }
+
+            return any;
+        }
+
+        bool hasAtLeast(uint16_t count) const;
+
+        //set next to every count + 1 -- counts past the capacity are dropped or, if the range is unbounded, stay at the capacity
+        void increment(uint16_t capacity, bool unbounded, NFACountSet& next) const;
+
+        template <typename FN>
+        void forEach(FN fn) const
+        {
+            for(size_t i = 0; i < this->words.size(); ++i) {
+                uint64_t w = this->words[i];
+                while(w != 0) {
+                    fn((uint16_t)((i * 64) + __builtin_ctzll(w)));
+                    w &= (w - 1);
+                }
+            }
         }
     };
 
-    class NFAFullStateToken
+    //A token in the body of a range is its state, the counts of the enclosing ranges other than the innermost (outermost first), and the count set of the innermost range
+    //The tokens are keyed on the first two so a state has one entry per outer count context -- just one if the range is not nested
+    class NFACountedStateToken
     {
     public:
+        static constexpr uint32_t NO_TOKEN = UINT32_MAX;
+
         StateID cstate;
-        std::vector<std::pair<StateID, uint16_t>> rangecounts;
-        
-        NFAFullStateToken() : cstate(0), rangecounts() {;}
-        NFAFullStateToken(StateID cstate, std::vector<std::pair<StateID, uint16_t>> rangecounts) : cstate(cstate), rangecounts(rangecounts) {;}
-        ~NFAFullStateToken() {;}
+        std::vector<uint16_t> outercounts;
+        NFACountSet counts;
+
+        //the previous token in the set with the same cstate (or NO_TOKEN)
+        uint32_t next;
+
+        NFACountedStateToken() : cstate(0), outercounts(), counts(), next(NO_TOKEN) {;}
+        ~NFACountedStateToken() {;}
+
+        NFACountedStateToken(const NFACountedStateToken& other) = default;
+        NFACountedStateToken(NFACountedStateToken&& other) = default;
+
+        NFACountedStateToken& operator=(const NFACountedStateToken& other) = default;
+        NFACountedStateToken& operator=(NFACountedStateToken&& other) = default;
+    };
+
+    //The counted tokens are kept in a vector of slots where only the first count are live -- dead slots keep their storage so once the 
+    //slots have grown inserts reuse it and clear is O(1). heads is a sparse index (like NFASimpleStateSet) to the newest token for each state.
+    class NFACountedStateSet
+    {
+    private:
+        uint32_t find(StateID cstate, const std::vector<uint16_t>& outercounts) const
+        {
+            uint32_t idx = this->heads[cstate];
+            if(idx >= this->count || this->tokens[idx].cstate != cstate) {
+                return NFACountedStateToken::NO_TOKEN;
+            }
 
-        NFAFullStateToken(const NFAFullStateToken& other) = default;
-        NFAFullStateToken(NFAFullStateToken&& other) = default;
+            while(idx != NFACountedStateToken::NO_TOKEN && this->tokens[idx].outercounts != outercounts) {
+                idx = this->tokens[idx].next;
+            }
 
-        NFAFullStateToken& operator=(const NFAFullStateToken& other) = default;
-        NFAFullStateToken& operator=(NFAFullStateToken&& other) = default;
+            return idx;
+        }
 
-        bool operator==(const NFAFullStateToken& other) const
+        void push(StateID cstate, const std::vector<uint16_t>& outercounts, const NFACountSet& counts)
         {
-            return this->cstate == other.cstate && std::equal(this->rangecounts.cbegin(), this->rangecounts.cend(), other.rangecounts.cbegin(), other.rangecounts.cend());
+            if(this->count == this->tokens.size()) {
+                this->tokens.emplace_back();
+            }
+
+            const uint32_t head = this->heads[cstate];
+            NFACountedStateToken& tok = this->tokens[this->count];
+            tok.cstate = cstate;
+            tok.outercounts.assign(outercounts.cbegin(), outercounts.cend());
+            tok.counts.assign(counts);
+            tok.next = (head < this->count && this->tokens[head].cstate == cstate) ? head : NFACountedStateToken::NO_TOKEN;
+
+            this->heads[cstate] = (uint32_t)this->count;
+            this->count++;
         }
 
-        bool operator!=(const NFAFullStateToken& other) const
+    public:
+        std::vector<NFACountedStateToken> tokens;
+        std::vector<uint32_t> heads;
+        size_t count;
+
+        NFACountedStateSet() : tokens(), heads(), count(0) {;}
+        NFACountedStateSet(size_t statecount) : tokens(), heads(statecount, 0), count(0) {;}
+        ~NFACountedStateSet() {;}
+
+        NFACountedStateSet(const NFACountedStateSet& other) = default;
+        NFACountedStateSet(NFACountedStateSet&& other) = default;
+
+        NFACountedStateSet& operator=(const NFACountedStateSet& other) = default;
+        NFACountedStateSet& operator=(NFACountedStateSet&& other) = default;
+
+        inline size_t size() const
         {
-            return this->cstate != other.cstate || !std::equal(this->rangecounts.cbegin(), this->rangecounts.cend(), other.rangecounts.cbegin(), other.rangecounts.cend());
+            return this->count;
         }
 
-        static bool cmp(const NFAFullStateToken& t1, const NFAFullStateToken& t2)
+        inline bool empty() const
         {
-            if(t1.cstate < t2.cstate) {
-                return true;
+            return this->count == 0;
+        }
+
+        inline void clear()
+        {
+            this->count = 0;
+        }
+
+        const NFACountSet* get(StateID cstate, const std::vector<uint16_t>& outercounts) const
+        {
+            const uint32_t idx = this->find(cstate, outercounts);
+            return idx != NFACountedStateToken::NO_TOKEN ? &this->tokens[idx].counts : nullptr;
+        }
+
+        void insert(StateID cstate, const std::vector<uint16_t>& outercounts, const NFACountSet& counts)
+        {
+            const uint32_t idx = this->find(cstate, outercounts);
+            if(idx == NFACountedStateToken::NO_TOKEN) {
+                this->push(cstate, outercounts, counts);
+            }
+            else {
+                this->tokens[idx].counts.unionWith(counts);
             }
-            else if(t1.cstate > t2.cstate) {
-                return false;
+        }
+
+        //insert the counts and set added to the ones that were not already present -- false if there were none
+        bool insertNew(StateID cstate, const std::vector<uint16_t>& outercounts, const NFACountSet& counts, NFACountSet& added)
+        {
+            const uint32_t idx = this->find(cstate, outercounts);
+            if(idx == NFACountedStateToken::NO_TOKEN) {
+                this->push(cstate, outercounts, counts);
+                added.assign(counts);
+                return true;
             }
             else {
-                return std::lexicographical_compare(t1.rangecounts.cbegin(), t1.rangecounts.cend(), t2.rangecounts.cbegin(), t2.rangecounts.cend());
+                return this->tokens[idx].counts.unionWithNew(counts, added);
             }
         }
 
-        inline NFAFullStateToken toNextState(StateID next) const
+        //move the newest token into tok -- the storage of tok is swapped into the freed slot so nothing is allocated
+        void pop(NFACountedStateToken& tok)
         {
-            return NFAFullStateToken(next, this->rangecounts);
+            this->count--;
+            NFACountedStateToken& last = this->tokens[this->count];
+
+            this->heads[last.cstate] = last.next;
+            tok.cstate = last.cstate;
+            std::swap(tok.outercounts, last.outercounts);
+            std::swap(tok.counts, last.counts);
         }
 
-        static inline NFAFullStateToken toNextStateWithInitialize(StateID next, std::pair<StateID, uint16_t> existingrng, StateID incState)
+        inline const NFACountedStateToken* cbegin() const
         {
-            std::vector<std::pair<StateID, uint16_t>> newrangecounts = {existingrng, std::make_pair(incState, 1)};
-            return NFAFullStateToken(next, newrangecounts);
+            return this->tokens.data();
         }
 
-        inline NFAFullStateToken toNextStateWithIncrement(StateID next, StateID incState) const
+        inline const NFACountedStateToken* cend() const
         {
-            std::vector<std::pair<StateID, uint16_t>> newrangecounts(this->rangecounts.size());
-            std::transform(this->rangecounts.cbegin(), this->rangecounts.cend(), newrangecounts.begin(), [incState](const std::pair<StateID, uint16_t>& rc) {
-                return rc.first == incState ? std::make_pair(rc.first, saturateNFATokenIncrement(rc.second)) : rc;
-            });
+            return this->tokens.data() + this->count;
+        }
+    };
 
-            return NFAFullStateToken(next, newrangecounts);
+    //A sparse set (Briggs & Torczon) over the StateIDs of a machine -- O(1) insert/contains/clear and no allocation after construction
+    class NFASimpleStateSet
+    {
+    public:
+        std::vector<NFASimpleStateToken> dense; //the members in insertion order (only the first count entries are valid)
+        std::vector<StateID> sparse; //the index in dense for each member state (garbage for non-members)
+        size_t count;
+
+        NFASimpleStateSet() : dense(), sparse(), count(0) {;}
+        NFASimpleStateSet(size_t statecount) : dense(statecount), sparse(statecount, 0), count(0) {;}
+        ~NFASimpleStateSet() {;}
+
+        NFASimpleStateSet(const NFASimpleStateSet& other) = default;
+        NFASimpleStateSet(NFASimpleStateSet&& other) = default;
+
+        NFASimpleStateSet& operator=(const NFASimpleStateSet& other) = default;
+        NFASimpleStateSet& operator=(NFASimpleStateSet&& other) = default;
+
+        inline size_t size() const
+        {
+            return this->count;
+        }
+
+        inline bool empty() const
+        {
+            return this->count == 0;
+        }
+
+        inline bool contains(const NFASimpleStateToken& t) const
+        {
+            const StateID idx = this->sparse[t.cstate];
+            return (idx < this->count) && (this->dense[idx].cstate == t.cstate);
+        }
+
+        inline void insert(const NFASimpleStateToken& t)
+        {
+            if(!this->contains(t)) {
+                this->sparse[t.cstate] = this->count;
+                this->dense[this->count] = t;
+                this->count++;
+            }
+        }
+
+        inline NFASimpleStateToken pop()
+        {
+            this->count--;
+            return this->dense[this->count];
+        }
+
+        inline void clear()
+        {
+            this->count = 0;
+        }
+
+        inline const NFASimpleStateToken* cbegin() const
+        {
+            return this->dense.data();
+        }
+
+        inline const NFASimpleStateToken* cend() const
+        {
+            return this->dense.data() + this->count;
         }
     };
 
-    enum class NFAOptTag
+    enum class NFAOptTag : uint8_t
     {
         Accept = 0x0,
         CharCode,
@@ -208,6 +389,36 @@ namespace brex
         virtual ~NFAOptCharCode() {;}
     };
 
+    //A compiled char set -- a bitmap for the byte chars and sorted/merged intervals for the rest
+    class NFACharSet
+    {
+    public:
+        std::array<uint64_t, 4> bytebitmap;
+        std::vector<SingleCharRange> intervals; //sorted, merged, and all above the byte chars
+
+        NFACharSet() : bytebitmap({ 0, 0, 0, 0 }), intervals() {;}
+        NFACharSet(const std::vector<SingleCharRange>& ranges);
+        ~NFACharSet() = default;
+
+        NFACharSet(const NFACharSet& other) = default;
+        NFACharSet(NFACharSet&& other) = default;
+
+        NFACharSet& operator=(const NFACharSet& other) = default;
+        NFACharSet& operator=(NFACharSet&& other) = default;
+
+        inline bool contains(RegexChar c) const
+        {
+            if(c < 256) {
+                return (this->bytebitmap[c >> 6] >> (c & 0x3F)) & 0x1;
+            }
+
+            auto iter = std::upper_bound(this->intervals.cbegin(), this->intervals.cend(), c, [](RegexChar cc, const SingleCharRange& rr) {
+                return cc < rr.low;
+            });
+            return iter != this->intervals.cbegin() && c <= (iter - 1)->high;
+        }
+    };
+
     class NFAOptRange : public NFAOpt
     {
     public:
@@ -215,8 +426,15 @@ namespace brex
         const std::vector<SingleCharRange> ranges;
         const StateID follow;
 
-        NFAOptRange(StateID stateid, bool compliment, std::vector<SingleCharRange> ranges, StateID follow) : NFAOpt(NFAOptTag::CharRange, stateid), compliment(compliment), ranges(ranges), follow(follow) {;}
+        const NFACharSet charset;
+
+        NFAOptRange(StateID stateid, bool compliment, std::vector<SingleCharRange> ranges, StateID follow) : NFAOpt(NFAOptTag::CharRange, stateid), compliment(compliment), ranges(ranges), follow(follow), charset(ranges) {;}
         virtual ~NFAOptRange() {;}
+
+        inline bool matches(RegexChar c) const
+        {
+            return !this->compliment == this->charset.contains(c); //either both true or both false
+        }
     };
 
     class NFAOptDot : public NFAOpt
@@ -255,22 +473,74 @@ namespace brex
         const uint16_t mink;
         const uint16_t maxk;
 
-        NFAOptRangeK(StateID stateid, uint16_t mink, uint16_t maxk, StateID infollow, StateID outfollow) : NFAOpt(NFAOptTag::RangeK, stateid), infollow(infollow), outfollow(outfollow), mink(mink), maxk(maxk) {;}
+        //past the min of an unbounded range the exact count does not matter so counts stop at the capacity
+        const bool unbounded;
+        const uint16_t capacity;
+
+        NFAOptRangeK(StateID stateid, uint16_t mink, uint16_t maxk, StateID infollow, StateID outfollow) : NFAOpt(NFAOptTag::RangeK, stateid), infollow(infollow), outfollow(outfollow), mink(mink), maxk(maxk), unbounded(maxk == INT16_MAX || maxk == UINT16_MAX), capacity(this->unbounded ? std::max(mink, (uint16_t)1) : maxk) {;}
         virtual ~NFAOptRangeK() {;}
     };
 
+    //A flat (POD) version of an NFAOpt for the interpreter loop -- what follow and altfollow mean depends on the tag:
+    //  char states -- follow is the next state (the chars are in the class transition table of the machine)
+    //  AnyOf -- the follows are program.follows[follow, follow + altfollow)
+    //  Star -- follow is the match and altfollow is the skip
+    //  RangeK -- follow is the body and altfollow is the exit
+    //and for every state the epsilon closure of a simple token is program.closures[closurestart, closurestart + closurecount) or NO_CLOSURE
+    class NFAInstruction
+    {
+    public:
+        static constexpr uint32_t NO_CLOSURE = UINT32_MAX;
+
+        NFAOptTag tag;
+        bool unbounded;
+        uint16_t mink;
+        uint16_t maxk;
+        uint16_t capacity;
+
+        StateID follow;
+        StateID altfollow;
+
+        uint32_t closurestart;
+        uint32_t closurecount;
+
+        inline bool concreteTransition() const
+        {
+            return this->tag <= NFAOptTag::Dot;
+        }
+    };
+
+    //The program for a machine -- one instruction per state with the variable length parts in the side arrays
+    class NFAProgram
+    {
+    public:
+        std::vector<NFAInstruction> instructions;
+        std::vector<StateID> follows;
+        std::vector<StateID> closures;
+
+        NFAProgram() : instructions(), follows(), closures() {;}
+        ~NFAProgram() = default;
+
+        NFAProgram(const NFAProgram& other) = default;
+        NFAProgram(NFAProgram&& other) = default;
+
+        NFAProgram& operator=(const NFAProgram& other) = default;
+        NFAProgram& operator=(NFAProgram&& other) = default;
+
+        static NFAProgram compile(const std::vector<NFAOpt*>& nfaopts, const std::vector<std::optional<std::vector<StateID>>>& epsilonclosures);
+    };
+
     class NFAState
     {
     public:
-        typedef std::set<NFASimpleStateToken, decltype(&NFASimpleStateToken::cmp)> TSimpleStates;
-        typedef std::set<NFASingleStateToken, decltype(&NFASingleStateToken::cmp)> TSingleStates;
-        typedef std::set<NFAFullStateToken, decltype(&NFAFullStateToken::cmp)> TFullStates;
+        typedef NFASimpleStateSet TSimpleStates;
+        typedef NFACountedStateSet TCountedStates;
 
         TSimpleStates simplestates;
-        TSingleStates singlestates;
-        TFullStates fullstates;
+        TCountedStates countedstates;
 
-        NFAState() : simplestates(&NFASimpleStateToken::cmp), singlestates(&NFASingleStateToken::cmp), fullstates(&NFAFullStateToken::cmp) {;}
+        NFAState() : simplestates(), countedstates() {;}
+        NFAState(size_t statecount) : simplestates(statecount), countedstates(statecount) {;}
         ~NFAState() {;}
 
         NFAState(const NFAState& other) = default;
@@ -281,39 +551,77 @@ namespace brex
 
         inline size_t stateSize() const
         {
-            return this->simplestates.size() + this->singlestates.size() + this->fullstates.size();
+            return this->simplestates.size() + this->countedstates.size();
         }
 
-        void intitialize() {
-            this->simplestates.clear();
-            this->singlestates.clear();
-            this->fullstates.clear();
+        inline bool sizedFor(size_t statecount) const
+        {
+            return this->simplestates.dense.size() == statecount;
         }
 
         void reset() {
             this->simplestates.clear();
-            this->singlestates.clear();
-            this->fullstates.clear();
+            this->countedstates.clear();
+        }
+
+        //the sorted ids of the simple states -- for counter free machines this is a canonical name for the state
+        std::vector<StateID> toSortedSimpleStates() const
+        {
+            BREX_ASSERT(this->countedstates.empty(), "Counter tokens in a counter free machine");
+
+            std::vector<StateID> sids;
+            sids.reserve(this->simplestates.size());
+            std::transform(this->simplestates.cbegin(), this->simplestates.cend(), std::back_inserter(sids), [](const NFASimpleStateToken& t) {
+                return t.cstate;
+            });
+            std::sort(sids.begin(), sids.end());
+
+            return sids;
+        }
+
+        void loadSimpleStates(const std::vector<StateID>& sids)
+        {
+            std::for_each(sids.cbegin(), sids.cend(), [this](StateID sid) {
+                this->simplestates.insert(NFASimpleStateToken(sid));
+            });
         }
     };
 
+    //the pending tokens of the epsilon phase of a step and the scratch space used to process them
     class NFAEpsilonWorkSet
     {
     public:
-        typedef std::set<NFASimpleStateToken, decltype(&NFASimpleStateToken::cmp)> TSimpleStates;
-        typedef std::set<NFASingleStateToken, decltype(&NFASingleStateToken::cmp)> TSingleStates;
-        typedef std::set<NFAFullStateToken, decltype(&NFAFullStateToken::cmp)> TFullStates;
+        typedef NFASimpleStateSet TSimpleStates;
+        typedef NFACountedStateSet TCountedStates;
 
         TSimpleStates simplestates;
-        TSingleStates singlestates;
-        TFullStates fullstates;
+        TCountedStates countedstates;
+
+        //the counted token being processed
+        NFACountedStateToken current;
+
+        //the count sets and outer counts made for tokens with k outer counts are in slot k so the recursive calls for nested ranges do not clobber them
+        //these are deques so growing them does not move the slots that callers further up are still using
+        std::deque<NFACountSet> depthcounts;
+        std::deque<std::vector<uint16_t>> depthoutercounts;
+
+        //the counts for the next iteration of a range and the new counts added to the fixpoint
+        NFACountSet loopcounts;
+        NFACountSet added;
 
-        NFAEpsilonWorkSet() : simplestates(&NFASimpleStateToken::cmp), singlestates(&NFASingleStateToken::cmp), fullstates(&NFAFullStateToken::cmp) {;}
+        NFAEpsilonWorkSet() : simplestates(), countedstates(), current(), depthcounts(), depthoutercounts(), loopcounts(), added() {;}
+        NFAEpsilonWorkSet(size_t statecount) : simplestates(statecount), countedstates(statecount), current(), depthcounts(), depthoutercounts(), loopcounts(), added() {;}
         ~NFAEpsilonWorkSet() {;}
 
+        NFAEpsilonWorkSet(const NFAEpsilonWorkSet& other) = default;
+        NFAEpsilonWorkSet(NFAEpsilonWorkSet&& other) = default;
+
+        NFAEpsilonWorkSet& operator=(const NFAEpsilonWorkSet& other) = default;
+        NFAEpsilonWorkSet& operator=(NFAEpsilonWorkSet&& other) = default;
+
         bool done() const
         {
-            return this->simplestates.empty() && this->singlestates.empty() && this->fullstates.empty();
+            return this->simplestates.empty() && this->countedstates.empty();
         }
 
         bool hasSimpleStates() const 
@@ -322,95 +630,184 @@ namespace brex
         }
         NFASimpleStateToken getNextSimpleState() 
         { 
-            auto it = this->simplestates.begin();
-            
-            NFASimpleStateToken t = *it;
-            this->simplestates.erase(it);
-
-            return t;
+            return this->simplestates.pop();
         }
 
-        bool hasSingleStates() const 
+        bool hasCountedStates() const 
         { 
-            return !this->singlestates.empty(); 
+            return !this->countedstates.empty(); 
         }
-        NFASingleStateToken getNextSingleState() 
+        const NFACountedStateToken& getNextCountedState() 
         { 
-            auto it = this->singlestates.begin();
-            
-            NFASingleStateToken t = *it;
-            this->singlestates.erase(it);
-
-            return t;
+            this->countedstates.pop(this->current);
+            return this->current;
         }
 
-        bool hasFullStates() const 
-        { 
-            return !this->fullstates.empty(); 
+        NFACountSet& getDepthCounts(size_t depth)
+        {
+            if(this->depthcounts.size() <= depth) {
+                this->depthcounts.resize(depth + 1);
+            }
+
+            return this->depthcounts[depth];
         }
-        NFAFullStateToken getNextFullState() 
-        { 
-            auto it = this->fullstates.begin();
-            
-            NFAFullStateToken t = *it;
-            this->fullstates.erase(it);
 
-            return t;
+        std::vector<uint16_t>& getDepthOuterCounts(size_t depth)
+        {
+            if(this->depthoutercounts.size() <= depth) {
+                this->depthoutercounts.resize(depth + 1);
+            }
+
+            return this->depthoutercounts[depth];
         }
     };
 
+    //the tokens (and counts) that have already been put in the workset during a step
     class NFAEpsilonFixpointSet
     {
     public:
-        typedef std::set<NFASimpleStateToken, decltype(&NFASimpleStateToken::cmp)> TSimpleStates;
-        typedef std::set<NFASingleStateToken, decltype(&NFASingleStateToken::cmp)> TSingleStates;
-        typedef std::set<NFAFullStateToken, decltype(&NFAFullStateToken::cmp)> TFullStates;
+        typedef NFASimpleStateSet TSimpleStates;
+        typedef NFACountedStateSet TCountedStates;
 
         TSimpleStates simplestates;
-        TSingleStates singlestates;
-        TFullStates fullstates;
+        TCountedStates countedstates;
 
-        NFAEpsilonFixpointSet() : simplestates(&NFASimpleStateToken::cmp), singlestates(&NFASingleStateToken::cmp), fullstates(&NFAFullStateToken::cmp) {;}
+        NFAEpsilonFixpointSet() : simplestates(), countedstates() {;}
+        NFAEpsilonFixpointSet(size_t statecount) : simplestates(statecount), countedstates(statecount) {;}
         ~NFAEpsilonFixpointSet() {;}
 
-        NFAEpsilonFixpointSet(const NFAEpsilonWorkSet& iworkset) : simplestates(iworkset.simplestates), singlestates(iworkset.singlestates), fullstates(iworkset.fullstates) {;}
+        NFAEpsilonFixpointSet(const NFAEpsilonFixpointSet& other) = default;
+        NFAEpsilonFixpointSet(NFAEpsilonFixpointSet&& other) = default;
+
+        NFAEpsilonFixpointSet& operator=(const NFAEpsilonFixpointSet& other) = default;
+        NFAEpsilonFixpointSet& operator=(NFAEpsilonFixpointSet&& other) = default;
+
+        void reset() {
+            this->simplestates.clear();
+            this->countedstates.clear();
+        }
     };
 
-    class NFAMachine
+    //All the space needed to step a machine -- a step reads the current buffer and writes the other one and then they are swapped
+    //Every set is cleared in O(1) and keeps its storage so once the buffers have grown to fit the live tokens stepping does not allocate
+    class NFAStepScratch
     {
-    private:
-        void addNextSimpleState(NFAState& nstates, NFAEpsilonWorkSet& workset, const NFASimpleStateToken& t) const
+    public:
+        std::array<NFAState, 2> buffers;
+        size_t current;
+
+        NFAEpsilonWorkSet workset;
+        NFAEpsilonFixpointSet fixpoint;
+
+        NFAStepScratch() : buffers(), current(0), workset(), fixpoint() {;}
+        NFAStepScratch(size_t statecount) : buffers({ NFAState(statecount), NFAState(statecount) }), current(0), workset(statecount), fixpoint(statecount) {;}
+        ~NFAStepScratch() {;}
+
+        NFAStepScratch(const NFAStepScratch& other) = default;
+        NFAStepScratch(NFAStepScratch&& other) = default;
+
+        NFAStepScratch& operator=(const NFAStepScratch& other) = default;
+        NFAStepScratch& operator=(NFAStepScratch&& other) = default;
+
+        inline void prepare(size_t statecount)
         {
-            if(this->nfaopts[t.cstate]->concreteTransition()) {
-                nstates.simplestates.insert(t);
-            }
-            else {
-                workset.simplestates.insert(t);
+            if(!this->buffers[0].sizedFor(statecount) || !this->buffers[1].sizedFor(statecount)) {
+                *this = NFAStepScratch(statecount);
             }
         }
-        void addNextSingleState(NFAState& nstates, NFAEpsilonWorkSet& workset, const NFASingleStateToken& t) const
+
+        inline NFAState& getCurrentState()
+        {
+            return this->buffers[this->current];
+        }
+
+        inline const NFAState& getCurrentState() const
+        {
+            return this->buffers[this->current];
+        }
+
+        inline NFAState& getNextState()
+        {
+            return this->buffers[this->current ^ 0x1];
+        }
+
+        inline void swap()
+        {
+            this->current ^= 0x1;
+        }
+    };
+
+    //A partition of the chars into the classes that no state in a machine can distinguish
+    //class i is the chars [classlows[i], classlows[i + 1]) and the last class is open ended
+    class NFACharClasses
+    {
+    private:
+        //the largest class index in [lo, hi] whose low is <= c (classlows[lo] <= c must hold)
+        uint32_t searchClass(uint32_t lo, uint32_t hi, RegexChar c) const;
+
+    public:
+        static constexpr size_t BYTE_CLASS_WIDTH = 256;
+        static constexpr size_t BMP_PAGE_COUNT = 256; //pages of 256 chars covering the BMP
+        static constexpr size_t LINEAR_SEARCH_LIMIT = 16;
+
+        std::vector<RegexChar> classlows;
+        std::array<uint32_t, BYTE_CLASS_WIDTH> byteclasses;
+
+        //the classes of the first and last char in each BMP page -- if they are the same then the whole page is that class
+        std::array<uint32_t, BMP_PAGE_COUNT> pagelowclasses;
+        std::array<uint32_t, BMP_PAGE_COUNT> pagehighclasses;
+
+        NFACharClasses() : NFACharClasses(std::vector<RegexChar>{ 0 }) {;}
+        NFACharClasses(std::vector<RegexChar> classlows);
+        ~NFACharClasses() = default;
+
+        NFACharClasses(const NFACharClasses& other) = default;
+        NFACharClasses(NFACharClasses&& other) = default;
+
+        NFACharClasses& operator=(const NFACharClasses& other) = default;
+        NFACharClasses& operator=(NFACharClasses&& other) = default;
+
+        //split on every char code and range boundary (the compliment of a range has the same boundaries)
+        static NFACharClasses computeClasses(const std::vector<NFAOpt*>& nfaopts);
+
+        inline size_t classCount() const
+        {
+            return this->classlows.size();
+        }
+
+        inline uint32_t classOf(RegexChar c) const
         {
-            if(this->nfaopts[t.cstate]->concreteTransition()) {
-                nstates.singlestates.insert(t);
+            if(c < BYTE_CLASS_WIDTH) {
+                return this->byteclasses[c];
             }
-            else {
-                workset.singlestates.insert(t);
+
+            const size_t page = c >> 8;
+            if(page < BMP_PAGE_COUNT) {
+                const uint32_t lowclass = this->pagelowclasses[page];
+                const uint32_t highclass = this->pagehighclasses[page];
+                return lowclass == highclass ? lowclass : this->searchClass(lowclass, highclass, c);
             }
+
+            return this->searchClass(this->pagehighclasses[BMP_PAGE_COUNT - 1], (uint32_t)(this->classlows.size() - 1), c);
         }
-        void addNextFullState(NFAState& nstates, NFAEpsilonWorkSet& workset, const NFAFullStateToken& t) const
+    };
+
+    class NFAMachine
+    {
+    private:
+        inline void addSimpleStateClosure(NFAState& nstates, const NFAInstruction& inst) const
         {
-            if(this->nfaopts[t.cstate]->concreteTransition()) {
-                nstates.fullstates.insert(t);
-            }
-            else {
-                workset.fullstates.insert(t);
+            const StateID* closure = this->program.closures.data() + inst.closurestart;
+            for(uint32_t i = 0; i < inst.closurecount; ++i) {
+                nstates.simplestates.insert(NFASimpleStateToken{closure[i]});
             }
         }
 
         void processSimpleStateEpsilonTransition(NFAState& nstates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, const NFASimpleStateToken& t) const
         {
-            if(this->nfaopts[t.cstate]->concreteTransition()) {
-                nstates.simplestates.insert(t);
+            const NFAInstruction& inst = this->program.instructions[t.cstate];
+            if(inst.closurecount != NFAInstruction::NO_CLOSURE) {
+                this->addSimpleStateClosure(nstates, inst);
             }
             else {
                 if(!fixpoint.simplestates.contains(t)) {
@@ -419,60 +816,82 @@ namespace brex
                 }
             }
         }
-        void processSingleStateEpsilonTransition(NFAState& nstates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, const NFASingleStateToken& t) const
-        {
-            if(this->nfaopts[t.cstate]->concreteTransition()) {
-                nstates.singlestates.insert(t);
-            }
-            else {
-                if(!fixpoint.singlestates.contains(t)) {
-                    fixpoint.singlestates.insert(t);
-                    workset.singlestates.insert(t);
-                }
-            }
-        }
-        void processFullStateEpsilonTransition(NFAState& nstates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, const NFAFullStateToken& t) const
+
+        //move the counted tokens (in the body of the range scope) to the next state -- only the counts not already seen this step are put in the workset
+        void processCountedStateTransition(NFAState& nstates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, StateID next, StateID scope, const std::vector<uint16_t>& outercounts, const NFACountSet& counts) const;
+
+        //start the first iteration of a range or leave it with the given counts for its enclosing ranges
+        void enterRange(NFAState& nstates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, StateID range, const std::vector<uint16_t>& outercounts) const;
+        void exitRange(NFAState& nstates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, StateID range, const std::vector<uint16_t>& outercounts) const;
+
+        inline bool hasClassTransition(StateID state, uint32_t cls) const
         {
-            if(this->nfaopts[t.cstate]->concreteTransition()) {
-                nstates.fullstates.insert(t);
-            }
-            else {
-                if(!fixpoint.fullstates.contains(t)) {
-                    fixpoint.fullstates.insert(t);
-                    workset.fullstates.insert(t);
-                }
-            }
+            return this->classtransitions[(state * this->charclasses.classCount()) + cls];
         }
 
-        //process a single char and compute the new state
-        void advanceCharForSimpleStates(RegexChar c, const NFAState& ostates, NFAEpsilonWorkSet& workset, NFAState& nstates) const;
-        void advanceCharForSingleStates(RegexChar c, const NFAState& ostates, NFAEpsilonWorkSet& workset, NFAState& nstates) const;
-        void advanceCharForFullStates(RegexChar c, const NFAState& ostates, NFAEpsilonWorkSet& workset, NFAState& nstates) const;
+        //process a single char (as its class) and compute the new state
+        void advanceCharForSimpleStates(uint32_t cls, const NFAState& ostates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const;
+        void advanceCharForCountedStates(uint32_t cls, const NFAState& ostates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const;
 
         //process all the epsilon transitions and compute the new state
         void advanceEpsilonForSimpleStates(NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const;
-        void advanceEpsilonForSingleStates(NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const;
-        void advanceEpsilonForFullStates(NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const;
+        void advanceEpsilonForCountedStates(NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const;
 
     public:
+        static constexpr StateID NO_COUNTER_SCOPE = UINT32_MAX;
+
         const StateID startstate;
         const StateID acceptstate;
 
         const std::vector<NFAOpt*> nfaopts;
         NFASimpleStateToken acceptStateRepr;
 
-        NFAMachine(StateID startstate, StateID acceptstate, std::vector<NFAOpt*> nfaopts) : startstate(startstate), acceptstate(acceptstate), nfaopts(nfaopts), acceptStateRepr(acceptstate) { ; }
+        //true if there are no RangeK states so all tokens are simple tokens
+        const bool counterfree;
+
+        //for each state the innermost RangeK whose body it is in (for a RangeK this is the range enclosing it) or NO_COUNTER_SCOPE
+        const std::vector<StateID> counterscopes;
+
+        //for each state the concrete states reachable from a simple token on it by epsilon transitions (just itself if it is concrete)
+        //nullopt if a RangeK is reachable since the token kind changes there and the closure must be computed by the workset
+        const std::vector<std::optional<std::vector<StateID>>> epsilonclosures;
+
+        //the char classes of the machine and for each concrete state which classes it has a transition on (indexed by state * classCount() + class)
+        const NFACharClasses charclasses;
+        const std::vector<bool> classtransitions;
+
+        //the flat version of nfaopts that the step functions run on
+        const NFAProgram program;
+
+        NFAMachine(StateID startstate, StateID acceptstate, std::vector<NFAOpt*> nfaopts) : startstate(startstate), acceptstate(acceptstate), nfaopts(nfaopts), acceptStateRepr(acceptstate), counterfree(NFAMachine::computeCounterFree(nfaopts)), counterscopes(NFAMachine::computeCounterScopes(nfaopts)), epsilonclosures(NFAMachine::computeEpsilonClosures(nfaopts)), charclasses(NFACharClasses::computeClasses(nfaopts)), classtransitions(NFAMachine::computeClassTransitions(nfaopts, this->charclasses)), program(NFAProgram::compile(nfaopts, this->epsilonclosures)) { ; }
         ~NFAMachine() = default;
 
+        static bool hasCharTransition(const NFAOpt* opt, RegexChar c);
+        static std::vector<bool> computeClassTransitions(const std::vector<NFAOpt*>& nfaopts, const NFACharClasses& charclasses);
+
+        static std::optional<std::vector<StateID>> computeEpsilonClosure(const std::vector<NFAOpt*>& nfaopts, StateID state);
+        static std::vector<std::optional<std::vector<StateID>>> computeEpsilonClosures(const std::vector<NFAOpt*>& nfaopts);
+
+        static std::vector<StateID> computeRangeBody(const std::vector<NFAOpt*>& nfaopts, const NFAOptRangeK* rngk);
+        static std::vector<StateID> computeCounterScopes(const std::vector<NFAOpt*>& nfaopts);
+
+        static bool computeCounterFree(const std::vector<NFAOpt*>& nfaopts)
+        {
+            return std::none_of(nfaopts.cbegin(), nfaopts.cend(), [](const NFAOpt* opt) {
+                return opt->tag == NFAOptTag::RangeK;
+            });
+        }
+
         //true if the machine has accepted or all paths are rejected
         bool inAccepted(const NFAState& ostates) const;
         bool allRejected(const NFAState& ostates) const;
 
-        void advanceChar(RegexChar c, const NFAState& ostates, NFAEpsilonWorkSet& workset, NFAState& nstates) const
+        void advanceChar(RegexChar c, const NFAState& ostates, NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const
         {
-            this->advanceCharForSimpleStates(c, ostates, workset, nstates);
-            this->advanceCharForSingleStates(c, ostates, workset, nstates);
-            this->advanceCharForFullStates(c, ostates, workset, nstates);
+            const uint32_t cls = this->charclasses.classOf(c);
+
+            this->advanceCharForSimpleStates(cls, ostates, fixpoint, workset, nstates);
+            this->advanceCharForCountedStates(cls, ostates, fixpoint, workset, nstates);
         }
 
         void advanceEpsilon(NFAEpsilonFixpointSet& fixpoint, NFAEpsilonWorkSet& workset, NFAState& nstates) const
@@ -482,38 +901,70 @@ namespace brex
                     this->advanceEpsilonForSimpleStates(fixpoint, workset, nstates);
                 }
 
-                if(workset.hasSingleStates()) {
-                    this->advanceEpsilonForSingleStates(fixpoint, workset, nstates);
-                }
-
-                if(workset.hasFullStates()) {
-                    this->advanceEpsilonForFullStates(fixpoint, workset, nstates);
+                if(workset.hasCountedStates()) {
+                    this->advanceEpsilonForCountedStates(fixpoint, workset, nstates);
                 }
             }
         }
 
-        void intitializeMachine(NFAState& nstates) const
+        //set the current state of the scratch to the initial state
+        void intitializeMachine(NFAStepScratch& scratch) const
         {
-            nstates.intitialize();
-            NFAEpsilonWorkSet workset;
-            this->addNextSimpleState(nstates, workset, NFASimpleStateToken{this->startstate});
+            scratch.prepare(this->nfaopts.size());
 
-            NFAEpsilonFixpointSet fixpoint(workset);
-            while(!workset.done()) {
-                this->advanceEpsilon(fixpoint, workset, nstates);
+            NFAState& nstates = scratch.getCurrentState();
+            nstates.reset();
+            scratch.fixpoint.reset();
+            this->processSimpleStateEpsilonTransition(nstates, scratch.fixpoint, scratch.workset, NFASimpleStateToken{this->startstate});
+
+            this->advanceEpsilon(scratch.fixpoint, scratch.workset, nstates);
+        }
+
+        //step the current state of the scratch on c (into the other buffer and then swap) -- this does not allocate once the scratch has grown
+        void stepMachine(RegexChar c, NFAStepScratch& scratch) const
+        {
+            NFAState& nstates = scratch.getNextState();
+            nstates.reset();
+            scratch.fixpoint.reset();
+            this->advanceChar(c, scratch.getCurrentState(), scratch.fixpoint, scratch.workset, nstates);
+
+            this->advanceEpsilon(scratch.fixpoint, scratch.workset, nstates);
+            scratch.swap();
+        }
+
+        //add the initial state to the current state of the scratch (right after a step so the fixpoint is still the one for that state)
+        //doing this after every step runs the machine unanchored -- i.e. as .* R -- so all the start positions are tracked in one pass
+        void addInitialState(NFAStepScratch& scratch) const
+        {
+            NFAState& nstates = scratch.getCurrentState();
+            this->processSimpleStateEpsilonTransition(nstates, scratch.fixpoint, scratch.workset, NFASimpleStateToken{this->startstate});
+
+            this->advanceEpsilon(scratch.fixpoint, scratch.workset, nstates);
+        }
+
+        //versions that make fresh states -- for building DFAs where every state is kept
+        void intitializeMachine(NFAState& nstates) const
+        {
+            if(!nstates.sizedFor(this->nfaopts.size())) {
+                nstates = NFAState(this->nfaopts.size());
             }
+
+            nstates.reset();
+            NFAEpsilonWorkSet workset(this->nfaopts.size());
+            NFAEpsilonFixpointSet fixpoint(this->nfaopts.size());
+            this->processSimpleStateEpsilonTransition(nstates, fixpoint, workset, NFASimpleStateToken{this->startstate});
+
+            this->advanceEpsilon(fixpoint, workset, nstates);
         }
 
         NFAState stepMachine(RegexChar c, const NFAState& ostates) const
         {
-            NFAState nstates;
-            NFAEpsilonWorkSet workset;
-            this->advanceChar(c, ostates, workset, nstates);
+            NFAState nstates(this->nfaopts.size());
+            NFAEpsilonWorkSet workset(this->nfaopts.size());
+            NFAEpsilonFixpointSet fixpoint(this->nfaopts.size());
+            this->advanceChar(c, ostates, fixpoint, workset, nstates);
 
-            NFAEpsilonFixpointSet fixpoint(workset);
-            while(!workset.done()) {
-                this->advanceEpsilon(fixpoint, workset, nstates);
-            }
+            this->advanceEpsilon(fixpoint, workset, nstates);
 
             return nstates;
         }
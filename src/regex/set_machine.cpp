@@ -0,0 +1,36 @@
+#include "set_machine.h"
+
+namespace brex
+{
+    SetMachine* SetMachine::compile(const NFAMachine* nfa, size_t npatterns, bool buildDFA, size_t maxstates)
+    {
+        std::vector<DFAStateID> transitions;
+        std::vector<std::vector<StateID>> statesets;
+        DFAStateID deadstate = -1;
+        if(!buildDFA || !nfa->counterfree || !DFAMachine::buildSubsetMachine(nfa, maxstates, transitions, statesets, deadstate)) {
+            return new SetMachine(nfa, npatterns, {}, {}, -1);
+        }
+
+        //the accept states are 0..npatterns-1 so they are at the front of each sorted state set
+        std::vector<std::vector<size_t>> accepts;
+        std::transform(statesets.cbegin(), statesets.cend(), std::back_inserter(accepts), [npatterns](const std::vector<StateID>& sset) {
+            std::vector<size_t> saccepts;
+            for(auto iter = sset.cbegin(); iter != sset.cend() && *iter < npatterns; ++iter) {
+                saccepts.push_back(*iter);
+            }
+
+            return saccepts;
+        });
+
+        return new SetMachine(nfa, npatterns, transitions, accepts, deadstate);
+    }
+
+    void SetMachine::acceptedPatterns(const NFAState& nstates, std::vector<size_t>& accepted) const
+    {
+        for(size_t i = 0; i < this->npatterns; ++i) {
+            if(nstates.simplestates.contains(NFASimpleStateToken{(StateID)i})) {
+                accepted.push_back(i);
+            }
+        }
+    }
+}
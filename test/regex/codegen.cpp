@@ -0,0 +1,113 @@
+#include <boost/test/unit_test.hpp>
+
+#include "../../src/regex/brex.h"
+#include "../../src/regex/brex_system.h"
+#include "../../src/regex/brex_codegen.h"
+
+//generated by brexc from codegen_system.json
+#include "codegen_system.h"
+
+std::optional<brex::CRegexExecutor*> tryParseForCodegenTest(const std::string& str, const brex::RegexCompilerOptions& options) {
+    auto pr = brex::RegexParser::parseCRegex(std::u8string(str.cbegin(), str.cend()), false);
+    if(!pr.first.has_value() || !pr.second.empty()) {
+        return std::nullopt;
+    }
+
+    std::map<std::string, const brex::RegexOpt*> namemap;
+    std::map<std::string, const brex::LiteralOpt*> envmap;
+    std::vector<brex::RegexCompileError> compileerror;
+    auto executor = brex::RegexCompiler::compileCRegexToExecutor(pr.first.value(), namemap, envmap, false, nullptr, nullptr, compileerror, options);
+    if(!compileerror.empty()) {
+        return std::nullopt;
+    }
+
+    return std::make_optional(executor);
+}
+
+std::string generateCodegenTestString(size_t length, uint32_t seed) {
+    const std::vector<std::string> pieces = { "a", "b", "c", "0", "9", "-", "@", "x", "yz", "ab", "abc-09", "c-123", "@x", "\xC3\xA9", "\xE2\x82\xAC" };
+
+    std::string str;
+    for(size_t i = 0; i < length; ++i) {
+        seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF;
+        str += pieces[(seed >> 16) % pieces.size()];
+    }
+
+    return str;
+}
+
+BOOST_AUTO_TEST_SUITE(Codegen)
+
+BOOST_AUTO_TEST_CASE(names) {
+    BOOST_CHECK(brex::RegexCodeGenerator::toIdentifier("Main::Foo") == "Main_Foo");
+    BOOST_CHECK(brex::RegexCodeGenerator::toIdentifier("9-x") == "_9_x");
+    BOOST_CHECK(brex::RegexCodeGenerator::toStringLiteral(u8"/\"é\\\"/") == "\"/\\\"\\303\\251\\\\\\\"/\"");
+}
+
+BOOST_AUTO_TEST_CASE(unsupported) {
+    //counters that stay counters have no full DFA
+    brex::RegexCompilerOptions options = brex::RegexCodeGenerator::codegenOptions();
+    options.maxUnrollStates = 0;
+
+    auto texecutor = tryParseForCodegenTest("/[ab]{2,5}/c", options);
+    BOOST_CHECK(texecutor.has_value());
+
+    brex::RegexCodeGenerator generator("brexgen");
+    std::string error;
+    BOOST_CHECK(!generator.addRegex("Counted", u8"/[ab]{2,5}/c", texecutor.value(), error));
+    BOOST_CHECK(!error.empty() && generator.matchers.empty());
+
+    auto uexecutor = tryParseForCodegenTest("/[ab]{2,5}/c", brex::RegexCodeGenerator::codegenOptions());
+    BOOST_CHECK(generator.addRegex("Unrolled", u8"/[ab]{2,5}/c", uexecutor.value(), error));
+    BOOST_CHECK(generator.emit().find("inline bool Unrolled(const char* str, size_t len)") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(differential) {
+    //rebuild the system from the generated table and compare the generated matchers with the executors
+    std::map<std::string, std::vector<brex::REInfo>> nsentries;
+    for(auto miter = std::cbegin(brexgentest::matchers); miter != std::cend(brexgentest::matchers); ++miter) {
+        const std::string fullname(miter->name);
+        const std::string regex(miter->regex);
+
+        const size_t split = fullname.find("::");
+        nsentries[fullname.substr(0, split)].push_back(brex::REInfo{ fullname.substr(split + 2), std::u8string(regex.cbegin(), regex.cend()) });
+    }
+
+    std::vector<brex::RENSInfo> ninfos;
+    std::transform(nsentries.cbegin(), nsentries.cend(), std::back_inserter(ninfos), [](const std::pair<std::string, std::vector<brex::REInfo>>& nse) {
+        return brex::RENSInfo{ brex::NSRemapInfo{ nse.first, {} }, nse.second };
+    });
+
+    std::vector<std::u8string> errors;
+    auto sys = brex::ReSystem::processSystem(ninfos, errors);
+    BOOST_CHECK(errors.empty());
+
+    for(auto miter = std::cbegin(brexgentest::matchers); miter != std::cend(brexgentest::matchers); ++miter) {
+        const std::string regex(miter->regex);
+        const bool isunicode = !regex.ends_with("/c");
+
+        size_t accepted = 0;
+        for(uint32_t seed = 1; seed < 4000; ++seed) {
+            auto str = generateCodegenTestString(seed % 9, seed);
+
+            bool expected = false;
+            brex::ExecutorError err;
+            if(isunicode) {
+                auto ustr = brex::UnicodeString(str.cbegin(), str.cend());
+                expected = sys.getUnicodeRE(miter->name)->test(&ustr, err);
+            }
+            else {
+                auto cstr = brex::CString(str);
+                expected = sys.getCStringRE(miter->name)->test(&cstr, err);
+            }
+
+            accepted += expected ? 1 : 0;
+            BOOST_CHECK_MESSAGE(miter->test(str.c_str(), str.size()) == expected, miter->name << " on " << str);
+        }
+
+        //the strings must hit both outcomes for the comparison to mean anything
+        BOOST_CHECK_MESSAGE(accepted != 0, miter->name << " accepts nothing");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
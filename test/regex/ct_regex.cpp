@@ -0,0 +1,115 @@
+#include <boost/test/unit_test.hpp>
+
+#include "../../src/regex/brex.h"
+#include "../../src/regex/brex_parser.h"
+#include "../../src/regex/brex_compiler.h"
+#include "../../src/regex/brex_ct.h"
+
+//these are checked by the compiler
+static_assert(brex::ct_regex<"/[0-9]{5}/c">::test("12345"));
+static_assert(!brex::ct_regex<"/[0-9]{5}/c">::test("1234a"));
+static_assert(brex::ct_regex<"/\"a\" [b-d]*/">::test(u8"abcd"));
+static_assert(!brex::ct_regex<"/[a-c0-9]* & !('a' [a-c]*)/c">::test("abc"));
+
+std::string generateCTRegexTestString(size_t length, uint32_t seed) {
+    const std::vector<std::string> pieces = { "a", "b", "c", "0", "5", "9", "-", " ", "ab", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x8C\xB5" };
+
+    std::string str;
+    for(size_t i = 0; i < length; ++i) {
+        seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF;
+        str += pieces[(seed >> 16) % pieces.size()];
+    }
+
+    return str;
+}
+
+//compare the ct_regex against the runtime executor for the same regex
+template <brex::ct::CTString RE>
+void checkCTRegexAgainstExecutor() {
+    const std::u8string restr(RE.chars, RE.chars + RE.size());
+    const bool isc = restr.ends_with(u8"/c");
+
+    auto pr = isc ? brex::RegexParser::parseCRegex(restr, false) : brex::RegexParser::parseUnicodeRegex(restr, false);
+    BOOST_REQUIRE(pr.first.has_value() && pr.second.empty());
+
+    std::map<std::string, const brex::RegexOpt*> namemap;
+    std::map<std::string, const brex::LiteralOpt*> envmap;
+    std::vector<brex::RegexCompileError> compileerror;
+    brex::CRegexExecutor* cexecutor = isc ? brex::RegexCompiler::compileCRegexToExecutor(pr.first.value(), namemap, envmap, false, nullptr, nullptr, compileerror) : nullptr;
+    brex::UnicodeRegexExecutor* uexecutor = !isc ? brex::RegexCompiler::compileUnicodeRegexToExecutor(pr.first.value(), namemap, envmap, false, nullptr, nullptr, compileerror) : nullptr;
+    BOOST_REQUIRE(compileerror.empty());
+
+    std::vector<std::string> strs = { "", "abc-09", "c-123", "a-1234", "ab\xC3\xA9", "ab9", "bcb0a" };
+    for(uint32_t seed = 0; seed < 2000; ++seed) {
+        strs.push_back(generateCTRegexTestString(seed % 8, seed));
+    }
+
+    size_t accepted = 0;
+    for(auto iter = strs.cbegin(); iter != strs.cend(); ++iter) {
+        std::string str = *iter;
+
+        brex::ExecutorError err;
+        bool expected = false;
+        if(isc) {
+            expected = cexecutor->test(&str, err);
+        }
+        else {
+            std::u8string ustr(str.cbegin(), str.cend());
+            expected = uexecutor->test(&ustr, err);
+        }
+
+        if(brex::ct_regex<RE>::test(str) != expected) {
+            std::cout << "Mismatch on " << std::string(restr.cbegin(), restr.cend()) << " with \"" << str << "\"" << std::endl;
+        }
+        BOOST_CHECK(brex::ct_regex<RE>::test(str) == expected);
+
+        accepted += expected ? 1 : 0;
+    }
+
+    BOOST_CHECK(accepted != 0);
+}
+
+std::string getCTRegexDiagnostic(const std::string& re) {
+    auto info = brex::ct::analyzeRegex(re);
+    return info.ok ? "" : std::string(info.diagnostic.message());
+}
+
+std::string getParserDiagnostic(const std::string& re) {
+    auto ure = std::u8string(re.cbegin(), re.cend());
+    auto pr = ure.ends_with(u8"/c") ? brex::RegexParser::parseCRegex(ure, false) : brex::RegexParser::parseUnicodeRegex(ure, false);
+    return pr.second.empty() ? "" : std::string(pr.second.front().msg.cbegin(), pr.second.front().msg.cend());
+}
+
+BOOST_AUTO_TEST_SUITE(CTRegex)
+
+BOOST_AUTO_TEST_CASE(simple) {
+    BOOST_CHECK(brex::ct_regex<"/[0-9]{5}/c">::test("98052"));
+    BOOST_CHECK(!brex::ct_regex<"/[0-9]{5}/c">::test("980521"));
+    BOOST_CHECK(brex::ct_regex<u8"/\"é\"+ [a-c]*/">::test(u8"ééab"));
+    BOOST_CHECK(!brex::ct_regex<u8"/\"é\"+ [a-c]*/">::test(u8"eab"));
+    BOOST_CHECK(brex::ct_regex<"/[^a-z]/">::test("\xF0\x9F\x8C\xB5"));
+}
+
+BOOST_AUTO_TEST_CASE(executor) {
+    checkCTRegexAgainstExecutor<"/[a-c]+ \"-\" [0-9]{2,3}/">();
+    checkCTRegexAgainstExecutor<"/(\"ab\" | [0-9])* \"é\"?/">();
+    checkCTRegexAgainstExecutor<"/[^a-c] . [^0-9]?/">();
+    checkCTRegexAgainstExecutor<"/[a-c0-9]{2,} & !(\"a\" .*)/">();
+    checkCTRegexAgainstExecutor<"/^'ab' & [a-c0-9 ]*/c">();
+    checkCTRegexAgainstExecutor<"/[a-c0-9]* & ('0' [a-c]{1,3})$/c">();
+    checkCTRegexAgainstExecutor<"/{2,5} & !('5' | '-')$/c">();
+}
+
+BOOST_AUTO_TEST_CASE(diagnostics) {
+    const std::vector<std::string> invalid = { "/[06a/", "/\"abc/", "/'%x7F;'/c", "/\"%bob;\"/", "/[a]{0,0}/", "/\"a\"{3,2}/", "/\"a\" && \"b\"/", "/^\"a\"$/", "/\"a\"/c", "/(\"a\"/", "/env['X']/" };
+    for(size_t i = 0; i < invalid.size(); ++i) {
+        BOOST_CHECK(!getParserDiagnostic(invalid[i]).empty());
+        BOOST_CHECK(getCTRegexDiagnostic(invalid[i]) == getParserDiagnostic(invalid[i]));
+    }
+
+    BOOST_CHECK(getCTRegexDiagnostic("/${Main::Digit}+/").starts_with("Named regexes are not supported"));
+    BOOST_CHECK(getCTRegexDiagnostic("/\"a\"^<\"b\">/").starts_with("Pre/post anchored regexes are not supported"));
+    BOOST_CHECK(getCTRegexDiagnostic("/[a-c]{5000}/").starts_with("Regex is too large for ct_regex"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,1451 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <new>
+
+#include "../../src/regex/brex.h"
+#include "../../src/regex/brex_parser.h"
+#include "../../src/regex/brex_compiler.h"
+
+std::optional<brex::UnicodeRegexExecutor*> tryParseForUnicodeEngineTest(const std::u8string& str) {
+    auto pr = brex::RegexParser::parseUnicodeRegex(str, false);
+    if(!pr.first.has_value() || !pr.second.empty()) {
+        return std::nullopt;
+    }
+
+    std::map<std::string, const brex::RegexOpt*> namemap;
+    std::map<std::string, const brex::LiteralOpt*> envmap;
+    std::vector<brex::RegexCompileError> compileerror;
+    auto executor = brex::RegexCompiler::compileUnicodeRegexToExecutor(pr.first.value(), namemap, envmap, false, nullptr, nullptr, compileerror);
+    if(!compileerror.empty()) {
+        return std::nullopt;
+    }
+
+    return std::make_optional(executor);
+}
+
+std::optional<brex::UnicodeByteRegexExecutor*> tryParseForUnicodeByteEngineTest(const std::u8string& str) {
+    auto pr = brex::RegexParser::parseUnicodeRegex(str, false);
+    if(!pr.first.has_value() || !pr.second.empty()) {
+        return std::nullopt;
+    }
+
+    std::map<std::string, const brex::RegexOpt*> namemap;
+    std::map<std::string, const brex::LiteralOpt*> envmap;
+    std::vector<brex::RegexCompileError> compileerror;
+    auto executor = brex::RegexCompiler::compileUnicodeRegexToByteExecutor(pr.first.value(), namemap, envmap, false, nullptr, nullptr, compileerror);
+    if(!compileerror.empty()) {
+        return std::nullopt;
+    }
+
+    return std::make_optional(executor);
+}
+
+std::optional<brex::CRegexExecutor*> tryParseForCEngineTest(const std::string& str, const brex::RegexCompilerOptions& options = brex::RegexCompilerOptions()) {
+    auto pr = brex::RegexParser::parseCRegex(std::u8string(str.cbegin(), str.cend()), false);
+    if(!pr.first.has_value() || !pr.second.empty()) {
+        return std::nullopt;
+    }
+
+    std::map<std::string, const brex::RegexOpt*> namemap;
+    std::map<std::string, const brex::LiteralOpt*> envmap;
+    std::vector<brex::RegexCompileError> compileerror;
+    auto executor = brex::RegexCompiler::compileCRegexToExecutor(pr.first.value(), namemap, envmap, false, nullptr, nullptr, compileerror, options);
+    if(!compileerror.empty()) {
+        return std::nullopt;
+    }
+
+    return std::make_optional(executor);
+}
+
+brex::RegexCompilerOptions noDFAEngineTestOptions() {
+    brex::RegexCompilerOptions options;
+    options.buildDFA = false;
+    options.maxGlushkovPositions = 0;
+
+    return options;
+}
+
+brex::RegexCompilerOptions noUnrollEngineTestOptions() {
+    brex::RegexCompilerOptions options;
+    options.maxUnrollStates = 0;
+
+    return options;
+}
+
+const brex::DFAMachine* getForwardDFAForEngineTest(brex::CRegexExecutor* executor) {
+    return static_cast<brex::SingleCheckREInfo<brex::CString, brex::CRegexIterator>*>(executor->re)->executor.getForwardDFA();
+}
+
+const brex::GlushkovMachine* getForwardGlushkovForEngineTest(brex::CRegexExecutor* executor) {
+    return static_cast<brex::SingleCheckREInfo<brex::CString, brex::CRegexIterator>*>(executor->re)->executor.getForwardGlushkov();
+}
+
+const brex::LiteralPrefilter* getForwardPrefilterForEngineTest(brex::CRegexExecutor* executor) {
+    return static_cast<brex::SingleCheckREInfo<brex::CString, brex::CRegexIterator>*>(executor->re)->executor.getForwardPrefilter();
+}
+
+const brex::LiteralFactorFilter* getFactorFilterForEngineTest(brex::CRegexExecutor* executor) {
+    return static_cast<brex::SingleCheckREInfo<brex::CString, brex::CRegexIterator>*>(executor->re)->executor.getFactorFilter();
+}
+
+std::pair<std::string, bool> requiredLiteralForEngineTest(const std::string& str) {
+    auto pr = brex::RegexParser::parseCRegex(std::u8string(str.cbegin(), str.cend()), false);
+    auto lit = brex::RegexLiteralFactors::requiredLiteral(static_cast<const brex::RegexSingleComponent*>(pr.first.value()->re)->entry.opt);
+
+    return std::make_pair(std::string(lit.first.cbegin(), lit.first.cend()), lit.second);
+}
+
+const brex::RegexOpt* parseOptForEngineTest(const std::string& str) {
+    auto pr = brex::RegexParser::parseCRegex(std::u8string(str.cbegin(), str.cend()), false);
+    return static_cast<const brex::RegexSingleComponent*>(pr.first.value()->re)->entry.opt;
+}
+
+std::string simplifyForEngineTest(const std::string& str) {
+    auto sopt = brex::RegexSimplifier::simplify(parseOptForEngineTest(str));
+    auto bsqon = sopt->toBSQONFormat();
+
+    return std::string(bsqon.cbegin(), bsqon.cend());
+}
+
+brex::RegexCompilerOptions noSimplifyEngineTestOptions() {
+    brex::RegexCompilerOptions options;
+    options.simplify = false;
+
+    return options;
+}
+
+//every heap allocation in the test binary goes through here so the engine tests can check that stepping does not allocate
+static size_t engineTestAllocCount = 0;
+
+void* operator new(std::size_t size) {
+    engineTestAllocCount++;
+
+    void* mem = std::malloc(size != 0 ? size : 1);
+    if(mem == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return mem;
+}
+
+void operator delete(void* mem) noexcept {
+    std::free(mem);
+}
+
+void operator delete(void* mem, std::size_t size) noexcept {
+    std::free(mem);
+}
+
+std::string generateEngineTestString(size_t length, uint32_t seed) {
+    std::string str;
+    for(size_t i = 0; i < length; ++i) {
+        seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF;
+        str.push_back((seed >> 16) % 2 == 0 ? 'a' : 'b');
+    }
+
+    return str;
+}
+
+#define ENGINE_TEST_UNICODE(EXECUTOR, STR, ACCEPT) {auto uustr = brex::UnicodeString(STR); brex::ExecutorError err; auto accepts = (EXECUTOR)->test(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(accepts == (ACCEPT)); }
+#define ENGINE_TEST_C(EXECUTOR, STR, ACCEPT) {auto uustr = brex::CString(STR); brex::ExecutorError err; auto accepts = (EXECUTOR)->test(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(accepts == (ACCEPT)); }
+
+//the match positions (START/END == -1 if there is no match), all the matches of the contains search, and the positions or bitmaps from the component checks
+#define ENGINE_CONTAINS_TEST_C(EXECUTOR, STR, ACCEPT) {auto uustr = brex::CString(STR); brex::ExecutorError err; auto accepts = (EXECUTOR)->testContains(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(accepts == (ACCEPT)); }
+#define ENGINE_FRONT_TEST_C(EXECUTOR, STR, END) {auto uustr = brex::CString(STR); brex::ExecutorError err; auto mm = (EXECUTOR)->matchFront(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(mm.has_value() ? (mm.value() == (END)) : ((END) == -1)); }
+#define ENGINE_BACK_TEST_C(EXECUTOR, STR, START) {auto uustr = brex::CString(STR); brex::ExecutorError err; auto mm = (EXECUTOR)->matchBack(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(mm.has_value() ? (mm.value() == (START)) : ((START) == -1)); }
+#define ENGINE_FIRST_TEST_C(EXECUTOR, STR, START, END) {auto uustr = brex::CString(STR); brex::ExecutorError err; auto mm = (EXECUTOR)->matchContainsFirst(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(mm.has_value() ? (mm.value().first == (START) && mm.value().second == (END)) : ((START) == -1)); }
+#define ENGINE_LAST_TEST_C(EXECUTOR, STR, START, END) {auto uustr = brex::CString(STR); brex::ExecutorError err; auto mm = (EXECUTOR)->matchContainsLast(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(mm.has_value() ? (mm.value().first == (START) && mm.value().second == (END)) : ((START) == -1)); }
+#define ENGINE_MATCHES_TEST_C(EXECUTOR, STR, MATCHES) {auto uustr = brex::CString(STR); auto matches = std::vector<std::pair<int64_t, int64_t>> MATCHES; BOOST_CHECK((EXECUTOR)->re->matchContains(&uustr, 0, (int64_t)uustr.size() - 1) == matches); }
+#define ENGINE_LOCKSTEP_TEST_C(EXECUTOR, STR, FENDS, BSTARTS) {auto uustr = brex::CString(STR); const int64_t epos = (int64_t)uustr.size() - 1; auto fends = std::vector<int64_t> FENDS; auto bstarts = std::vector<int64_t> BSTARTS; BOOST_CHECK((EXECUTOR)->re->matchFront(&uustr, 0, epos) == fends); BOOST_CHECK((EXECUTOR)->re->matchBack(&uustr, 0, epos) == bstarts); BOOST_CHECK((EXECUTOR)->re->testFront(&uustr, 0, epos) == !fends.empty()); BOOST_CHECK((EXECUTOR)->re->testBack(&uustr, 0, epos) == !bstarts.empty()); }
+#define ENGINE_BITS_TEST_C(EXECUTOR, STR, FBITS, RBITS, BACKBITS, FRONTBITS) {auto uustr = brex::CString(STR); const int64_t epos = (int64_t)uustr.size() - 1; std::vector<bool> bits; (EXECUTOR)->re->testBits(&uustr, 0, epos, true, bits); BOOST_CHECK(bits == std::vector<bool> FBITS); (EXECUTOR)->re->testBits(&uustr, 0, epos, false, bits); BOOST_CHECK(bits == std::vector<bool> RBITS); (EXECUTOR)->re->testBackBits(&uustr, 0, epos, bits); BOOST_CHECK(bits == std::vector<bool> BACKBITS); (EXECUTOR)->re->testFrontBits(&uustr, 0, epos, bits); BOOST_CHECK(bits == std::vector<bool> FRONTBITS); }
+
+BOOST_AUTO_TEST_SUITE(Engine)
+
+////
+//LazyDFA
+BOOST_AUTO_TEST_SUITE(LazyDFA)
+BOOST_AUTO_TEST_CASE(repetitive) {
+    auto texecutor = tryParseForCEngineTest("/[a-z]+ '@' [a-z]+ '.' ('com' | 'org')/c", noDFAEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    ENGINE_TEST_C(executor, std::string(100000, 'a') + "@bbb.com", true);
+    ENGINE_TEST_C(executor, std::string(100000, 'a') + "@bbb.cmo", false);
+    ENGINE_TEST_C(executor, std::string(100000, 'a') + "@" + std::string(100000, 'b') + ".org", true);
+}
+
+BOOST_AUTO_TEST_CASE(matchFront) {
+    auto texecutor = tryParseForCEngineTest("/[0-9]+/c", noDFAEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+
+    brex::ExecutorError err;
+    auto executor = texecutor.value();
+    auto cstr = std::string(50000, '7') + "x" + std::string(50000, '7');
+    auto rr = executor->matchFront(&cstr, err);
+
+    BOOST_CHECK(rr.has_value() && rr.value() == 49999);
+}
+
+BOOST_AUTO_TEST_CASE(thrash) {
+    //2^13 DFA states so the cache overflows its budget, thrashes, and falls back to NFA simulation
+    auto texecutor = tryParseForCEngineTest("/[ab]* 'a' [ab][ab][ab][ab][ab][ab][ab][ab][ab][ab][ab][ab]/c", noDFAEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    for(uint32_t seed = 1; seed < 5; ++seed) {
+        auto cstr = generateEngineTestString(20000, seed);
+        ENGINE_TEST_C(executor, cstr, cstr[cstr.size() - 13] == 'a');
+    }
+}
+
+BOOST_AUTO_TEST_CASE(counters) {
+    //not counter free (when the range is not unrolled) so always runs on the NFA
+    auto texecutor = tryParseForCEngineTest("/[ab]* 'a' [ab]{12}/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    for(uint32_t seed = 1; seed < 3; ++seed) {
+        auto cstr = generateEngineTestString(2000, seed);
+        ENGINE_TEST_C(executor, cstr, cstr[cstr.size() - 13] == 'a');
+    }
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//UTF8Bytes
+BOOST_AUTO_TEST_SUITE(UTF8Bytes)
+BOOST_AUTO_TEST_CASE(literal) {
+    auto texecutor = tryParseForUnicodeByteEngineTest(u8"/\"aä€😀\"/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    ENGINE_TEST_UNICODE(executor, u8"aä€😀", true);
+    ENGINE_TEST_UNICODE(executor, u8"aä€", false);
+    ENGINE_TEST_UNICODE(executor, u8"aa€😀", false);
+}
+
+BOOST_AUTO_TEST_CASE(ranges) {
+    auto texecutor = tryParseForUnicodeByteEngineTest(u8"/[a-zà-ÿ]+ [^a]/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    ENGINE_TEST_UNICODE(executor, u8"abçdé€", true);
+    ENGINE_TEST_UNICODE(executor, u8"abçdéb", true);
+    ENGINE_TEST_UNICODE(executor, u8"abçdé😀", true);
+    ENGINE_TEST_UNICODE(executor, u8"abçdéa", false);
+    ENGINE_TEST_UNICODE(executor, u8"abçdé€€", false);
+    ENGINE_TEST_UNICODE(executor, u8"ab€dé€", false);
+}
+
+BOOST_AUTO_TEST_CASE(dot) {
+    auto texecutor = tryParseForUnicodeByteEngineTest(u8"/\"x\" . . \"x\"/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    ENGINE_TEST_UNICODE(executor, u8"xabx", true);
+    ENGINE_TEST_UNICODE(executor, u8"xß😀x", true);
+    ENGINE_TEST_UNICODE(executor, u8"x😀x", false);
+    ENGINE_TEST_UNICODE(executor, u8"x€€€x", false);
+}
+
+BOOST_AUTO_TEST_CASE(dotRepeat) {
+    auto texecutor = tryParseForUnicodeByteEngineTest(u8"/.{2}/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    ENGINE_TEST_UNICODE(executor, u8"ab", true);
+    ENGINE_TEST_UNICODE(executor, u8"ä😀", true);
+    ENGINE_TEST_UNICODE(executor, u8"ä", false);
+    ENGINE_TEST_UNICODE(executor, u8"abc", false);
+}
+
+BOOST_AUTO_TEST_CASE(boundaries) {
+    //the edges of each utf8 encoding length
+    auto texecutor = tryParseForUnicodeByteEngineTest(u8"/[%x7f;-%x80;%x7ff;-%x800;%xffff;-%x10000;]/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    ENGINE_TEST_UNICODE(executor, u8"\u007f", true);
+    ENGINE_TEST_UNICODE(executor, u8"\u0080", true);
+    ENGINE_TEST_UNICODE(executor, u8"\u07ff", true);
+    ENGINE_TEST_UNICODE(executor, u8"\u0800", true);
+    ENGINE_TEST_UNICODE(executor, u8"\uffff", true);
+    ENGINE_TEST_UNICODE(executor, u8"\U00010000", true);
+    ENGINE_TEST_UNICODE(executor, u8"\u0081", false);
+    ENGINE_TEST_UNICODE(executor, u8"\u0801", false);
+    ENGINE_TEST_UNICODE(executor, u8"\U00010001", false);
+}
+
+BOOST_AUTO_TEST_CASE(matchPositions) {
+    auto texecutor = tryParseForUnicodeByteEngineTest(u8"/\"ä\"+/");
+    BOOST_CHECK(texecutor.has_value());
+
+    brex::ExecutorError err;
+    auto executor = texecutor.value();
+    auto ustr = brex::UnicodeString(u8"ääb");
+
+    auto rr = executor->matchFront(&ustr, err);
+    BOOST_CHECK(rr.has_value() && rr.value() == 3);
+
+    auto cc = executor->matchContainsFirst(&ustr, err);
+    BOOST_CHECK(cc.has_value() && cc.value().first == 0 && cc.value().second == 3);
+}
+
+BOOST_AUTO_TEST_CASE(sharedDFA) {
+    //once lowered every transition is on a byte so the DFA never needs the slow class lookup
+    auto texecutor = tryParseForUnicodeByteEngineTest(u8"/[α-ω]+ \"€\"/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto dfa = static_cast<brex::SingleCheckREInfo<brex::UnicodeString, brex::UnicodeByteRegexIterator>*>(texecutor.value()->re)->executor.getForwardDFA();
+    BOOST_CHECK(dfa != nullptr && dfa->charclasses.classlows.back() < 256);
+
+    ENGINE_TEST_UNICODE(texecutor.value(), u8"αβγ€", true);
+    ENGINE_TEST_UNICODE(texecutor.value(), u8"αβγa€", false);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//EpsilonClosure
+BOOST_AUTO_TEST_SUITE(EpsilonClosure)
+BOOST_AUTO_TEST_CASE(star) {
+    std::vector<brex::NFAOpt*> opts = { new brex::NFAOptAccept(0), new brex::NFAOptCharCode(1, 'a', 3), new brex::NFAOptCharCode(2, 'b', 0), new brex::NFAOptStar(3, 1, 2) };
+    brex::NFAMachine m(3, 0, opts);
+
+    BOOST_CHECK(m.epsilonclosures[0].has_value() && m.epsilonclosures[0].value() == std::vector<brex::StateID>({ 0 }));
+    BOOST_CHECK(m.epsilonclosures[3].has_value() && m.epsilonclosures[3].value() == std::vector<brex::StateID>({ 1, 2 }));
+}
+
+BOOST_AUTO_TEST_CASE(counter) {
+    std::vector<brex::NFAOpt*> opts = { new brex::NFAOptAccept(0), new brex::NFAOptCharCode(1, 'a', 2), new brex::NFAOptRangeK(2, 0, 2, 1, 0), new brex::NFAOptAnyOf(3, { 2, 0 }) };
+    brex::NFAMachine m(3, 0, opts);
+
+    BOOST_CHECK(m.epsilonclosures[1].has_value());
+    BOOST_CHECK(!m.epsilonclosures[2].has_value());
+    BOOST_CHECK(!m.epsilonclosures[3].has_value());
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//CharClasses
+BOOST_AUTO_TEST_SUITE(CharClasses)
+BOOST_AUTO_TEST_CASE(partition) {
+    std::vector<brex::NFAOpt*> opts = { new brex::NFAOptAccept(0), new brex::NFAOptRange(1, false, { {'a', 'c'}, {0x3b1, 0x3c9} }, 0), new brex::NFAOptCharCode(2, 'x', 1), new brex::NFAOptRange(3, true, { {'b', 'b'} }, 2) };
+    brex::NFAMachine m(3, 0, opts);
+
+    BOOST_CHECK(m.charclasses.classlows == std::vector<brex::RegexChar>({ 0, 'a', 'b', 'c', 'd', 'x', 'y', 0x3b1, 0x3ca }));
+    BOOST_CHECK(m.charclasses.classOf('a') == 1 && m.charclasses.classOf('c') == 3 && m.charclasses.classOf('q') == 4);
+    BOOST_CHECK(m.charclasses.classOf(0x3b5) == 7 && m.charclasses.classOf(0x10000) == 8);
+}
+
+BOOST_AUTO_TEST_CASE(charset) {
+    brex::NFACharSet cs({ {0x4e00, 0x4fff}, {'0', '9'}, {0x5000, 0x5010}, {0xc0, 0x3000} });
+
+    BOOST_CHECK(cs.intervals.size() == 2);
+    BOOST_CHECK(cs.contains('5') && !cs.contains('a'));
+    BOOST_CHECK(cs.contains(0xc0) && cs.contains(0x100) && cs.contains(0x3000) && !cs.contains(0x3001));
+    BOOST_CHECK(cs.contains(0x4e00) && cs.contains(0x5010) && !cs.contains(0x5011));
+}
+
+BOOST_AUTO_TEST_CASE(manyIntervals) {
+    //lots of small intervals across the BMP and above so we hit the page table, the scan, and the wide search
+    std::vector<brex::SingleCharRange> ranges;
+    for(brex::RegexChar c = 0x100; c < 0x20000; c += 97) {
+        ranges.push_back({ c, c + 13 });
+    }
+
+    std::vector<brex::NFAOpt*> opts = { new brex::NFAOptAccept(0), new brex::NFAOptRange(1, true, ranges, 0) };
+    brex::NFAMachine m(1, 0, opts);
+    
+    const brex::NFAOptRange* range = static_cast<const brex::NFAOptRange*>(opts[1]);
+    for(brex::RegexChar c = 0; c < 0x20100; c += 13) {
+        auto iter = std::upper_bound(m.charclasses.classlows.cbegin(), m.charclasses.classlows.cend(), c);
+        BOOST_CHECK_EQUAL(m.charclasses.classOf(c), (uint32_t)((iter - m.charclasses.classlows.cbegin()) - 1));
+
+        auto inrng = std::any_of(ranges.cbegin(), ranges.cend(), [c](const brex::SingleCharRange& rr) { return rr.low <= c && c <= rr.high; });
+        BOOST_CHECK(range->matches(c) == !inrng);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(unicodeTable) {
+    auto texecutor = tryParseForUnicodeEngineTest(u8"/[α-ω]+ \"!\"/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    auto dfa = static_cast<brex::SingleCheckREInfo<brex::UnicodeString, brex::UnicodeRegexIterator>*>(executor->re)->executor.getForwardDFA();
+    BOOST_CHECK(dfa != nullptr && dfa->nclasses == 5);
+
+    ENGINE_TEST_UNICODE(executor, u8"αβγ!", true);
+    ENGINE_TEST_UNICODE(executor, u8"αβγπ", false);
+    ENGINE_TEST_UNICODE(executor, u8"αβaγ!", false);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//DFA
+BOOST_AUTO_TEST_SUITE(DFA)
+BOOST_AUTO_TEST_CASE(minimized) {
+    //not simplified so 'a' and 'b' stay separate chars (and classes)
+    auto texecutor = tryParseForCEngineTest("/('a' | 'b')* 'c'/c", noSimplifyEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+
+    auto dfa = getForwardDFAForEngineTest(texecutor.value());
+    BOOST_CHECK(dfa != nullptr && dfa->stateCount() == 3);
+    BOOST_CHECK(dfa != nullptr && dfa->nclasses == 5);
+
+    //simplified the alternation is one range so there is one fewer class
+    auto sexecutor = tryParseForCEngineTest("/('a' | 'b')* 'c'/c");
+    BOOST_CHECK(sexecutor.has_value());
+
+    auto sdfa = getForwardDFAForEngineTest(sexecutor.value());
+    BOOST_CHECK(sdfa != nullptr && sdfa->stateCount() == 3);
+    BOOST_CHECK(sdfa != nullptr && sdfa->nclasses == 4);
+}
+
+BOOST_AUTO_TEST_CASE(minimizedAlternatives) {
+    //the two branches only differ in the first char so they collapse together
+    auto texecutor = tryParseForCEngineTest("/'xabc' | 'yabc'/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto dfa = getForwardDFAForEngineTest(texecutor.value());
+    BOOST_CHECK(dfa != nullptr && dfa->stateCount() == 6);
+}
+
+BOOST_AUTO_TEST_CASE(tooLarge) {
+    //2^13 states so we skip the full DFA and use the lazy cache
+    auto texecutor = tryParseForCEngineTest("/[ab]* 'a' [ab][ab][ab][ab][ab][ab][ab][ab][ab][ab][ab][ab]/c");
+    BOOST_CHECK(texecutor.has_value());
+    BOOST_CHECK(getForwardDFAForEngineTest(texecutor.value()) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(sameAsNFA) {
+    //each regex with the full DFA and with the NFA simulation on the same inputs
+    auto dexecutor = tryParseForCEngineTest("/[a-z]+ '@' [a-z]+ '.' ('com' | 'org')/c");
+    auto nexecutor = tryParseForCEngineTest("/[a-z]+ '@' [a-z]+ '.' ('com' | 'org')/c", noDFAEngineTestOptions());
+    BOOST_CHECK(dexecutor.has_value() && nexecutor.has_value());
+    BOOST_CHECK(getForwardDFAForEngineTest(dexecutor.value()) != nullptr && getForwardDFAForEngineTest(nexecutor.value()) == nullptr);
+
+    for(auto executor : { dexecutor.value(), nexecutor.value() }) {
+        ENGINE_TEST_C(executor, "bob@mail.com", true);
+        ENGINE_TEST_C(executor, "bob@mail.net", false);
+        ENGINE_TEST_C(executor, "@mail.org", false);
+        ENGINE_FRONT_TEST_C(executor, "ab@cd.orgx", 8);
+        ENGINE_FIRST_TEST_C(executor, "x ab@cd.com y", 2, 10);
+    }
+
+    dexecutor = tryParseForCEngineTest("/[ab]* 'a' [ab][ab][ab]/c");
+    nexecutor = tryParseForCEngineTest("/[ab]* 'a' [ab][ab][ab]/c", noDFAEngineTestOptions());
+    BOOST_CHECK(dexecutor.has_value() && nexecutor.has_value());
+
+    for(auto executor : { dexecutor.value(), nexecutor.value() }) {
+        ENGINE_TEST_C(executor, "baaab", true);
+        ENGINE_TEST_C(executor, "abbb", true);
+        ENGINE_TEST_C(executor, "abaab", false);
+        ENGINE_FRONT_TEST_C(executor, "aabbb", 4);
+        ENGINE_FIRST_TEST_C(executor, "bbabbbb", 0, 5);
+    }
+
+    dexecutor = tryParseForCEngineTest("/'ab'* | 'ba'+/c");
+    nexecutor = tryParseForCEngineTest("/'ab'* | 'ba'+/c", noDFAEngineTestOptions());
+    BOOST_CHECK(dexecutor.has_value() && nexecutor.has_value());
+
+    for(auto executor : { dexecutor.value(), nexecutor.value() }) {
+        ENGINE_TEST_C(executor, "", true);
+        ENGINE_TEST_C(executor, "abab", true);
+        ENGINE_TEST_C(executor, "baba", true);
+        ENGINE_TEST_C(executor, "aba", false);
+        ENGINE_FRONT_TEST_C(executor, "ababa", 3);
+        ENGINE_FRONT_TEST_C(executor, "babab", 3);
+    }
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//Counters
+BOOST_AUTO_TEST_SUITE(Counters)
+BOOST_AUTO_TEST_CASE(countSet) {
+    auto bounded = brex::NFACountSet::singleton(130, 1);
+    bounded.insert(64);
+    bounded.insert(130);
+
+    brex::NFACountSet binc;
+    bounded.increment(130, false, binc);
+    BOOST_CHECK(binc.contains(2) && binc.contains(65) && !binc.contains(130) && !binc.contains(131));
+    BOOST_CHECK(binc.hasAtLeast(65) && !binc.hasAtLeast(66));
+
+    auto unbounded = brex::NFACountSet::singleton(3, 3);
+    unbounded.insert(2);
+
+    brex::NFACountSet uinc;
+    unbounded.increment(3, true, uinc);
+    BOOST_CHECK(uinc.contains(3) && !uinc.contains(2) && !uinc.contains(4));
+}
+
+BOOST_AUTO_TEST_CASE(compactTokens) {
+    //("a" | "aa"){1,1000} -- after n chars every iteration count from n/2 to n is live but they share one token per state
+    std::vector<brex::NFAOpt*> opts = { new brex::NFAOptAccept(0), new brex::NFAOptCharCode(1, 'a', 3), new brex::NFAOptCharCode(2, 'a', 4), new brex::NFAOptRangeK(3, 1, 1000, 5, 0), new brex::NFAOptCharCode(4, 'a', 3), new brex::NFAOptAnyOf(5, { 1, 2 }) };
+    brex::NFAMachine m(3, 0, opts);
+
+    brex::NFAStepScratch scratch;
+    m.intitializeMachine(scratch);
+    for(size_t i = 0; i < 300; ++i) {
+        m.stepMachine('a', scratch);
+        BOOST_CHECK(scratch.getCurrentState().stateSize() <= opts.size());
+    }
+
+    const brex::NFAState& cstates = scratch.getCurrentState();
+    BOOST_CHECK(m.inAccepted(cstates));
+    BOOST_CHECK(cstates.countedstates.size() == 3);
+
+    auto counts = cstates.countedstates.get(1, {});
+    BOOST_CHECK(counts != nullptr && counts->contains(151) && counts->contains(301) && !counts->contains(150) && !counts->contains(302));
+}
+
+BOOST_AUTO_TEST_CASE(nested) {
+    auto texecutor = tryParseForCEngineTest("/('a'{2} 'b'){3}/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    ENGINE_TEST_C(executor, "aabaabaab", true);
+    ENGINE_TEST_C(executor, "aabaab", false);
+    ENGINE_TEST_C(executor, "aabaabaabaab", false);
+    ENGINE_TEST_C(executor, "aabaababaab", false);
+}
+
+BOOST_AUTO_TEST_CASE(nestedUnbounded) {
+    auto texecutor = tryParseForCEngineTest("/(('ab'){1,2} 'c'){2,}/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    ENGINE_TEST_C(executor, "abcababc", true);
+    ENGINE_TEST_C(executor, "abcabcabababc", false);
+    ENGINE_TEST_C(executor, "abcabcababcabc", true);
+    ENGINE_TEST_C(executor, "abc", false);
+    ENGINE_TEST_C(executor, "cabc", false);
+}
+
+BOOST_AUTO_TEST_CASE(counted) {
+    //the counter machines without unrolling
+    auto texecutor = tryParseForCEngineTest("/[ab]{2,4}/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    ENGINE_TEST_C(executor, "a", false);
+    ENGINE_TEST_C(executor, "ab", true);
+    ENGINE_TEST_C(executor, "abab", true);
+    ENGINE_TEST_C(executor, "ababa", false);
+    ENGINE_FRONT_TEST_C(executor, "ababab", 3);
+    ENGINE_FIRST_TEST_C(executor, "ccabc", 2, 3);
+
+    texecutor = tryParseForCEngineTest("/('a' | 'ab'){3}/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+
+    executor = texecutor.value();
+    ENGINE_TEST_C(executor, "aaa", true);
+    ENGINE_TEST_C(executor, "abaab", true);
+    ENGINE_TEST_C(executor, "ababab", true);
+    ENGINE_TEST_C(executor, "aa", false);
+    ENGINE_TEST_C(executor, "abababa", false);
+
+    texecutor = tryParseForCEngineTest("/('a'{1,2} 'b'){2}/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+
+    executor = texecutor.value();
+    ENGINE_TEST_C(executor, "abab", true);
+    ENGINE_TEST_C(executor, "aabaab", true);
+    ENGINE_TEST_C(executor, "aaabab", false);
+    ENGINE_TEST_C(executor, "ab", false);
+
+    texecutor = tryParseForCEngineTest("/(('a' 'b'?){2,} 'b'){1,2}/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+
+    executor = texecutor.value();
+    ENGINE_TEST_C(executor, "aab", true);
+    ENGINE_TEST_C(executor, "abab", true);
+    ENGINE_TEST_C(executor, "aabaab", true);
+    ENGINE_TEST_C(executor, "ab", false);
+    ENGINE_TEST_C(executor, "abb", false);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//Unroll
+BOOST_AUTO_TEST_SUITE(Unroll)
+BOOST_AUTO_TEST_CASE(stateCost) {
+    auto pr = brex::RegexParser::parseCRegex(u8"/[0-9]{2,4}/c", false);
+    BOOST_CHECK(pr.first.has_value());
+
+    auto sc = static_cast<const brex::RegexSingleComponent*>(pr.first.value()->re);
+    auto unrolled = brex::RegexRangeUnrolling::unroll(sc->entry.opt, 64);
+    BOOST_CHECK(unrolled->tag == brex::RegexOptTag::Sequence);
+    BOOST_CHECK(brex::RegexRangeUnrolling::stateCost(unrolled) == 6);
+
+    auto kept = brex::RegexRangeUnrolling::unroll(sc->entry.opt, 5);
+    BOOST_CHECK(kept->tag == brex::RegexOptTag::RangeRepeat);
+}
+
+BOOST_AUTO_TEST_CASE(smallRangesUseDFA) {
+    auto texecutor = tryParseForCEngineTest("/[0-9]{5} ('-' [0-9]{4})?/c");
+    BOOST_CHECK(texecutor.has_value());
+    BOOST_CHECK(getForwardDFAForEngineTest(texecutor.value()) != nullptr);
+
+    auto cexecutor = tryParseForCEngineTest("/[0-9]{5} ('-' [0-9]{4})?/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(cexecutor.has_value());
+    BOOST_CHECK(getForwardDFAForEngineTest(cexecutor.value()) == nullptr);
+
+    auto executor = texecutor.value();
+    ENGINE_TEST_C(executor, "12345", true);
+    ENGINE_TEST_C(executor, "12345-6789", true);
+    ENGINE_TEST_C(executor, "1234", false);
+    ENGINE_TEST_C(executor, "12345-678", false);
+}
+
+BOOST_AUTO_TEST_CASE(largeRangesKeepCounters) {
+    auto texecutor = tryParseForCEngineTest("/[0-9]{1,1000}/c");
+    BOOST_CHECK(texecutor.has_value());
+    BOOST_CHECK(getForwardDFAForEngineTest(texecutor.value()) == nullptr);
+
+    auto executor = texecutor.value();
+    ENGINE_TEST_C(executor, std::string(1000, '7'), true);
+    ENGINE_TEST_C(executor, std::string(1001, '7'), false);
+}
+
+BOOST_AUTO_TEST_CASE(sameAsCounters) {
+    //each regex unrolled into a DFA and kept as a counter machine on the same inputs
+    auto uexecutor = tryParseForCEngineTest("/('a' | 'ab'){3,}/c");
+    auto cexecutor = tryParseForCEngineTest("/('a' | 'ab'){3,}/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(uexecutor.has_value() && cexecutor.has_value());
+    BOOST_CHECK(getForwardDFAForEngineTest(uexecutor.value()) != nullptr);
+
+    for(auto executor : { uexecutor.value(), cexecutor.value() }) {
+        ENGINE_TEST_C(executor, "aaa", true);
+        ENGINE_TEST_C(executor, "aaab", true);
+        ENGINE_TEST_C(executor, "abaab", true);
+        ENGINE_TEST_C(executor, "aab", false);
+        ENGINE_FRONT_TEST_C(executor, "aabab", 4);
+    }
+
+    uexecutor = tryParseForCEngineTest("/'a'{0,3} 'b'+/c");
+    cexecutor = tryParseForCEngineTest("/'a'{0,3} 'b'+/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(uexecutor.has_value() && cexecutor.has_value());
+    BOOST_CHECK(getForwardDFAForEngineTest(uexecutor.value()) != nullptr);
+
+    for(auto executor : { uexecutor.value(), cexecutor.value() }) {
+        ENGINE_TEST_C(executor, "b", true);
+        ENGINE_TEST_C(executor, "aaabb", true);
+        ENGINE_TEST_C(executor, "aaaab", false);
+        ENGINE_TEST_C(executor, "aa", false);
+        ENGINE_FRONT_TEST_C(executor, "aabbba", 4);
+        ENGINE_FIRST_TEST_C(executor, "aaaabba", 1, 5);
+    }
+
+    uexecutor = tryParseForCEngineTest("/('b'? 'a'{0,2}){2,3}/c");
+    cexecutor = tryParseForCEngineTest("/('b'? 'a'{0,2}){2,3}/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(uexecutor.has_value() && cexecutor.has_value());
+
+    for(auto executor : { uexecutor.value(), cexecutor.value() }) {
+        ENGINE_TEST_C(executor, "", true);
+        ENGINE_TEST_C(executor, "babab", true);
+        ENGINE_TEST_C(executor, "aaaaaa", true);
+        ENGINE_TEST_C(executor, "aaaaaaa", false);
+        ENGINE_TEST_C(executor, "bbbb", false);
+    }
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//Glushkov
+BOOST_AUTO_TEST_SUITE(Glushkov)
+BOOST_AUTO_TEST_CASE(positions) {
+    //"ab"* -- the positions are accept, 'a', and 'b'
+    std::vector<brex::NFAOpt*> opts = { new brex::NFAOptAccept(0), new brex::NFAOptCharCode(1, 'b', 3), new brex::NFAOptCharCode(2, 'a', 1), new brex::NFAOptStar(3, 2, 0) };
+    brex::NFAMachine m(3, 0, opts);
+
+    auto gm = brex::GlushkovMachine::tryCompile(&m, 64);
+    BOOST_CHECK(gm != nullptr && gm->npositions == 3 && gm->nwords == 1);
+
+    brex::GlushkovStateSet active = gm->initial;
+    BOOST_CHECK(gm->isAccepting(active));
+
+    gm->step(active, 'a');
+    BOOST_CHECK(!gm->isAccepting(active) && !gm->isDead(active));
+    gm->step(active, 'b');
+    BOOST_CHECK(gm->isAccepting(active));
+    gm->step(active, 'b');
+    BOOST_CHECK(gm->isDead(active));
+
+    BOOST_CHECK(brex::GlushkovMachine::tryCompile(&m, 2) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(usedWithoutDFA) {
+    //2^13 DFA states so there is no full DFA but only a few positions
+    auto texecutor = tryParseForCEngineTest("/[ab]* 'a' [ab]{12}/c");
+    BOOST_CHECK(texecutor.has_value());
+    BOOST_CHECK(getForwardDFAForEngineTest(texecutor.value()) == nullptr);
+    BOOST_CHECK(getForwardGlushkovForEngineTest(texecutor.value()) != nullptr);
+
+    auto executor = texecutor.value();
+    for(uint32_t seed = 1; seed < 5; ++seed) {
+        auto cstr = generateEngineTestString(20000, seed);
+        ENGINE_TEST_C(executor, cstr, cstr[cstr.size() - 13] == 'a');
+    }
+}
+
+BOOST_AUTO_TEST_CASE(multiWord) {
+    //more than 64 positions so the active set spans several words
+    brex::RegexCompilerOptions gmoptions;
+    gmoptions.maxUnrollStates = 128;
+
+    auto texecutor = tryParseForCEngineTest("/[ab]* 'a' [ab]{80} 'b'/c", gmoptions);
+    BOOST_CHECK(texecutor.has_value());
+
+    auto gm = getForwardGlushkovForEngineTest(texecutor.value());
+    BOOST_CHECK(gm != nullptr && gm->nwords == 2);
+
+    auto executor = texecutor.value();
+    for(uint32_t seed = 1; seed < 5; ++seed) {
+        auto cstr = generateEngineTestString(2000, seed) + "b";
+        ENGINE_TEST_C(executor, cstr, cstr[cstr.size() - 82] == 'a');
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sameAsNFA) {
+    //each regex on the bit-parallel machine and with the NFA simulation on the same inputs
+    brex::RegexCompilerOptions gmoptions;
+    gmoptions.buildDFA = false;
+
+    auto gexecutor = tryParseForCEngineTest("/('a' | 'b')* 'c'/c", gmoptions);
+    auto nexecutor = tryParseForCEngineTest("/('a' | 'b')* 'c'/c", noDFAEngineTestOptions());
+    BOOST_CHECK(gexecutor.has_value() && nexecutor.has_value());
+    BOOST_CHECK(getForwardGlushkovForEngineTest(gexecutor.value()) != nullptr && getForwardGlushkovForEngineTest(nexecutor.value()) == nullptr);
+
+    for(auto executor : { gexecutor.value(), nexecutor.value() }) {
+        ENGINE_TEST_C(executor, "ababc", true);
+        ENGINE_TEST_C(executor, "c", true);
+        ENGINE_TEST_C(executor, "abab", false);
+        ENGINE_FRONT_TEST_C(executor, "abcab", 2);
+        ENGINE_BACK_TEST_C(executor, "abcabc", 3);
+    }
+
+    gexecutor = tryParseForCEngineTest("/[ab]* 'a' [ab][ab][ab]/c", gmoptions);
+    nexecutor = tryParseForCEngineTest("/[ab]* 'a' [ab][ab][ab]/c", noDFAEngineTestOptions());
+    BOOST_CHECK(gexecutor.has_value() && nexecutor.has_value());
+    BOOST_CHECK(getForwardGlushkovForEngineTest(gexecutor.value()) != nullptr);
+
+    for(auto executor : { gexecutor.value(), nexecutor.value() }) {
+        ENGINE_TEST_C(executor, "abbb", true);
+        ENGINE_TEST_C(executor, "baaab", true);
+        ENGINE_TEST_C(executor, "bbbb", false);
+        ENGINE_FRONT_TEST_C(executor, "abbbb", 3);
+        ENGINE_BACK_TEST_C(executor, "babbb", 0);
+    }
+
+    gexecutor = tryParseForCEngineTest("/'ab'* | 'ba'+/c", gmoptions);
+    nexecutor = tryParseForCEngineTest("/'ab'* | 'ba'+/c", noDFAEngineTestOptions());
+    BOOST_CHECK(gexecutor.has_value() && nexecutor.has_value());
+
+    for(auto executor : { gexecutor.value(), nexecutor.value() }) {
+        ENGINE_TEST_C(executor, "", true);
+        ENGINE_TEST_C(executor, "baba", true);
+        ENGINE_TEST_C(executor, "abba", false);
+        ENGINE_FIRST_TEST_C(executor, "bbaba", 1, 4);
+    }
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//TwoPass
+BOOST_AUTO_TEST_SUITE(TwoPass)
+BOOST_AUTO_TEST_CASE(positions) {
+    auto texecutor = tryParseForCEngineTest("/'b' 'a'* | 'ab'/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto cstr = brex::CString("aabaab");
+    brex::ExecutorError err;
+    BOOST_CHECK(texecutor.value()->matchContainsFirst(&cstr, err) == std::make_optional(std::make_pair<int64_t, int64_t>(1, 2)));
+    BOOST_CHECK(texecutor.value()->matchContainsLast(&cstr, err) == std::make_optional(std::make_pair<int64_t, int64_t>(4, 5)));
+
+    auto nstr = brex::CString("aaaa");
+    BOOST_CHECK(!texecutor.value()->matchContainsFirst(&nstr, err).has_value());
+    BOOST_CHECK(!texecutor.value()->matchContainsLast(&nstr, err).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(multibyte) {
+    //the reverse passes step back over whole chars -- dec goes from any char to the first byte of the one before it
+    auto ustr = brex::UnicodeString(u8"a€🌵b");
+    brex::UnicodeRegexIterator iter(&ustr, 0, 8, 9);
+    iter.dec();
+    BOOST_CHECK(iter.curr == 8);
+    iter.dec();
+    BOOST_CHECK(iter.curr == 4);
+    iter.dec();
+    BOOST_CHECK(iter.curr == 1);
+    iter.dec();
+    BOOST_CHECK(iter.curr == 0);
+    iter.dec();
+    BOOST_CHECK(!iter.valid());
+
+    auto texecutor = tryParseForUnicodeEngineTest(u8"/\"€\" .?/");
+    BOOST_CHECK(texecutor.has_value());
+
+    brex::ExecutorError err;
+    auto mstr = brex::UnicodeString(u8"a€🌵b€");
+    BOOST_CHECK(texecutor.value()->matchContainsFirst(&mstr, err) == std::make_optional(std::make_pair<int64_t, int64_t>(1, 7)));
+    BOOST_CHECK(texecutor.value()->matchContainsLast(&mstr, err) == std::make_optional(std::make_pair<int64_t, int64_t>(9, 11)));
+}
+
+BOOST_AUTO_TEST_CASE(engines) {
+    //the two passes on the full DFA, NFA simulation, counter, and bit-parallel versions of the machines
+    auto texecutor = tryParseForCEngineTest("/'a' [ab]* 'b'/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_FIRST_TEST_C(texecutor.value(), "babba", 1, 3);
+    ENGINE_LAST_TEST_C(texecutor.value(), "babba", 1, 3);
+    ENGINE_LAST_TEST_C(texecutor.value(), "abab", 0, 3);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "bbba", -1, -1);
+
+    texecutor = tryParseForCEngineTest("/('ab' | 'b' 'a'*)+/c", noDFAEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_FIRST_TEST_C(texecutor.value(), "aabaa", 1, 2);
+    ENGINE_LAST_TEST_C(texecutor.value(), "aabaa", 2, 4);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "aaaa", -1, -1);
+
+    texecutor = tryParseForCEngineTest("/[ab]{2,4} 'b'/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_FIRST_TEST_C(texecutor.value(), "aaaab", 0, 4);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "aaaaab", 1, 5);
+    ENGINE_LAST_TEST_C(texecutor.value(), "aaaaab", 1, 5);
+
+    brex::RegexCompilerOptions gmoptions;
+    gmoptions.buildDFA = false;
+    texecutor = tryParseForCEngineTest("/'b'* 'a' [ab]{2}/c", gmoptions);
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_FIRST_TEST_C(texecutor.value(), "bbabb", 0, 4);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "aaaa", 0, 2);
+    ENGINE_LAST_TEST_C(texecutor.value(), "aaaa", 1, 3);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//Unanchored
+BOOST_AUTO_TEST_SUITE(Unanchored)
+BOOST_AUTO_TEST_CASE(linearNoMatch) {
+    //restarting at every offset would take ~n^2/2 steps here
+    auto texecutor = tryParseForCEngineTest("/'a'* 'b'/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto cstr = brex::CString(std::string(200000, 'a'));
+    brex::ExecutorError err;
+    BOOST_CHECK(!texecutor.value()->testContains(&cstr, err));
+    BOOST_CHECK(!texecutor.value()->matchContainsFirst(&cstr, err).has_value());
+
+    cstr.push_back('b');
+    BOOST_CHECK(texecutor.value()->testContains(&cstr, err));
+}
+
+BOOST_AUTO_TEST_CASE(emptyMatch) {
+    //a regex that accepts "" is contained in any non-empty string even though it has no non-empty match there
+    auto texecutor = tryParseForCEngineTest("/'bcc'*/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    brex::ExecutorError err;
+    auto cstr = brex::CString("cab");
+    BOOST_CHECK(texecutor.value()->testContains(&cstr, err));
+    BOOST_CHECK(!texecutor.value()->matchContainsFirst(&cstr, err).has_value());
+
+    auto estr = brex::CString("");
+    BOOST_CHECK(!texecutor.value()->testContains(&estr, err));
+
+    auto uexecutor = tryParseForUnicodeEngineTest(u8"/(\"a\"+)*/");
+    BOOST_CHECK(uexecutor.has_value());
+
+    auto ustr = brex::UnicodeString(u8"b€€€b");
+    BOOST_CHECK(uexecutor.value()->testContains(&ustr, err));
+}
+
+BOOST_AUTO_TEST_CASE(engines) {
+    //the unanchored pass on the full DFA, NFA simulation, counter, and bit-parallel versions of the machines
+    auto texecutor = tryParseForCEngineTest("/'ab'+/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "babba", true);
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "bbaa", false);
+    ENGINE_MATCHES_TEST_C(texecutor.value(), "abab", ({ {0, 1}, {0, 3}, {2, 3} }));
+
+    texecutor = tryParseForCEngineTest("/'b' 'a'* | 'ab'/c", noDFAEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "aab", true);
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "aaa", false);
+    ENGINE_MATCHES_TEST_C(texecutor.value(), "aab", ({ {1, 2}, {2, 2} }));
+
+    texecutor = tryParseForCEngineTest("/[ab]{2,3} 'a'/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "aab", false);
+    ENGINE_MATCHES_TEST_C(texecutor.value(), "abaa", ({ {0, 2}, {0, 3}, {1, 3} }));
+
+    brex::RegexCompilerOptions gmoptions;
+    gmoptions.buildDFA = false;
+    texecutor = tryParseForCEngineTest("/'a' [ab] 'b'/c", gmoptions);
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "aaa", false);
+    ENGINE_MATCHES_TEST_C(texecutor.value(), "babba", ({ {1, 3} }));
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//Prefilter
+BOOST_AUTO_TEST_SUITE(Prefilter)
+BOOST_AUTO_TEST_CASE(extraction) {
+    auto pexecutor = tryParseForCEngineTest("/'abc' [a-z]*/c");
+    BOOST_CHECK(pexecutor.has_value());
+    auto pfilter = getForwardPrefilterForEngineTest(pexecutor.value());
+    BOOST_CHECK(pfilter != nullptr && std::string(pfilter->prefix.cbegin(), pfilter->prefix.cend()) == "abc");
+
+    auto bexecutor = tryParseForCEngineTest("/[xy] 'a' | 'y'+/c");
+    BOOST_CHECK(bexecutor.has_value());
+    auto bfilter = getForwardPrefilterForEngineTest(bexecutor.value());
+    BOOST_CHECK(bfilter != nullptr && bfilter->prefix.empty() && bfilter->firstbytecount == 2 && bfilter->hasFirstByte('x') && bfilter->hasFirstByte('y'));
+
+    auto aexecutor = tryParseForCEngineTest("/. 'a'/c");
+    BOOST_CHECK(aexecutor.has_value());
+    BOOST_CHECK(getForwardPrefilterForEngineTest(aexecutor.value()) == nullptr);
+
+    //the unicode prefix is the utf8 bytes and a non-ascii range adds its lead bytes
+    std::vector<brex::NFAOpt*> opts = { new brex::NFAOptAccept(0), new brex::NFAOptCharCode(1, 'b', 0), new brex::NFAOptCharCode(2, 0xE9, 1) };
+    brex::NFAMachine m(2, 0, opts);
+    auto ufilter = brex::LiteralPrefilter::tryCompile(&m, true);
+    BOOST_CHECK(ufilter != nullptr && ufilter->prefix == std::vector<uint8_t>({ 0xC3, 0xA9, 'b' }));
+
+    std::vector<brex::NFAOpt*> ropts = { new brex::NFAOptAccept(0), new brex::NFAOptRange(1, false, { brex::SingleCharRange{ 'a', 0x800 } }, 0) };
+    brex::NFAMachine rm(1, 0, ropts);
+    auto rfilter = brex::LiteralPrefilter::tryCompile(&rm, true);
+    BOOST_CHECK(rfilter != nullptr && rfilter->hasFirstByte('z') && rfilter->hasFirstByte(0xC2) && rfilter->hasFirstByte(0xE0) && !rfilter->hasFirstByte(0xE1) && !rfilter->hasFirstByte(0x80));
+}
+
+BOOST_AUTO_TEST_CASE(skipsText) {
+    auto texecutor = tryParseForCEngineTest("/'ab' [ab]* 'c'/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto cstr = brex::CString(std::string(100000, 'b') + "abbc" + std::string(100000, 'a'));
+    brex::ExecutorError err;
+    BOOST_CHECK(texecutor.value()->testContains(&cstr, err));
+    BOOST_CHECK(texecutor.value()->matchContainsFirst(&cstr, err) == std::make_optional(std::make_pair<int64_t, int64_t>(100000, 100003)));
+    BOOST_CHECK(texecutor.value()->matchContainsLast(&cstr, err) == std::make_optional(std::make_pair<int64_t, int64_t>(100000, 100003)));
+}
+
+BOOST_AUTO_TEST_CASE(unicode) {
+    auto texecutor = tryParseForUnicodeEngineTest(u8"/\"é\" [a-c]+ | [ü-ÿ] \"x\"/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto ustr = brex::UnicodeString(u8"aébbüxéaé");
+    brex::ExecutorError err;
+    BOOST_CHECK(texecutor.value()->testContains(&ustr, err));
+    BOOST_CHECK(texecutor.value()->matchContainsFirst(&ustr, err) == std::make_optional(std::make_pair<int64_t, int64_t>(1, 4)));
+    BOOST_CHECK(texecutor.value()->matchContainsLast(&ustr, err) == std::make_optional(std::make_pair<int64_t, int64_t>(8, 10)));
+
+    auto nstr = brex::UnicodeString(u8"aüüébé");
+    BOOST_CHECK(texecutor.value()->testContains(&nstr, err));
+    auto mstr = brex::UnicodeString(u8"aüüéé");
+    BOOST_CHECK(!texecutor.value()->testContains(&mstr, err));
+}
+
+BOOST_AUTO_TEST_CASE(engines) {
+    //the skips on the full DFA, NFA simulation, and counter versions of the machines
+    auto texecutor = tryParseForCEngineTest("/'ab' 'a'*/c");
+    BOOST_CHECK(texecutor.has_value() && getForwardPrefilterForEngineTest(texecutor.value()) != nullptr);
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "bbbb", false);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "bbabaa", 2, 5);
+    ENGINE_LAST_TEST_C(texecutor.value(), "bbabaa", 2, 5);
+    ENGINE_MATCHES_TEST_C(texecutor.value(), "abab", ({ {0, 1}, {0, 2}, {2, 3} }));
+
+    texecutor = tryParseForCEngineTest("/'ba' | 'bb' 'a'/c", noDFAEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value() && getForwardPrefilterForEngineTest(texecutor.value()) != nullptr);
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "aabb", false);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "abbaa", 1, 3);
+    ENGINE_LAST_TEST_C(texecutor.value(), "abbaa", 1, 3);
+
+    texecutor = tryParseForCEngineTest("/'a' [ab]{1,3} 'b'/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value() && getForwardPrefilterForEngineTest(texecutor.value()) != nullptr);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "bbaabab", 2, 6);
+    ENGINE_LAST_TEST_C(texecutor.value(), "bbaabab", 2, 6);
+    ENGINE_LAST_TEST_C(texecutor.value(), "abbbbb", 0, 4);
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "bbbab", false);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//LiteralFactor
+BOOST_AUTO_TEST_SUITE(LiteralFactor)
+BOOST_AUTO_TEST_CASE(extraction) {
+    BOOST_CHECK(requiredLiteralForEngineTest("/[a-z0-9_]+ '.log'/c") == std::make_pair(std::string(".log"), true));
+    BOOST_CHECK(requiredLiteralForEngineTest("/[a-z]+ 'error:' [0-9]+/c") == std::make_pair(std::string("error:"), false));
+    BOOST_CHECK(requiredLiteralForEngineTest("/[a-z]* ('x.gz' | 'y.gz')/c") == std::make_pair(std::string(".gz"), true));
+    BOOST_CHECK(requiredLiteralForEngineTest("/[0-9]+ 'ab'{3}/c") == std::make_pair(std::string("ababab"), true));
+    BOOST_CHECK(requiredLiteralForEngineTest("/[a-z]+ 'q'?/c") == std::make_pair(std::string(""), false));
+    BOOST_CHECK(requiredLiteralForEngineTest("/'a' | [0-9]+/c") == std::make_pair(std::string(""), false));
+}
+
+BOOST_AUTO_TEST_CASE(skipsText) {
+    auto texecutor = tryParseForCEngineTest("/[a-z]+ '.log'/c");
+    BOOST_CHECK(texecutor.has_value());
+    BOOST_CHECK(getFactorFilterForEngineTest(texecutor.value()) != nullptr && getFactorFilterForEngineTest(texecutor.value())->issuffix);
+
+    //without the suffix the reverse machine would keep a match in flight over all the letters
+    auto cstr = brex::CString(std::string(100000, 'a') + " app.log " + std::string(100000, 'b'));
+    brex::ExecutorError err;
+    BOOST_CHECK(texecutor.value()->testContains(&cstr, err));
+    BOOST_CHECK(texecutor.value()->matchContainsFirst(&cstr, err) == std::make_optional(std::make_pair<int64_t, int64_t>(100001, 100007)));
+    BOOST_CHECK(texecutor.value()->matchContainsLast(&cstr, err) == std::make_optional(std::make_pair<int64_t, int64_t>(100001, 100007)));
+
+    auto nstr = brex::CString(std::string(200000, 'a') + ".lo");
+    BOOST_CHECK(!texecutor.value()->testContains(&nstr, err));
+    BOOST_CHECK(!texecutor.value()->matchContainsFirst(&nstr, err).has_value());
+    BOOST_CHECK(!texecutor.value()->matchContainsLast(&nstr, err).has_value());
+}
+
+BOOST_AUTO_TEST_CASE(engines) {
+    //the literal scans with the full DFA, NFA simulation, and counter versions of the machines
+    auto texecutor = tryParseForCEngineTest("/[ab]* 'ba'/c");
+    BOOST_CHECK(texecutor.has_value() && getFactorFilterForEngineTest(texecutor.value()) != nullptr);
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "aaab", false);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "aabab", 0, 3);
+    ENGINE_LAST_TEST_C(texecutor.value(), "aabab", 0, 3);
+
+    texecutor = tryParseForCEngineTest("/'b'+ 'aa' [ab]*/c", noDFAEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value() && getFactorFilterForEngineTest(texecutor.value()) != nullptr);
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "babab", false);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "abbaab", 1, 5);
+    ENGINE_LAST_TEST_C(texecutor.value(), "abbaab", 1, 5);
+
+    texecutor = tryParseForCEngineTest("/[ab]{1,3} 'ab'/c", noUnrollEngineTestOptions());
+    BOOST_CHECK(texecutor.has_value() && getFactorFilterForEngineTest(texecutor.value()) != nullptr);
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "ab", false);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "bbbbab", 1, 5);
+    ENGINE_LAST_TEST_C(texecutor.value(), "bbbbab", 1, 5);
+
+    texecutor = tryParseForCEngineTest("/('ab' | 'bb') 'a'*/c");
+    BOOST_CHECK(texecutor.has_value() && getFactorFilterForEngineTest(texecutor.value()) != nullptr);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "aabba", 1, 2);
+    ENGINE_LAST_TEST_C(texecutor.value(), "aabba", 2, 4);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//Complement
+BOOST_AUTO_TEST_SUITE(Complement)
+BOOST_AUTO_TEST_CASE(sinks) {
+    auto texecutor = tryParseForCEngineTest("/'ab' .*/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto dfa = getForwardDFAForEngineTest(texecutor.value());
+    BOOST_CHECK(dfa != nullptr && dfa->acceptallstate != -1 && dfa->deadstate != -1);
+
+    auto cdfa = brex::DFAMachine::complement(dfa);
+    BOOST_CHECK(cdfa->deadstate == dfa->acceptallstate && cdfa->acceptallstate == dfa->deadstate);
+    BOOST_CHECK(cdfa->isAccepting(cdfa->startstate) && !cdfa->isAccepting(dfa->acceptallstate));
+}
+
+BOOST_AUTO_TEST_CASE(negated) {
+    auto texecutor = tryParseForCEngineTest("/!('ab' .*)/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    brex::ExecutorError err;
+    auto astr = brex::CString("ab" + std::string(100000, 'c'));
+    BOOST_CHECK(!texecutor.value()->test(&astr, err));
+
+    auto bstr = brex::CString("b" + std::string(100000, 'a'));
+    BOOST_CHECK(texecutor.value()->test(&bstr, err));
+
+    auto estr = brex::CString("");
+    BOOST_CHECK(texecutor.value()->test(&estr, err));
+}
+
+BOOST_AUTO_TEST_CASE(sameAsPositive) {
+    //each negated regex on the complement DFA and on the positive NFA simulation
+    std::vector<std::pair<std::string, std::vector<std::pair<std::string, bool>>>> cases = {
+        { "/!('a' [ab]*)/c", { {"abb", false}, {"bab", true}, {"", true} } },
+        { "/!([ab]* 'bb')/c", { {"abb", false}, {"aba", true}, {"bb", false} } },
+        { "/!('ab' | 'ba')/c", { {"ab", false}, {"aba", true}, {"", true} } },
+        { "/[ab]* & !(.* 'aa' .*)/c", { {"abab", true}, {"abaab", false}, {"", true} } },
+        { "/!('b'{2,4})/c", { {"bb", false}, {"bbbb", false}, {"bbbbb", true}, {"b", true} } }
+    };
+
+    for(auto citer = cases.cbegin(); citer != cases.cend(); ++citer) {
+        auto texecutor = tryParseForCEngineTest(citer->first);
+        auto nexecutor = tryParseForCEngineTest(citer->first, noDFAEngineTestOptions());
+        BOOST_CHECK(texecutor.has_value() && nexecutor.has_value());
+
+        for(auto siter = citer->second.cbegin(); siter != citer->second.cend(); ++siter) {
+            ENGINE_TEST_C(texecutor.value(), siter->first, siter->second);
+            ENGINE_TEST_C(nexecutor.value(), siter->first, siter->second);
+        }
+    }
+
+    auto texecutor = tryParseForCEngineTest("/[ab]* & !(.* 'aa' .*)/c");
+    auto cstr = brex::CString("abaab");
+    BOOST_CHECK(texecutor.value()->re->matchFront(&cstr, 0, 4) == std::vector<int64_t>({ 0, 1, 2 }));
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//LockStep
+BOOST_AUTO_TEST_SUITE(LockStep)
+BOOST_AUTO_TEST_CASE(earlyExit) {
+    //the second part is dead after the first char so the run stops there
+    auto texecutor = tryParseForCEngineTest("/[ab]* & 'b' [ab]*/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto cstr = brex::CString("a" + std::string(100000, 'b'));
+    BOOST_CHECK(texecutor.value()->re->matchFront(&cstr, 0, (int64_t)cstr.size() - 1).empty());
+
+    auto bstr = brex::CString("ba");
+    BOOST_CHECK(texecutor.value()->re->matchFront(&bstr, 0, 1) == std::vector<int64_t>({ 0, 1 }));
+    BOOST_CHECK(texecutor.value()->re->matchBack(&bstr, 0, 1) == std::vector<int64_t>({ 0 }));
+}
+
+BOOST_AUTO_TEST_CASE(positions) {
+    //the ends (going forward) and starts (in reverse) where every part of the conjunction holds
+    auto texecutor = tryParseForCEngineTest("/[ab]* & ('a' | 'b')+ 'b'/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_LOCKSTEP_TEST_C(texecutor.value(), "abab", ({ 1, 3 }), ({ 2, 1, 0 }));
+
+    texecutor = tryParseForCEngineTest("/[ab]* & ^'ab'/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_LOCKSTEP_TEST_C(texecutor.value(), "abba", ({ 1, 2, 3 }), ({ 0 }));
+
+    texecutor = tryParseForCEngineTest("/[ab]* & 'aa'$/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_LOCKSTEP_TEST_C(texecutor.value(), "aabaa", ({ 1, 4 }), ({ 3, 2, 1, 0 }));
+
+    texecutor = tryParseForCEngineTest("/[ab]{2,5} & !^'ba' & !'b'$/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_LOCKSTEP_TEST_C(texecutor.value(), "abaab", ({ 2, 3 }), ({}));
+    ENGINE_LOCKSTEP_TEST_C(texecutor.value(), "baaab", ({}), ({}));
+
+    texecutor = tryParseForCEngineTest("/[ab]+ & ^('a'{2} | 'b') & ('ab')$/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_LOCKSTEP_TEST_C(texecutor.value(), "aabab", ({ 2, 4 }), ({ 2, 0 }));
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//AnchorBits
+BOOST_AUTO_TEST_SUITE(AnchorBits)
+BOOST_AUTO_TEST_CASE(checkBits) {
+    //fbits[p + 1] = test(0, p), rbits[p] = test(p, epos), backbits[p + 1] = testBack(0, p), and frontbits[p] = testFront(p, epos)
+    auto texecutor = tryParseForCEngineTest("/[ab]* 'b'/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_BITS_TEST_C(texecutor.value(), "abba", ({ false, false, true, true, false }), ({ false, false, false, false, false }), ({ false, false, true, true, false }), ({ true, true, true, false, false }));
+
+    texecutor = tryParseForCEngineTest("/!('a' [ab]*)/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_BITS_TEST_C(texecutor.value(), "aba", ({ true, false, false, false }), ({ false, true, false, true }), ({ true, false, false, false }), ({ false, true, false, true }));
+
+    //a conjunction with a front check has one merged run forward and a run per position in reverse
+    texecutor = tryParseForCEngineTest("/[ab]* & ^'ba'/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_BITS_TEST_C(texecutor.value(), "baab", ({ false, false, true, true, true }), ({ true, false, false, false, false }), ({ false, false, true, true, true }), ({ true, false, false, false, false }));
+
+    texecutor = tryParseForCEngineTest("/[ab]+ & ^'a' & !'b'$/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_BITS_TEST_C(texecutor.value(), "abab", ({ false, true, false, true, false }), ({ false, false, false, false, false }), ({ false, true, false, true, false }), ({ true, false, true, false, false }));
+}
+
+BOOST_AUTO_TEST_CASE(anchors) {
+    //a test checks the anchors on the whole range before/after the match and the contains searches on some range that ends/starts there
+    auto texecutor = tryParseForCEngineTest("/'a'^<'b'+>$'a'/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_TEST_C(texecutor.value(), "abba", true);
+    ENGINE_TEST_C(texecutor.value(), "abbab", false);
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "abbab", true);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "abbab", 1, 2);
+    ENGINE_LAST_TEST_C(texecutor.value(), "abbab", 1, 2);
+
+    texecutor = tryParseForCEngineTest("/<'ab'>$[ab]/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_TEST_C(texecutor.value(), "abab", false);
+    ENGINE_TEST_C(texecutor.value(), "abb", true);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "abab", 0, 1);
+    ENGINE_LAST_TEST_C(texecutor.value(), "abab", 0, 1);
+
+    texecutor = tryParseForCEngineTest("/[ab]*^<'b'>/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_TEST_C(texecutor.value(), "aab", true);
+    ENGINE_TEST_C(texecutor.value(), "aaa", false);
+    ENGINE_LAST_TEST_C(texecutor.value(), "abab", 3, 3);
+
+    texecutor = tryParseForCEngineTest("/!('b' [ab]*)^<[ab]>$'b'/c");
+    BOOST_CHECK(texecutor.has_value());
+    ENGINE_TEST_C(texecutor.value(), "abb", true);
+    ENGINE_TEST_C(texecutor.value(), "bab", false);
+    ENGINE_CONTAINS_TEST_C(texecutor.value(), "bab", false);
+    ENGINE_FIRST_TEST_C(texecutor.value(), "abb", 0, 0);
+    ENGINE_LAST_TEST_C(texecutor.value(), "abb", 1, 1);
+}
+
+BOOST_AUTO_TEST_CASE(multibyte) {
+    auto texecutor = tryParseForUnicodeEngineTest(u8"/[a€]* & ^\"€\"/");
+    BOOST_CHECK(texecutor.has_value());
+
+    //the back bits are one merged forward pass and the front bits fall back to a run per char (the front check floats in reverse)
+    auto re = texecutor.value()->re;
+    auto ustr = brex::UnicodeString(u8"a€a€");
+    std::vector<bool> backbits;
+    std::vector<bool> frontbits;
+    re->testBackBits(&ustr, 0, 7, backbits);
+    re->testFrontBits(&ustr, 0, 7, frontbits);
+
+    //only the char boundaries are set -- bits[p + 1] for the last byte p of each char going forward and bits[p] for the first byte in reverse
+    BOOST_CHECK(!backbits[0] && !backbits[1] && backbits[4] && backbits[5] && backbits[8]);
+    BOOST_CHECK(!frontbits[0] && frontbits[1] && !frontbits[4] && frontbits[5] && !frontbits[8]);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//MatchMode
+BOOST_AUTO_TEST_SUITE(MatchMode)
+BOOST_AUTO_TEST_CASE(earlyExit) {
+    auto texecutor = tryParseForCEngineTest("/'a' [ab]*/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    //the DFA accepts everything after the first char so the longest match is known there
+    brex::ExecutorError err;
+    auto cstr = brex::CString("a" + std::string(100000, 'b'));
+    BOOST_CHECK(texecutor.value()->matchFront(&cstr, err) == std::make_optional<int64_t>(100000));
+    BOOST_CHECK(texecutor.value()->matchFront(&cstr, err, brex::MatchMode::Shortest) == std::make_optional<int64_t>(0));
+
+    auto bstr = brex::CString(std::string(100000, 'b') + "a");
+    BOOST_CHECK(!texecutor.value()->matchFront(&bstr, err).has_value());
+    BOOST_CHECK(texecutor.value()->matchBack(&bstr, err, brex::MatchMode::Shortest) == std::make_optional<int64_t>(100000));
+}
+
+BOOST_AUTO_TEST_CASE(positions) {
+    auto texecutor = tryParseForCEngineTest("/'a'+/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    brex::ExecutorError err;
+    auto astr = brex::CString("aaab");
+    auto bstr = brex::CString("baaa");
+    BOOST_CHECK(texecutor.value()->matchFront(&astr, err) == std::make_optional<int64_t>(2));
+    BOOST_CHECK(texecutor.value()->matchFront(&astr, err, brex::MatchMode::Shortest) == std::make_optional<int64_t>(0));
+    BOOST_CHECK(texecutor.value()->matchBack(&bstr, err) == std::make_optional<int64_t>(1));
+    BOOST_CHECK(texecutor.value()->matchBack(&bstr, err, brex::MatchMode::Shortest) == std::make_optional<int64_t>(3));
+
+    texecutor = tryParseForCEngineTest("/('ab')+ | 'b'{2,3}/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto cstr = brex::CString("ababb");
+    auto dstr = brex::CString("bbbb");
+    BOOST_CHECK(texecutor.value()->matchFront(&cstr, err) == std::make_optional<int64_t>(3));
+    BOOST_CHECK(texecutor.value()->matchFront(&cstr, err, brex::MatchMode::Shortest) == std::make_optional<int64_t>(1));
+    BOOST_CHECK(texecutor.value()->matchFront(&dstr, err) == std::make_optional<int64_t>(2));
+    BOOST_CHECK(texecutor.value()->matchFront(&dstr, err, brex::MatchMode::Shortest) == std::make_optional<int64_t>(1));
+
+    //a conjunction uses the lock-step run
+    texecutor = tryParseForCEngineTest("/[ab]* & ^'ab'/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto estr = brex::CString("abba");
+    BOOST_CHECK(texecutor.value()->re->matchFrontEnd(&estr, 0, 3, brex::MatchMode::Longest) == std::make_optional<int64_t>(3));
+    BOOST_CHECK(texecutor.value()->re->matchFrontEnd(&estr, 0, 3, brex::MatchMode::Shortest) == std::make_optional<int64_t>(1));
+    BOOST_CHECK(texecutor.value()->re->matchBackStart(&estr, 0, 3, brex::MatchMode::Shortest) == std::make_optional<int64_t>(0));
+    BOOST_CHECK(!texecutor.value()->re->matchBackStart(&estr, 1, 3, brex::MatchMode::Longest).has_value());
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//Stream
+template <typename TMatcher, typename TStr>
+bool streamChunksForEngineTest(TMatcher* matcher, const TStr& str, size_t chunksize) {
+    matcher->reset();
+    for(size_t i = 0; i < str.size(); i += chunksize) {
+        auto chunk = str.substr(i, chunksize);
+        matcher->feed(&chunk);
+    }
+
+    return matcher->finish();
+}
+
+BOOST_AUTO_TEST_SUITE(Stream)
+BOOST_AUTO_TEST_CASE(earlyReject) {
+    auto texecutor = tryParseForCEngineTest("/'a' [ab]* 'b'/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    brex::ExecutorError err;
+    auto matcher = brex::CStreamMatcher::create(texecutor.value(), err);
+    BOOST_CHECK(matcher != nullptr && err == brex::ExecutorError::Ok);
+
+    auto achunk = brex::CString("ab");
+    auto bchunk = brex::CString("c");
+    BOOST_CHECK(matcher->feed(&achunk) && matcher->canStillMatch());
+    BOOST_CHECK(!matcher->feed(&bchunk) && !matcher->canStillMatch());
+    BOOST_CHECK(!matcher->feed(&achunk));
+    BOOST_CHECK(!matcher->finish());
+
+    matcher->reset();
+    BOOST_CHECK(matcher->feed(&achunk) && matcher->finish());
+}
+
+BOOST_AUTO_TEST_CASE(anchorsRejected) {
+    auto texecutor = tryParseForCEngineTest("/'a'^<'b'>/c");
+    BOOST_CHECK(texecutor.has_value());
+
+    brex::ExecutorError err;
+    BOOST_CHECK(brex::CStreamMatcher::create(texecutor.value(), err) == nullptr && err == brex::ExecutorError::InvalidRegexStructure);
+}
+
+BOOST_AUTO_TEST_CASE(splitChars) {
+    auto texecutor = tryParseForUnicodeEngineTest(u8"/[a-zà-ÿ]+ \"€\" \"😀\"?/");
+    auto bexecutor = tryParseForUnicodeByteEngineTest(u8"/[a-zà-ÿ]+ \"€\" \"😀\"?/");
+    BOOST_CHECK(texecutor.has_value() && bexecutor.has_value());
+
+    brex::ExecutorError err;
+    auto matcher = brex::UnicodeStreamMatcher::create(texecutor.value(), err);
+    auto bmatcher = brex::UnicodeByteStreamMatcher::create(bexecutor.value(), err);
+    BOOST_CHECK(matcher != nullptr && bmatcher != nullptr);
+
+    std::vector<brex::UnicodeString> strs = { u8"abçdé€", u8"é€😀", u8"é€😀😀", u8"€", u8"aa€ä" };
+    for(auto siter = strs.cbegin(); siter != strs.cend(); ++siter) {
+        auto sstr = *siter;
+        const bool expected = texecutor.value()->test(&sstr, err);
+        for(size_t chunksize = 1; chunksize <= 5; ++chunksize) {
+            BOOST_CHECK(streamChunksForEngineTest(matcher, sstr, chunksize) == expected);
+            BOOST_CHECK(streamChunksForEngineTest(bmatcher, sstr, chunksize) == expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(chunked) {
+    //the same result for any chunking of the input
+    std::vector<std::pair<std::string, std::vector<std::pair<std::string, bool>>>> cases = {
+        { "/[ab]* 'bb'/c", { {"abb", true}, {"abba", false} } },
+        { "/!('a' [ab]*)/c", { {"ab", false}, {"ba", true}, {"", true} } },
+        { "/[ab]* & ^'ab'/c", { {"abba", true}, {"ba", false} } },
+        { "/[ab]+ & !'b'$/c", { {"aba", true}, {"ab", false} } },
+        { "/[ab]{2,5} & !^'ba' & 'a'$/c", { {"aba", true}, {"baa", false}, {"abaaaa", false} } }
+    };
+
+    for(auto citer = cases.cbegin(); citer != cases.cend(); ++citer) {
+        auto texecutor = tryParseForCEngineTest(citer->first);
+        BOOST_CHECK(texecutor.has_value());
+
+        brex::ExecutorError err;
+        auto matcher = brex::CStreamMatcher::create(texecutor.value(), err);
+        BOOST_CHECK(matcher != nullptr);
+
+        for(auto siter = citer->second.cbegin(); siter != citer->second.cend(); ++siter) {
+            for(size_t chunksize = 1; chunksize <= 3; ++chunksize) {
+                BOOST_CHECK(streamChunksForEngineTest(matcher, siter->first, chunksize) == siter->second);
+            }
+        }
+    }
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//Simplify
+BOOST_AUTO_TEST_SUITE(Simplify)
+BOOST_AUTO_TEST_CASE(rewrites) {
+    BOOST_CHECK(simplifyForEngineTest("/'abc' | 'abd' | 'abx'/c") == "'ab'[c-dx]");
+    BOOST_CHECK(simplifyForEngineTest("/'xa' | 'yya' | 'za'/c") == "([xz]|'yy')'a'");
+    BOOST_CHECK(simplifyForEngineTest("/'a' | [b-c] | 'e' | 'd'/c") == "[a-e]");
+    BOOST_CHECK(simplifyForEngineTest("/'ab' | 'abc'/c") == "'ab''c'?");
+    BOOST_CHECK(simplifyForEngineTest("/('x'*)*/c") == "'x'*");
+    BOOST_CHECK(simplifyForEngineTest("/('x'?)+/c") == "'x'*");
+    BOOST_CHECK(simplifyForEngineTest("/('x'+)?/c") == "'x'*");
+    BOOST_CHECK(simplifyForEngineTest("/'a' ('b' 'c') 'd'/c") == "'abcd'");
+}
+
+BOOST_AUTO_TEST_CASE(fewerStates) {
+    std::vector<std::string> res = {
+        "/'abc' | 'abd' | 'abx'/c",
+        "/'get' | 'put' | 'post' | 'patch'/c",
+        "/('x'*)* 'y'/c"
+    };
+
+    for(auto riter = res.cbegin(); riter != res.cend(); ++riter) {
+        auto opt = parseOptForEngineTest(*riter);
+        BOOST_CHECK(brex::RegexRangeUnrolling::stateCost(brex::RegexSimplifier::simplify(opt)) < brex::RegexRangeUnrolling::stateCost(opt));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sameAsUnsimplified) {
+    //each regex with and without the rewrites on the same inputs
+    std::vector<std::pair<std::string, std::vector<std::pair<std::string, bool>>>> cases = {
+        { "/'ab' | 'abb' | 'ba' | 'b'/c", { {"ab", true}, {"abb", true}, {"ba", true}, {"b", true}, {"a", false}, {"bb", false} } },
+        { "/('a' | 'b')* 'ab' | 'bb' [ab]/c", { {"bab", true}, {"bba", true}, {"abb", false} } },
+        { "/('aab' | 'abb' | 'bab')+/c", { {"aababb", true}, {"aabab", false} } },
+        { "/'' | 'a'{2,3} | 'ab'/c", { {"", true}, {"aa", true}, {"aaa", true}, {"ab", true}, {"a", false}, {"aaaa", false} } }
+    };
+
+    for(auto citer = cases.cbegin(); citer != cases.cend(); ++citer) {
+        auto texecutor = tryParseForCEngineTest(citer->first);
+        auto nexecutor = tryParseForCEngineTest(citer->first, noSimplifyEngineTestOptions());
+        BOOST_CHECK(texecutor.has_value() && nexecutor.has_value());
+
+        for(auto siter = citer->second.cbegin(); siter != citer->second.cend(); ++siter) {
+            ENGINE_TEST_C(texecutor.value(), siter->first, siter->second);
+            ENGINE_TEST_C(nexecutor.value(), siter->first, siter->second);
+        }
+    }
+
+    auto texecutor = tryParseForCEngineTest("/'ab' | 'abb' | 'ba' | 'b'/c");
+    auto nexecutor = tryParseForCEngineTest("/'ab' | 'abb' | 'ba' | 'b'/c", noSimplifyEngineTestOptions());
+    ENGINE_MATCHES_TEST_C(texecutor.value(), "abba", ({ {0, 1}, {0, 2}, {1, 1}, {2, 2}, {2, 3} }));
+    ENGINE_MATCHES_TEST_C(nexecutor.value(), "abba", ({ {0, 1}, {0, 2}, {1, 1}, {2, 2}, {2, 3} }));
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//Program
+BOOST_AUTO_TEST_SUITE(Program)
+BOOST_AUTO_TEST_CASE(layout) {
+    //"a" | "bc" -- the alternative follows and closures are in the side arrays
+    std::vector<brex::NFAOpt*> opts = { new brex::NFAOptAccept(0), new brex::NFAOptCharCode(1, 'a', 0), new brex::NFAOptCharCode(2, 'c', 0), new brex::NFAOptCharCode(3, 'b', 2), new brex::NFAOptAnyOf(4, { 1, 3 }) };
+    brex::NFAMachine m(4, 0, opts);
+
+    BOOST_CHECK(sizeof(brex::NFAInstruction) <= 24);
+    BOOST_CHECK(m.program.instructions.size() == 5);
+
+    const brex::NFAInstruction& anyof = m.program.instructions[4];
+    BOOST_CHECK(anyof.tag == brex::NFAOptTag::AnyOf && anyof.altfollow == 2);
+    BOOST_CHECK(m.program.follows[anyof.follow] == 1 && m.program.follows[anyof.follow + 1] == 3);
+
+    BOOST_CHECK(anyof.closurecount == 2);
+    BOOST_CHECK(m.program.closures[anyof.closurestart] == 1 && m.program.closures[anyof.closurestart + 1] == 3);
+
+    BOOST_CHECK(m.program.instructions[3].concreteTransition() && m.program.instructions[3].follow == 2);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//Allocation
+BOOST_AUTO_TEST_SUITE(Allocation)
+BOOST_AUTO_TEST_CASE(noAllocAfterWarmup) {
+    //NFA simulation with counters (nested in the last one) and the lazy DFA
+    std::vector<std::pair<std::string, brex::RegexCompilerOptions>> res = {
+        { "/[ab]* 'a' [ab]{100}/c", noUnrollEngineTestOptions() },
+        { "/[ab]* ('a' [ab]{1,3}){5}/c", noUnrollEngineTestOptions() },
+        { "/[ab]* 'a' [ab]{12}/c", noDFAEngineTestOptions() }
+    };
+
+    for(auto riter = res.cbegin(); riter != res.cend(); ++riter) {
+        auto texecutor = tryParseForCEngineTest(riter->first, riter->second);
+        BOOST_CHECK(texecutor.has_value());
+
+        auto executor = texecutor.value();
+        for(uint32_t seed = 1; seed < 4; ++seed) {
+            auto cstr = brex::CString(generateEngineTestString(5000, seed));
+            brex::ExecutorError err;
+            const bool warm = executor->test(&cstr, err);
+
+            const size_t before = engineTestAllocCount;
+            const bool accepts = executor->test(&cstr, err);
+            const size_t after = engineTestAllocCount;
+
+            BOOST_CHECK(accepts == warm);
+            BOOST_CHECK_EQUAL(after - before, 0);
+        }
+    }
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
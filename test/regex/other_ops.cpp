@@ -21,6 +21,23 @@ std::optional<brex::UnicodeRegexExecutor*> tryParseForUnicodeOtherOp(const std::
     return std::make_optional(executor);
 }
 
+std::optional<brex::UnicodeByteRegexExecutor*> tryParseForUnicodeByteOtherOp(const std::u8string& str) {
+    auto pr = brex::RegexParser::parseUnicodeRegex(str, false);
+    if(!pr.first.has_value() || !pr.second.empty()) {
+        return std::nullopt;
+    }
+
+    std::map<std::string, const brex::RegexOpt*> namemap;
+    std::map<std::string, const brex::LiteralOpt*> envmap;
+    std::vector<brex::RegexCompileError> compileerror;
+    auto executor = brex::RegexCompiler::compileUnicodeRegexToByteExecutor(pr.first.value(), namemap, envmap, false, nullptr, nullptr, compileerror);
+    if(!compileerror.empty()) {
+        return std::nullopt;
+    }
+
+    return std::make_optional(executor);
+}
+
 BOOST_AUTO_TEST_SUITE(OtherOps)
 
 BOOST_AUTO_TEST_SUITE(StartsWith)
@@ -99,6 +116,21 @@ BOOST_AUTO_TEST_CASE(anchorno) {
 
     BOOST_CHECK(!rr.has_value());
 }
+BOOST_AUTO_TEST_CASE(multibyte) {
+    brex::ExecutorError err;
+    auto texecutor = tryParseForUnicodeOtherOp(u8"/[0-9]+\"€\"/");
+    auto tbexecutor = tryParseForUnicodeByteOtherOp(u8"/[0-9]+\"€\"/");
+
+    BOOST_CHECK(texecutor.has_value() && tbexecutor.has_value());
+
+    //the match ends on the last byte of the multibyte char for both executors
+    auto ustr = brex::UnicodeString(u8"12€a");
+    auto rr = texecutor.value()->matchFront(&ustr, err);
+    auto brr = tbexecutor.value()->matchFront(&ustr, err);
+
+    BOOST_CHECK(rr.has_value() && rr.value() == 4);
+    BOOST_CHECK(brr.has_value() && brr.value() == 4);
+}
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(EndsMatch)
@@ -129,6 +161,20 @@ BOOST_AUTO_TEST_CASE(repeata09) {
 
     BOOST_CHECK(rr.has_value() && rr.value().first == 3 && rr.value().second == 4);
 }
+BOOST_AUTO_TEST_CASE(multibyte) {
+    brex::ExecutorError err;
+    auto texecutor = tryParseForUnicodeOtherOp(u8"/\"a\"[€-🌵]/");
+    auto tbexecutor = tryParseForUnicodeByteOtherOp(u8"/\"a\"[€-🌵]/");
+
+    BOOST_CHECK(texecutor.has_value() && tbexecutor.has_value());
+
+    auto ustr = brex::UnicodeString(u8"€a€a🌵b");
+    auto rr = texecutor.value()->matchContainsLast(&ustr, err);
+    auto brr = tbexecutor.value()->matchContainsLast(&ustr, err);
+
+    BOOST_CHECK(rr.has_value() && rr.value().first == 7 && rr.value().second == 11);
+    BOOST_CHECK(brr.has_value() && brr.value().first == 7 && brr.value().second == 11);
+}
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
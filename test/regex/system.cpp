@@ -166,6 +166,124 @@ BOOST_AUTO_TEST_CASE(abcabc) {
 }
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE(Set)
+BOOST_AUTO_TEST_CASE(classify) {
+    brex::RENSInfo ninfo = {
+        {
+            "Main",
+            {}
+        },
+        {
+            {
+                "Digit",
+                u8"/[0-9]/c"
+            },
+            {
+                "Zip",
+                u8"/${Digit}{5}/c"
+            },
+            {
+                "Number",
+                u8"/${Digit}+/c"
+            },
+            {
+                "Word",
+                u8"/[a-z]+/c"
+            },
+            {
+                "NotZero",
+                u8"/${Digit}+ & !('0'+)/c"
+            },
+            {
+                "Greek",
+                u8"/[α-ω]+/"
+            }
+        }
+    };
+
+    std::vector<brex::RENSInfo> ninfos = { ninfo };
+    std::vector<std::u8string> errors;
+    auto sys = brex::ReSystem::processSystem(ninfos, errors);
+    BOOST_CHECK(errors.empty());
+
+    std::vector<std::string> names = { "Main::Zip", "Main::Number", "Main::Word", "Main::NotZero" };
+    brex::RegexCompilerOptions nfaoptions;
+    nfaoptions.buildDFA = false;
+
+    auto rset = sys.compileCStringRESet(names, errors);
+    auto nset = sys.compileCStringRESet(names, errors, nfaoptions);
+    BOOST_CHECK(errors.empty() && rset != nullptr && nset != nullptr);
+    //only the conjunction is tested on its own
+    BOOST_CHECK(rset->machine != nullptr && rset->machine->hasDFA() && rset->separate.size() == 1 && rset->separate[0].first == 3);
+    BOOST_CHECK(!nset->machine->hasDFA());
+
+    brex::ExecutorError err = brex::ExecutorError::Ok;
+    std::vector<std::string> strs = { "98052", "00000", "123", "abc", "", "12a" };
+    for(auto iter = strs.cbegin(); iter != strs.cend(); ++iter) {
+        brex::CString cstr = *iter;
+
+        std::vector<size_t> expected;
+        for(size_t i = 0; i < names.size(); ++i) {
+            if(sys.getCStringRE(names[i])->test(&cstr, err)) {
+                expected.push_back(i);
+            }
+        }
+
+        BOOST_CHECK(rset->matches(&cstr, err) == expected);
+        BOOST_CHECK(nset->matches(&cstr, err) == expected);
+    }
+
+    brex::CString zstr = "98052";
+    BOOST_CHECK(rset->matches(&zstr, err) == std::vector<size_t>({ 0, 1, 3 }));
+
+    auto uset = sys.compileUnicodeRESet({ "Main::Greek" }, errors);
+    brex::UnicodeString ustr = u8"αβγ";
+    BOOST_CHECK(uset != nullptr && uset->matches(&ustr, err) == std::vector<size_t>({ 0 }));
+
+    BOOST_CHECK(sys.compileCStringRESet({ "Main::Zip", "Main::Greek" }, errors) == nullptr);
+    BOOST_CHECK(errors.size() == 1);
+}
+BOOST_AUTO_TEST_CASE(negated) {
+    brex::RENSInfo ninfo = {
+        {
+            "Main",
+            {}
+        },
+        {
+            {
+                "Doc",
+                u8"/[a-z]+ ('.txt' | '.pdf')/c"
+            },
+            {
+                "NotDoc",
+                u8"/!([a-z]+ ('.txt' | '.pdf'))/c"
+            },
+            {
+                "Short",
+                u8"/[a-z.]{1,6}/c"
+            }
+        }
+    };
+
+    std::vector<brex::RENSInfo> ninfos = { ninfo };
+    std::vector<std::u8string> errors;
+    auto sys = brex::ReSystem::processSystem(ninfos, errors);
+
+    //the negated entry goes in the machine with the others
+    auto rset = sys.compileCStringRESet({ "Main::Doc", "Main::NotDoc", "Main::Short" }, errors);
+    BOOST_CHECK(errors.empty() && rset != nullptr && rset->separate.empty());
+    BOOST_CHECK(rset->machineregexes == std::vector<size_t>({ 0, 1, 2 }) && rset->machinenegated == std::vector<bool>({ false, true, false }));
+
+    brex::ExecutorError err = brex::ExecutorError::Ok;
+    brex::CString dstr = "a.txt";
+    brex::CString lstr = "report.txt";
+    brex::CString nstr = "a.doc";
+    BOOST_CHECK(rset->matches(&dstr, err) == std::vector<size_t>({ 0, 2 }));
+    BOOST_CHECK(rset->matches(&lstr, err) == std::vector<size_t>({ 0 }));
+    BOOST_CHECK(rset->matches(&nstr, err) == std::vector<size_t>({ 1, 2 }));
+}
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE(Cycle)
 BOOST_AUTO_TEST_CASE(abcabc) {
     brex::RENSInfo ninfo = {
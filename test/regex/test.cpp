@@ -42,6 +42,13 @@ std::optional<brex::CRegexExecutor*> tryParseForCTest(const std::string& str) {
 
 #define ACCEPTS_TEST_C(RE, STR, ACCEPT) {auto uustr = brex::CString(STR); brex::ExecutorError err; auto accepts = executor->test(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(accepts == ACCEPT); }
 
+//the match positions are byte offsets (START == -1 if there is no match)
+#define CONTAINS_TEST_UNICODE(RE, STR, ACCEPT) {auto uustr = brex::UnicodeString(STR); brex::ExecutorError err; auto accepts = executor->testContains(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(accepts == ACCEPT); }
+#define MATCH_FIRST_TEST_UNICODE(RE, STR, START, END) {auto uustr = brex::UnicodeString(STR); brex::ExecutorError err; auto mm = executor->matchContainsFirst(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(mm.has_value() ? (mm.value().first == START && mm.value().second == END) : (START == -1)); }
+#define MATCH_LAST_TEST_UNICODE(RE, STR, START, END) {auto uustr = brex::UnicodeString(STR); brex::ExecutorError err; auto mm = executor->matchContainsLast(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(mm.has_value() ? (mm.value().first == START && mm.value().second == END) : (START == -1)); }
+#define MATCH_FRONT_TEST_UNICODE(RE, STR, END) {auto uustr = brex::UnicodeString(STR); brex::ExecutorError err; auto mm = executor->matchFront(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(mm.has_value() ? (mm.value() == END) : (END == -1)); }
+#define MATCH_BACK_TEST_UNICODE(RE, STR, START) {auto uustr = brex::UnicodeString(STR); brex::ExecutorError err; auto mm = executor->matchBack(&uustr, err); BOOST_CHECK(err == brex::ExecutorError::Ok); BOOST_CHECK(mm.has_value() ? (mm.value() == START) : (START == -1)); }
+
 BOOST_AUTO_TEST_SUITE(Test)
 
 ////
@@ -718,6 +725,18 @@ BOOST_AUTO_TEST_CASE(both) {
     ACCEPTS_TEST_UNICODE(executor, u8"aa", false);
     ACCEPTS_TEST_UNICODE(executor, u8"1234", false);
 }
+BOOST_AUTO_TEST_CASE(alternatives) {
+    auto texecutor = tryParseForUnicodeTest(u8"/(\"a\" | \"bc\"){2}/");
+    BOOST_CHECK(texecutor.has_value());
+    
+    auto executor = texecutor.value();
+
+    ACCEPTS_TEST_UNICODE(executor, u8"aa", true);
+    ACCEPTS_TEST_UNICODE(executor, u8"abc", true);
+    ACCEPTS_TEST_UNICODE(executor, u8"bcbc", true);
+    ACCEPTS_TEST_UNICODE(executor, u8"a", false);
+    ACCEPTS_TEST_UNICODE(executor, u8"aaa", false);
+}
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -1002,4 +1021,139 @@ BOOST_AUTO_TEST_CASE(notbob) {
 }
 BOOST_AUTO_TEST_SUITE_END()
 
+////
+//Contains
+BOOST_AUTO_TEST_SUITE(Contains)
+BOOST_AUTO_TEST_CASE(multibyte) {
+    auto texecutor = tryParseForUnicodeTest(u8"/\"€\"+/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    CONTAINS_TEST_UNICODE(executor, u8"a€€b", true);
+    CONTAINS_TEST_UNICODE(executor, u8"🌵€", true);
+    CONTAINS_TEST_UNICODE(executor, u8"ab", false);
+    CONTAINS_TEST_UNICODE(executor, u8"", false);
+}
+BOOST_AUTO_TEST_CASE(multibyteempty) {
+    auto texecutor = tryParseForUnicodeTest(u8"/(\"a\"+)*/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    CONTAINS_TEST_UNICODE(executor, u8"b€€€b", true);
+    CONTAINS_TEST_UNICODE(executor, u8"€a", true);
+    CONTAINS_TEST_UNICODE(executor, u8"", false);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//ContainsFirst
+BOOST_AUTO_TEST_SUITE(ContainsFirst)
+BOOST_AUTO_TEST_CASE(multibyte) {
+    auto texecutor = tryParseForUnicodeTest(u8"/\"€\"/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    MATCH_FIRST_TEST_UNICODE(executor, u8"€", 0, 2);
+    MATCH_FIRST_TEST_UNICODE(executor, u8"a€b", 1, 3);
+    MATCH_FIRST_TEST_UNICODE(executor, u8"a€b€", 1, 3);
+    MATCH_FIRST_TEST_UNICODE(executor, u8"abc", -1, -1);
+}
+BOOST_AUTO_TEST_CASE(multibyterepeat) {
+    auto texecutor = tryParseForUnicodeTest(u8"/[é-€]+/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    MATCH_FIRST_TEST_UNICODE(executor, u8"a€éb", 1, 5);
+    MATCH_FIRST_TEST_UNICODE(executor, u8"🌵é", 4, 5);
+    MATCH_FIRST_TEST_UNICODE(executor, u8"🌵", -1, -1);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//ContainsLast
+BOOST_AUTO_TEST_SUITE(ContainsLast)
+BOOST_AUTO_TEST_CASE(multibyte) {
+    auto texecutor = tryParseForUnicodeTest(u8"/\"€\"/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    MATCH_LAST_TEST_UNICODE(executor, u8"€", 0, 2);
+    MATCH_LAST_TEST_UNICODE(executor, u8"a€b", 1, 3);
+    MATCH_LAST_TEST_UNICODE(executor, u8"a€b€", 5, 7);
+    MATCH_LAST_TEST_UNICODE(executor, u8"abc", -1, -1);
+}
+BOOST_AUTO_TEST_CASE(multibyteseq) {
+    auto texecutor = tryParseForUnicodeTest(u8"/\"a€\"/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    MATCH_LAST_TEST_UNICODE(executor, u8"ba€", 1, 4);
+    MATCH_LAST_TEST_UNICODE(executor, u8"a€a€b", 4, 7);
+}
+BOOST_AUTO_TEST_CASE(multibyterepeat) {
+    auto texecutor = tryParseForUnicodeTest(u8"/[é-€]*/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    MATCH_LAST_TEST_UNICODE(executor, u8"a€b", 1, 3);
+    MATCH_LAST_TEST_UNICODE(executor, u8"€éb€", 6, 8);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//PostAnchor
+BOOST_AUTO_TEST_SUITE(PostAnchor)
+BOOST_AUTO_TEST_CASE(multibyte) {
+    auto texecutor = tryParseForUnicodeTest(u8"/<.>$\"b\"/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    ACCEPTS_TEST_UNICODE(executor, u8"€b", true);
+    CONTAINS_TEST_UNICODE(executor, u8"a€b", true);
+    CONTAINS_TEST_UNICODE(executor, u8"a€c", false);
+    MATCH_FRONT_TEST_UNICODE(executor, u8"€b", 2);
+    MATCH_FRONT_TEST_UNICODE(executor, u8"a€b", -1);
+    MATCH_FIRST_TEST_UNICODE(executor, u8"a€b", 1, 3);
+}
+BOOST_AUTO_TEST_CASE(multibyteany) {
+    auto texecutor = tryParseForUnicodeTest(u8"/<. .*>$./");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    CONTAINS_TEST_UNICODE(executor, u8"€b", true);
+    MATCH_FRONT_TEST_UNICODE(executor, u8"a€b🌵b", 8);
+    MATCH_FRONT_TEST_UNICODE(executor, u8"€🌵", 2);
+    MATCH_FRONT_TEST_UNICODE(executor, u8"🌵", -1);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+////
+//PreAnchor
+BOOST_AUTO_TEST_SUITE(PreAnchor)
+BOOST_AUTO_TEST_CASE(multibyte) {
+    auto texecutor = tryParseForUnicodeTest(u8"/\"€\"^<\"b\"+>/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    ACCEPTS_TEST_UNICODE(executor, u8"€bb", true);
+    ACCEPTS_TEST_UNICODE(executor, u8"abb", false);
+    CONTAINS_TEST_UNICODE(executor, u8"a€bb", true);
+    CONTAINS_TEST_UNICODE(executor, u8"abb€", false);
+    MATCH_BACK_TEST_UNICODE(executor, u8"€bb", 3);
+    MATCH_BACK_TEST_UNICODE(executor, u8"€ab", -1);
+    MATCH_FIRST_TEST_UNICODE(executor, u8"a€bb€b", 4, 5);
+    MATCH_LAST_TEST_UNICODE(executor, u8"a€bb€b", 9, 9);
+}
+BOOST_AUTO_TEST_CASE(multibyteinner) {
+    auto texecutor = tryParseForUnicodeTest(u8"/\"a\"^<[€-🌵]+>/");
+    BOOST_CHECK(texecutor.has_value());
+
+    auto executor = texecutor.value();
+    ACCEPTS_TEST_UNICODE(executor, u8"a€🌵", true);
+    MATCH_BACK_TEST_UNICODE(executor, u8"a€🌵", 1);
+    MATCH_FIRST_TEST_UNICODE(executor, u8"b€a🌵€b", 5, 11);
+    MATCH_LAST_TEST_UNICODE(executor, u8"a€ba🌵", 6, 9);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE_END()